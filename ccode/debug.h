@@ -9,9 +9,13 @@
 #ifndef __DEBUG__
 #define __DEBUG__
 
-#define debug(...) \
-	#ifdef DEBUG \
-	ssPrintf(__VA_ARGS__) \
-	#endif
+/* debug(format, ...) prints with ssPrintf when compiled with -DDEBUG and
+ * compiles to nothing otherwise. The plant's counters and timers are in
+ * testats.h. */
+#ifdef DEBUG
+#define debug(...) ssPrintf(__VA_ARGS__)
+#else
+#define debug(...) ((void) 0)
+#endif
 
 #endif /* __DEBUG__ */
\ No newline at end of file
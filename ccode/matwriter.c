@@ -0,0 +1,366 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Streaming MAT-file (level 5) writer, see matwriter.h.
+ *
+ * Layout of a double matrix element (all tags 8 bytes, data padded to 8):
+ *   miMATRIX tag, array flags (mxDOUBLE_CLASS), dimensions, name, real part
+ * A streamed variable reserves maxrows rows per column; its columns are
+ * written in place and moved together on mat_close() if fewer rows came.
+ */
+
+#if !defined(_WIN32)
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "matwriter.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#define mat_fseek _fseeki64
+#define mat_truncate(fp, n) (_chsize_s(_fileno(fp), (n)) == 0 ? 0 : -1)
+typedef __int64 mat_off;
+typedef unsigned __int32 mat_u32;
+typedef __int32 mat_i32;
+#else
+#include <stdint.h>
+#include <sys/types.h>
+#include <unistd.h>
+#define mat_fseek fseeko
+#define mat_truncate(fp, n) ftruncate(fileno(fp), (off_t) (n))
+typedef int64_t mat_off;
+typedef uint32_t mat_u32;
+typedef int32_t mat_i32;
+#endif
+
+#define MAT_HEADER_SIZE 128
+#define MAT_MAX_NAME    63
+#define MAT_MAX_BYTES   4294967295.
+
+/* Data types and classes */
+#define miINT8          1
+#define miINT32         5
+#define miUINT32        6
+#define miDOUBLE        9
+#define miMATRIX        14
+#define mxDOUBLE_CLASS  6
+
+#define MAT_MOVE_SIZE   65536
+
+struct MatVar {
+	MatFile *f;
+	char name[MAT_MAX_NAME + 1];
+	size_t ncols, maxrows, rows;
+	size_t brows, buffered;  /* rows per block, rows in buf */
+	double *buf;             /* [ncols][brows], NULL for mat_put */
+	mat_off start, data;     /* offsets of the element and its real part */
+	MatVar *next;
+};
+
+struct MatFile {
+	FILE *fp;
+	mat_off end;
+	MatVar *vars, *last;
+};
+
+const char *mat_strerror(int status)
+{
+	switch (status) {
+	case MAT_OK:     return "no error";
+	case MAT_EIO:    return "I/O error";
+	case MAT_ENOMEM: return "out of memory";
+	case MAT_EARG:   return "invalid argument";
+	case MAT_EFULL:  return "more rows than declared";
+	default:         return "unknown error";
+	}
+}
+
+static size_t pad8(size_t n)
+{
+	return (n + 7) & ~(size_t) 7;
+}
+
+/* Bytes of the name subelement; names of up to 4 characters use the small
+ * element format. */
+static size_t name_size(const char *name)
+{
+	size_t len = strlen(name);
+
+	return len <= 4 ? 8 : 8 + pad8(len);
+}
+
+/* Bytes of the element before the real part. */
+static size_t head_size(const char *name)
+{
+	return 8 + 16 + 16 + name_size(name) + 8;
+}
+
+static int put_tag(FILE *fp, mat_u32 type, mat_u32 bytes)
+{
+	mat_u32 tag[2];
+
+	tag[0] = type;
+	tag[1] = bytes;
+	return fwrite(tag, 4, 2, fp) == 2 ? MAT_OK : MAT_EIO;
+}
+
+/* Writes the element head of an m x n double matrix at the current
+ * position. */
+static int put_head(FILE *fp, const char *name, size_t m, size_t n)
+{
+	static const char zero[8] = {0};
+	size_t len = strlen(name), data = m * n * sizeof(double);
+	mat_u32 flags[2];
+	mat_i32 dims[2];
+	unsigned short small[2];
+
+	if (put_tag(fp, miMATRIX, (mat_u32) (head_size(name) - 8 + data)) != MAT_OK ||
+			put_tag(fp, miUINT32, 8) != MAT_OK)
+		return MAT_EIO;
+	flags[0] = mxDOUBLE_CLASS;
+	flags[1] = 0;
+	dims[0] = (mat_i32) m;
+	dims[1] = (mat_i32) n;
+	if (fwrite(flags, 4, 2, fp) != 2 || put_tag(fp, miINT32, 8) != MAT_OK ||
+			fwrite(dims, 4, 2, fp) != 2)
+		return MAT_EIO;
+	if (len <= 4) {
+		small[0] = miINT8;
+		small[1] = (unsigned short) len;
+		if (fwrite(small, 2, 2, fp) != 2 || fwrite(name, 1, len, fp) != len ||
+				fwrite(zero, 1, 4 - len, fp) != 4 - len)
+			return MAT_EIO;
+	} else if (put_tag(fp, miINT8, (mat_u32) len) != MAT_OK ||
+			fwrite(name, 1, len, fp) != len ||
+			fwrite(zero, 1, pad8(len) - len, fp) != pad8(len) - len)
+		return MAT_EIO;
+	return put_tag(fp, miDOUBLE, (mat_u32) data);
+}
+
+static int valid_name(const char *name)
+{
+	const char *p = name;
+
+	if (!((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')))
+		return 0;
+	for (p++; *p; p++)
+		if (!((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z') ||
+				(*p >= '0' && *p <= '9') || *p == '_'))
+			return 0;
+	return p - name <= MAT_MAX_NAME;
+}
+
+/* ============================================================================= */
+
+int mat_create(const char *path, MatFile **out)
+{
+	MatFile *f;
+	char h[MAT_HEADER_SIZE];
+	unsigned short version[2];
+	time_t now = time(NULL);
+	int n;
+
+	*out = NULL;
+	if (!(f = (MatFile *) calloc(1, sizeof(*f))))
+		return MAT_ENOMEM;
+	if (!(f->fp = fopen(path, "wb+"))) {
+		free(f);
+		return MAT_EIO;
+	}
+	memset(h, ' ', 116);
+	n = sprintf(h, "MATLAB 5.0 MAT-file, Platform: TE, Created on: %.24s", ctime(&now));
+	h[n] = ' ';
+	memset(h + 116, 0, 8);
+	version[0] = 0x0100;
+	version[1] = ('M' << 8) | 'I';   /* reads "IM" on little-endian hosts */
+	memcpy(h + 124, version, 4);
+	if (fwrite(h, 1, MAT_HEADER_SIZE, f->fp) != MAT_HEADER_SIZE) {
+		fclose(f->fp);
+		free(f);
+		return MAT_EIO;
+	}
+	f->end = MAT_HEADER_SIZE;
+	*out = f;
+	return MAT_OK;
+}
+
+static MatVar *add_var(MatFile *f, const char *name, size_t ncols, size_t maxrows)
+{
+	MatVar *v;
+
+	if (!(v = (MatVar *) calloc(1, sizeof(*v))))
+		return NULL;
+	v->f = f;
+	strcpy(v->name, name);
+	v->ncols = ncols;
+	v->maxrows = maxrows;
+	v->start = f->end;
+	v->data = f->end + (mat_off) head_size(name);
+	f->end = v->data + (mat_off) (ncols * maxrows * sizeof(double));
+	if (f->last)
+		f->last->next = v;
+	else
+		f->vars = v;
+	f->last = v;
+	return v;
+}
+
+static int check_size(const char *name, size_t m, size_t n)
+{
+	if (!valid_name(name) || m > 0x7fffffff || n > 0x7fffffff ||
+			(double) head_size(name) + 8. * m * n > MAT_MAX_BYTES)
+		return MAT_EARG;
+	return MAT_OK;
+}
+
+int mat_put(MatFile *f, const char *name, const double *a, size_t m, size_t n)
+{
+	MatVar *v;
+	int status;
+
+	if ((status = check_size(name, m, n)) != MAT_OK)
+		return status;
+	if (mat_fseek(f->fp, f->end, SEEK_SET) != 0)
+		return MAT_EIO;
+	if (!(v = add_var(f, name, n, m)))
+		return MAT_ENOMEM;
+	v->rows = m;
+	if ((status = put_head(f->fp, name, m, n)) != MAT_OK)
+		return status;
+	if (fwrite(a, sizeof(double), m * n, f->fp) != m * n)
+		return MAT_EIO;
+	return MAT_OK;
+}
+
+int mat_begin(MatFile *f, const char *name, size_t ncols, size_t maxrows,
+		MatVar **out)
+{
+	MatVar *v;
+	int status;
+
+	*out = NULL;
+	if ((status = check_size(name, maxrows, ncols)) != MAT_OK)
+		return status;
+	if (mat_fseek(f->fp, f->end, SEEK_SET) != 0 ||
+			put_head(f->fp, name, maxrows, ncols) != MAT_OK)
+		return MAT_EIO;
+	if (!(v = add_var(f, name, ncols, maxrows)))
+		return MAT_ENOMEM;
+	v->brows = maxrows < MAT_DEFAULT_BLOCK_ROWS ? maxrows : MAT_DEFAULT_BLOCK_ROWS;
+	if (v->brows > 0 && ncols > 0 &&
+			!(v->buf = (double *) malloc(ncols * v->brows * sizeof(double))))
+		return MAT_ENOMEM;
+	*out = v;
+	return MAT_OK;
+}
+
+/* Writes the buffered rows of every column to their final place. */
+static int mat_flush(MatVar *v)
+{
+	FILE *fp = v->f->fp;
+	size_t c, r0 = v->rows - v->buffered;
+
+	if (v->buffered == 0)
+		return MAT_OK;
+	for (c = 0; c < v->ncols; c++) {
+		if (mat_fseek(fp, v->data + (mat_off) ((c*v->maxrows + r0) * sizeof(double)),
+				SEEK_SET) != 0 ||
+				fwrite(&v->buf[c*v->brows], sizeof(double), v->buffered, fp) != v->buffered)
+			return MAT_EIO;
+	}
+	v->buffered = 0;
+	return MAT_OK;
+}
+
+int mat_append(MatVar *v, const double *row)
+{
+	size_t c;
+
+	if (v->rows == v->maxrows)
+		return MAT_EFULL;
+	for (c = 0; c < v->ncols; c++)
+		v->buf[c*v->brows + v->buffered] = row[c];
+	v->rows++;
+	if (++v->buffered == v->brows)
+		return mat_flush(v);
+	return MAT_OK;
+}
+
+/* Copies n bytes from src to dst < src. */
+static int move_down(FILE *fp, mat_off dst, mat_off src, mat_off n, char *tmp)
+{
+	size_t k;
+
+	while (n > 0) {
+		k = n < MAT_MOVE_SIZE ? (size_t) n : MAT_MOVE_SIZE;
+		if (mat_fseek(fp, src, SEEK_SET) != 0 || fread(tmp, 1, k, fp) != k ||
+				mat_fseek(fp, dst, SEEK_SET) != 0 || fwrite(tmp, 1, k, fp) != k)
+			return MAT_EIO;
+		src += k;
+		dst += k;
+		n -= k;
+	}
+	return MAT_OK;
+}
+
+int mat_close(MatFile *f)
+{
+	MatVar *v, *next;
+	mat_off dst = MAT_HEADER_SIZE, data;
+	char *tmp = NULL;
+	size_t c;
+	int status = MAT_OK;
+
+	if (!f)
+		return MAT_EARG;
+	for (v = f->vars; v && status == MAT_OK; v = v->next)
+		status = mat_flush(v);
+	/* Variables only move towards the start of the file, so they are
+	 * compacted in order, each column in order. */
+	for (v = f->vars; v && status == MAT_OK; v = v->next) {
+		if (v->start == dst && v->rows == v->maxrows) {
+			dst = v->data + (mat_off) (v->ncols * v->rows * sizeof(double));
+			continue;
+		}
+		if (!tmp && !(tmp = (char *) malloc(MAT_MOVE_SIZE))) {
+			status = MAT_ENOMEM;
+			break;
+		}
+		data = dst + (mat_off) head_size(v->name);
+		for (c = 0; c < v->ncols && status == MAT_OK; c++)
+			status = move_down(f->fp, data + (mat_off) (c*v->rows*sizeof(double)),
+					v->data + (mat_off) (c*v->maxrows*sizeof(double)),
+					(mat_off) (v->rows*sizeof(double)), tmp);
+		if (status == MAT_OK && (mat_fseek(f->fp, dst, SEEK_SET) != 0 ||
+				put_head(f->fp, v->name, v->rows, v->ncols) != MAT_OK))
+			status = MAT_EIO;
+		dst = data + (mat_off) (v->ncols * v->rows * sizeof(double));
+	}
+	if (status == MAT_OK && (fflush(f->fp) != 0 || mat_truncate(f->fp, dst) != 0))
+		status = MAT_EIO;
+	if (fclose(f->fp) != 0 && status == MAT_OK)
+		status = MAT_EIO;
+	for (v = f->vars; v; v = next) {
+		next = v->next;
+		free(v->buf);
+		free(v);
+	}
+	free(tmp);
+	free(f);
+	return status;
+}
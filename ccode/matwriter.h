@@ -0,0 +1,67 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Streaming MAT-file (level 5) writer.
+ *
+ * Writes double matrices that MATLAB's load reads directly, without linking
+ * MATLAB. A streamed variable is declared with its column count and an upper
+ * bound on its rows; rows are appended one at a time and go to disk a block
+ * at a time, each column chunk at its final offset, so a run is never held
+ * in memory. mat_close() fixes the sizes of variables that received fewer
+ * rows than declared and closes the gaps left by them.
+ *
+ * Each variable is limited to 2^32 bytes by the level 5 format. MAT 7.3
+ * (HDF5) files are not written.
+ */
+
+#ifndef __MATWRITER_H__
+#define __MATWRITER_H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAT_DEFAULT_BLOCK_ROWS 1024
+
+/* Status codes */
+#define MAT_OK        0
+#define MAT_EIO      -1
+#define MAT_ENOMEM   -2
+#define MAT_EARG     -3
+#define MAT_EFULL    -4
+
+typedef struct MatFile MatFile;
+typedef struct MatVar MatVar;
+
+const char *mat_strerror(int status);
+
+int mat_create(const char *path, MatFile **out);
+
+/* Writes the m x n matrix a (column-major) as variable name. */
+int mat_put(MatFile *f, const char *name, const double *a, size_t m, size_t n);
+
+/* Declares a streamed variable of ncols columns and at most maxrows rows.
+ * The variable belongs to f and is released by mat_close(). */
+int mat_begin(MatFile *f, const char *name, size_t ncols, size_t maxrows,
+		MatVar **out);
+
+/* Appends one row of ncols values; MAT_EFULL once maxrows rows were
+ * appended. */
+int mat_append(MatVar *v, const double *row);
+
+/* Flushes and finalizes all variables and closes the file. */
+int mat_close(MatFile *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MATWRITER_H__ */
@@ -12,9 +12,12 @@
 
 #ifdef __PROTOTYPES_H__
 
-void report(const char* message, SimStruct *S)
+/* A binary record instead of an ssPrintf line: neither formatting nor a
+ * status query on the simulation's path; ttr_format() and SimState() make
+ * it readable offline. */
+void report(TTRBuffer *trace, int event, SimStruct *S)
 {
-	ssPrintf("%f: %s (%s).\n", ssGetTime(S), message, SimState(S));
+	TTR(trace, TTR_INFO, event, ssGetT(S), 0., 0., 0.);
 }
 
 #ifdef __SS_SimStatus_Strings__
@@ -38,7 +41,7 @@ time_T ssGetTime(SimStruct *S)
     // SIMSTATUS_EXTERNAL
 }
 
-int ssGetSimState(SimStruct *S)
+SS_SimStatus ssGetSimState(SimStruct *S)
 {
 	SS_SimStatus status;	
 	ssGetSimStatus(S, &status);
@@ -10,7 +10,10 @@
 #ifndef __PROTOTYPES_H__
 #define __PROTOTYPES_H__
 
-void report(const char* function, SimStruct *S);
+#include "tetrace.h"
+
+/* Traces event (tetrace.h) at the block's time. */
+void report(TTRBuffer *trace, int event, SimStruct *S);
 
 
 #if defined(__SIMSTRUC_TYPES_H__) && !defined(__SS_SimStatus_Strings__)
@@ -0,0 +1,827 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Chunked columnar run store, see runstore.h.
+ *
+ * File layout (native byte order, little-endian on all supported targets):
+ *   header   64 bytes, see put_header()
+ *   blocks   per block: time column, then value columns, each XOR-encoded
+ *   index    per block: tmin, tmax, nrows, level, then per column
+ *            (offset, length)
+ * The header is rewritten on rs_close() with the index offset; a file whose
+ * writer did not close it has no index and is rejected by rs_open().
+ *
+ * Level 0 blocks hold the raw samples. A level k block (k >= RS_PYRAMID_FIRST)
+ * holds one entry per 2^k samples: the time of the first sample, then min,
+ * max and mean of every value column. The levels are built while the run is
+ * written, each from two entries of the level below.
+ */
+
+#if !defined(_WIN32)
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "runstore.h"
+
+#if defined(_WIN32)
+#define rs_fseek _fseeki64
+typedef __int64 rs_off;
+typedef unsigned __int64 rs_u64;
+typedef unsigned __int32 rs_u32;
+#else
+#include <stdint.h>
+#include <sys/types.h>
+#define rs_fseek fseeko
+typedef int64_t rs_off;
+typedef uint64_t rs_u64;
+typedef uint32_t rs_u32;
+#endif
+
+#define RS_MAGIC "TERSTORE"
+#define RS_VERSION 2         /* 1: no pyramid levels */
+#define RS_HEADER_SIZE 64
+#define RS_BLOCK_SIZE 24     /* tmin, tmax, nrows, level */
+#define RS_COLUMN_SIZE 12    /* offset, length */
+#define RS_MAX_ENCODED 9     /* bytes per encoded value, worst case */
+
+typedef struct {
+	long nblocks, cap;
+	long ncolumns, colcap;
+	double *tmin, *tmax;
+	rs_u32 *nrows, *level;
+	long *first;             /* first column entry of each block */
+	rs_u64 *off;
+	rs_u32 *len;
+} RSIndex;
+
+/* Block being filled for one level */
+typedef struct {
+	int rows, cap, width;    /* width includes the time column */
+	double *buf;             /* [width][cap] */
+} RSLevel;
+
+/* Pending pyramid entry */
+typedef struct {
+	long n, children;
+	double t;
+	double *min, *max, *sum;
+} RSEntry;
+
+struct RunStoreWriter {
+	FILE *fp;
+	int ncols;
+	RSLevel lvl[RS_PYRAMID_LEVELS + 1];
+	RSEntry acc[RS_PYRAMID_LEVELS + 1];
+	long emitted[RS_PYRAMID_LEVELS + 1];
+	double *accmem;
+	unsigned char *enc;
+	rs_u64 pos, nrows;
+	double tmin, tmax;
+	RSIndex index;
+};
+
+struct RunStore {
+	FILE *fp;
+	int ncols, blockrows, levels;
+	rs_u64 nrows;
+	double tmin, tmax;
+	double *tbuf, *vbuf;
+	unsigned char *enc;
+	RSIndex index;
+};
+
+const char *rs_strerror(int status)
+{
+	switch (status) {
+	case RS_OK:      return "no error";
+	case RS_EIO:     return "I/O error";
+	case RS_EFORMAT: return "not a run store or file truncated";
+	case RS_ENOMEM:  return "out of memory";
+	case RS_EARG:    return "invalid argument";
+	default:         return "unknown error";
+	}
+}
+
+/* Columns of a block at the given level, time included. */
+static int level_width(int ncols, int level)
+{
+	return level == 0 ? ncols + 1 : 3*ncols + 1;
+}
+
+/* ============================================================================= */
+
+/* Byte order helpers */
+
+static void put_u32(unsigned char *p, rs_u32 v) { memcpy(p, &v, 4); }
+static void put_u64(unsigned char *p, rs_u64 v) { memcpy(p, &v, 8); }
+static void put_f64(unsigned char *p, double v) { memcpy(p, &v, 8); }
+static rs_u32 get_u32(const unsigned char *p) { rs_u32 v; memcpy(&v, p, 4); return v; }
+static rs_u64 get_u64(const unsigned char *p) { rs_u64 v; memcpy(&v, p, 8); return v; }
+static double get_f64(const unsigned char *p) { double v; memcpy(&v, p, 8); return v; }
+
+/* XOR codec. Each value is XORed with its predecessor in the column; the
+ * result is written as one byte holding the number of leading (high nibble)
+ * and trailing (low nibble) zero bytes, followed by the remaining bytes.
+ * Slowly varying signals share sign, exponent and high mantissa bytes. */
+
+static size_t rs_encode(const double *v, size_t n, unsigned char *out)
+{
+	unsigned char *p = out;
+	rs_u64 prev = 0, x, w;
+	int lead, trail, k;
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		memcpy(&x, &v[i], 8);
+		w = x ^ prev;
+		prev = x;
+		if (w == 0) {
+			*p++ = 0x80;
+			continue;
+		}
+		for (lead = 0; ((w >> (56 - 8*lead)) & 0xff) == 0; lead++)
+			;
+		for (trail = 0; ((w >> (8*trail)) & 0xff) == 0; trail++)
+			;
+		*p++ = (unsigned char) ((lead << 4) | trail);
+		for (k = trail; k < 8 - lead; k++)
+			*p++ = (unsigned char) (w >> (8*k));
+	}
+	return (size_t) (p - out);
+}
+
+static int rs_decode(const unsigned char *in, size_t len, double *v, size_t n)
+{
+	const unsigned char *p = in, *end = in + len;
+	rs_u64 prev = 0, w;
+	int lead, trail, k;
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		if (p >= end)
+			return RS_EFORMAT;
+		lead = *p >> 4;
+		trail = *p++ & 0x0f;
+		w = 0;
+		if (lead < 8) {
+			if (lead + trail > 8 || end - p < 8 - lead - trail)
+				return RS_EFORMAT;
+			for (k = trail; k < 8 - lead; k++)
+				w |= (rs_u64) *p++ << (8*k);
+		}
+		prev ^= w;
+		memcpy(&v[i], &prev, 8);
+	}
+	return RS_OK;
+}
+
+/* ============================================================================= */
+
+/* Index */
+
+static int index_reserve(RSIndex *ix, long nblocks, long ncolumns)
+{
+	long cap;
+	void *p;
+
+	if (nblocks > ix->cap) {
+		cap = ix->cap ? 2*ix->cap : 64;
+		while (cap < nblocks)
+			cap *= 2;
+		if (!(p = realloc(ix->tmin, cap*sizeof(double)))) return RS_ENOMEM;
+		ix->tmin = (double *) p;
+		if (!(p = realloc(ix->tmax, cap*sizeof(double)))) return RS_ENOMEM;
+		ix->tmax = (double *) p;
+		if (!(p = realloc(ix->nrows, cap*sizeof(rs_u32)))) return RS_ENOMEM;
+		ix->nrows = (rs_u32 *) p;
+		if (!(p = realloc(ix->level, cap*sizeof(rs_u32)))) return RS_ENOMEM;
+		ix->level = (rs_u32 *) p;
+		if (!(p = realloc(ix->first, cap*sizeof(long)))) return RS_ENOMEM;
+		ix->first = (long *) p;
+		ix->cap = cap;
+	}
+	if (ncolumns > ix->colcap) {
+		cap = ix->colcap ? 2*ix->colcap : 1024;
+		while (cap < ncolumns)
+			cap *= 2;
+		if (!(p = realloc(ix->off, cap*sizeof(rs_u64)))) return RS_ENOMEM;
+		ix->off = (rs_u64 *) p;
+		if (!(p = realloc(ix->len, cap*sizeof(rs_u32)))) return RS_ENOMEM;
+		ix->len = (rs_u32 *) p;
+		ix->colcap = cap;
+	}
+	return RS_OK;
+}
+
+static void index_free(RSIndex *ix)
+{
+	free(ix->tmin);
+	free(ix->tmax);
+	free(ix->nrows);
+	free(ix->level);
+	free(ix->first);
+	free(ix->off);
+	free(ix->len);
+	memset(ix, 0, sizeof(*ix));
+}
+
+static void put_header(unsigned char *h, int ncols, int blockrows, long nblocks,
+		rs_u64 nrows, rs_u64 index, double tmin, double tmax)
+{
+	memset(h, 0, RS_HEADER_SIZE);
+	memcpy(h, RS_MAGIC, 8);
+	put_u32(h + 8, RS_VERSION);
+	put_u32(h + 12, (rs_u32) ncols);
+	put_u32(h + 16, (rs_u32) blockrows);
+	put_u64(h + 24, (rs_u64) nblocks);
+	put_u64(h + 32, nrows);
+	put_u64(h + 40, index);
+	put_f64(h + 48, tmin);
+	put_f64(h + 56, tmax);
+}
+
+/* ============================================================================= */
+
+/* Writer */
+
+static void writer_free(RunStoreWriter *w)
+{
+	int k;
+
+	for (k = 0; k <= RS_PYRAMID_LEVELS; k++)
+		free(w->lvl[k].buf);
+	free(w->accmem);
+	free(w->enc);
+	index_free(&w->index);
+	free(w);
+}
+
+int rs_create(const char *path, int ncols, int blockrows, RunStoreWriter **out)
+{
+	RunStoreWriter *w;
+	unsigned char h[RS_HEADER_SIZE];
+	int k;
+
+	*out = NULL;
+	if (ncols < 1 || blockrows < 0)
+		return RS_EARG;
+	if (blockrows == 0)
+		blockrows = RS_DEFAULT_BLOCK_ROWS;
+	if (!(w = (RunStoreWriter *) calloc(1, sizeof(*w))))
+		return RS_ENOMEM;
+	w->ncols = ncols;
+	for (k = 0; k <= RS_PYRAMID_LEVELS; k++) {
+		w->lvl[k].width = level_width(ncols, k);
+		w->lvl[k].cap = k == 0 || blockrows < RS_PYRAMID_BLOCK_ROWS ?
+			blockrows : RS_PYRAMID_BLOCK_ROWS;
+	}
+	/* Pyramid level buffers are allocated when a level is first reached. */
+	w->lvl[0].buf = (double *) malloc((size_t) w->lvl[0].width * blockrows * sizeof(double));
+	w->accmem = (double *) malloc((size_t) 3 * ncols * (RS_PYRAMID_LEVELS + 1) * sizeof(double));
+	w->enc = (unsigned char *) malloc((size_t) blockrows * RS_MAX_ENCODED);
+	if (!w->lvl[0].buf || !w->accmem || !w->enc ||
+			index_reserve(&w->index, 1, 1) != RS_OK) {
+		writer_free(w);
+		return RS_ENOMEM;
+	}
+	for (k = 0; k <= RS_PYRAMID_LEVELS; k++) {
+		w->acc[k].min = w->accmem + (size_t) 3*ncols*k;
+		w->acc[k].max = w->acc[k].min + ncols;
+		w->acc[k].sum = w->acc[k].max + ncols;
+	}
+	if (!(w->fp = fopen(path, "wb"))) {
+		writer_free(w);
+		return RS_EIO;
+	}
+	put_header(h, ncols, blockrows, 0, 0, 0, 0., 0.);
+	if (fwrite(h, 1, RS_HEADER_SIZE, w->fp) != RS_HEADER_SIZE) {
+		fclose(w->fp);
+		writer_free(w);
+		return RS_EIO;
+	}
+	w->pos = RS_HEADER_SIZE;
+	*out = w;
+	return RS_OK;
+}
+
+static int rs_flush(RunStoreWriter *w, int level)
+{
+	RSIndex *ix = &w->index;
+	RSLevel *l = &w->lvl[level];
+	long b = ix->nblocks, col = ix->ncolumns;
+	size_t len;
+	int c, status;
+
+	if (l->rows == 0)
+		return RS_OK;
+	if ((status = index_reserve(ix, b + 1, col + l->width)) != RS_OK)
+		return status;
+	ix->tmin[b] = l->buf[0];
+	ix->tmax[b] = l->buf[l->rows - 1];
+	ix->nrows[b] = (rs_u32) l->rows;
+	ix->level[b] = (rs_u32) level;
+	ix->first[b] = col;
+	for (c = 0; c < l->width; c++) {
+		len = rs_encode(&l->buf[(size_t) c*l->cap], (size_t) l->rows, w->enc);
+		if (fwrite(w->enc, 1, len, w->fp) != len)
+			return RS_EIO;
+		ix->off[col + c] = w->pos;
+		ix->len[col + c] = (rs_u32) len;
+		w->pos += len;
+	}
+	ix->nblocks++;
+	ix->ncolumns += l->width;
+	l->rows = 0;
+	return RS_OK;
+}
+
+/* Writes the pending entry of level k and merges it into level k+1. */
+static int rs_emit(RunStoreWriter *w, int k)
+{
+	RSEntry *e = &w->acc[k], *up;
+	RSLevel *l = &w->lvl[k];
+	int c, status;
+
+	if (!l->buf && !(l->buf = (double *) malloc((size_t) l->width * l->cap * sizeof(double))))
+		return RS_ENOMEM;
+	l->buf[l->rows] = e->t;
+	for (c = 0; c < w->ncols; c++) {
+		l->buf[(size_t) (3*c + 1)*l->cap + l->rows] = e->min[c];
+		l->buf[(size_t) (3*c + 2)*l->cap + l->rows] = e->max[c];
+		l->buf[(size_t) (3*c + 3)*l->cap + l->rows] = e->sum[c] / e->n;
+	}
+	w->emitted[k]++;
+	if (++l->rows == l->cap && (status = rs_flush(w, k)) != RS_OK)
+		return status;
+	if (k < RS_PYRAMID_LEVELS) {
+		up = &w->acc[k + 1];
+		if (up->children++ == 0) {
+			up->t = e->t;
+			up->n = e->n;
+			memcpy(up->min, e->min, 3 * w->ncols * sizeof(double));
+		} else {
+			up->n += e->n;
+			for (c = 0; c < w->ncols; c++) {
+				if (e->min[c] < up->min[c]) up->min[c] = e->min[c];
+				if (e->max[c] > up->max[c]) up->max[c] = e->max[c];
+				up->sum[c] += e->sum[c];
+			}
+		}
+	}
+	e->n = e->children = 0;
+	if (k < RS_PYRAMID_LEVELS && w->acc[k + 1].children == 2)
+		return rs_emit(w, k + 1);
+	return RS_OK;
+}
+
+int rs_append(RunStoreWriter *w, double t, const double *row)
+{
+	RSLevel *l = &w->lvl[0];
+	RSEntry *e = &w->acc[RS_PYRAMID_FIRST];
+	int c, status;
+
+	if (w->nrows == 0)
+		w->tmin = t;
+	else if (t < w->tmax)
+		return RS_EARG;
+	w->tmax = t;
+	w->nrows++;
+	l->buf[l->rows] = t;
+	for (c = 0; c < w->ncols; c++)
+		l->buf[(size_t) (c + 1)*l->cap + l->rows] = row[c];
+	if (++l->rows == l->cap && (status = rs_flush(w, 0)) != RS_OK)
+		return status;
+
+	if (e->n++ == 0) {
+		e->t = t;
+		memcpy(e->min, row, w->ncols * sizeof(double));
+		memcpy(e->max, row, w->ncols * sizeof(double));
+		memcpy(e->sum, row, w->ncols * sizeof(double));
+	} else {
+		for (c = 0; c < w->ncols; c++) {
+			if (row[c] < e->min[c]) e->min[c] = row[c];
+			if (row[c] > e->max[c]) e->max[c] = row[c];
+			e->sum[c] += row[c];
+		}
+	}
+	if (e->n == 1L << RS_PYRAMID_FIRST)
+		return rs_emit(w, RS_PYRAMID_FIRST);
+	return RS_OK;
+}
+
+int rs_close(RunStoreWriter *w)
+{
+	RSIndex *ix;
+	unsigned char rec[RS_BLOCK_SIZE], h[RS_HEADER_SIZE];
+	rs_u64 index;
+	long b, c;
+	int k, status;
+
+	if (!w)
+		return RS_EARG;
+	ix = &w->index;
+	status = rs_flush(w, 0);
+	/* Partial entries close the levels that have more than one entry below
+	 * them; a level that would hold a single entry is left out. */
+	for (k = RS_PYRAMID_FIRST; status == RS_OK && k <= RS_PYRAMID_LEVELS; k++) {
+		if (w->acc[k].n > 0 && (k == RS_PYRAMID_FIRST || w->emitted[k - 1] > 1))
+			status = rs_emit(w, k);
+		if (status == RS_OK)
+			status = rs_flush(w, k);
+	}
+	index = w->pos;
+	for (b = 0; status == RS_OK && b < ix->nblocks; b++) {
+		put_f64(rec, ix->tmin[b]);
+		put_f64(rec + 8, ix->tmax[b]);
+		put_u32(rec + 16, ix->nrows[b]);
+		put_u32(rec + 20, ix->level[b]);
+		if (fwrite(rec, 1, RS_BLOCK_SIZE, w->fp) != RS_BLOCK_SIZE)
+			status = RS_EIO;
+		for (c = ix->first[b]; status == RS_OK &&
+				c < ix->first[b] + level_width(w->ncols, ix->level[b]); c++) {
+			memset(rec, 0, RS_COLUMN_SIZE);
+			put_u64(rec, ix->off[c]);
+			put_u32(rec + 8, ix->len[c]);
+			if (fwrite(rec, 1, RS_COLUMN_SIZE, w->fp) != RS_COLUMN_SIZE)
+				status = RS_EIO;
+		}
+	}
+	if (status == RS_OK) {
+		put_header(h, w->ncols, w->lvl[0].cap, ix->nblocks, w->nrows, index,
+				w->tmin, w->tmax);
+		if (rs_fseek(w->fp, 0, SEEK_SET) != 0 ||
+				fwrite(h, 1, RS_HEADER_SIZE, w->fp) != RS_HEADER_SIZE)
+			status = RS_EIO;
+	}
+	if (fclose(w->fp) != 0 && status == RS_OK)
+		status = RS_EIO;
+	writer_free(w);
+	return status;
+}
+
+/* ============================================================================= */
+
+/* Reader */
+
+int rs_open(const char *path, RunStore **out)
+{
+	RunStore *s;
+	RSIndex *ix;
+	unsigned char h[RS_HEADER_SIZE], rec[RS_BLOCK_SIZE];
+	rs_u64 index;
+	rs_u32 version;
+	long b, c, nblocks, width;
+	int status = RS_OK;
+
+	*out = NULL;
+	if (!(s = (RunStore *) calloc(1, sizeof(*s))))
+		return RS_ENOMEM;
+	if (!(s->fp = fopen(path, "rb"))) {
+		free(s);
+		return RS_EIO;
+	}
+	ix = &s->index;
+	if (fread(h, 1, RS_HEADER_SIZE, s->fp) != RS_HEADER_SIZE ||
+			memcmp(h, RS_MAGIC, 8) != 0 ||
+			(version = get_u32(h + 8)) < 1 || version > RS_VERSION ||
+			(index = get_u64(h + 40)) == 0) {
+		status = RS_EFORMAT;
+		goto fail;
+	}
+	s->ncols = (int) get_u32(h + 12);
+	s->blockrows = (int) get_u32(h + 16);
+	nblocks = (long) get_u64(h + 24);
+	s->nrows = get_u64(h + 32);
+	s->tmin = get_f64(h + 48);
+	s->tmax = get_f64(h + 56);
+	if (s->ncols < 1 || s->blockrows < 1) {
+		status = RS_EFORMAT;
+		goto fail;
+	}
+	s->tbuf = (double *) malloc((size_t) s->blockrows * sizeof(double));
+	s->vbuf = (double *) malloc((size_t) s->blockrows * sizeof(double));
+	s->enc = (unsigned char *) malloc((size_t) s->blockrows * RS_MAX_ENCODED);
+	if (!s->tbuf || !s->vbuf || !s->enc ||
+			index_reserve(ix, nblocks > 0 ? nblocks : 1, 1) != RS_OK) {
+		status = RS_ENOMEM;
+		goto fail;
+	}
+	if (rs_fseek(s->fp, (rs_off) index, SEEK_SET) != 0) {
+		status = RS_EIO;
+		goto fail;
+	}
+	for (b = 0; b < nblocks; b++) {
+		if (fread(rec, 1, RS_BLOCK_SIZE, s->fp) != RS_BLOCK_SIZE) {
+			status = RS_EFORMAT;
+			goto fail;
+		}
+		ix->tmin[b] = get_f64(rec);
+		ix->tmax[b] = get_f64(rec + 8);
+		ix->nrows[b] = get_u32(rec + 16);
+		ix->level[b] = version < 2 ? 0 : get_u32(rec + 20);
+		ix->first[b] = ix->ncolumns;
+		if (ix->nrows[b] > (rs_u32) s->blockrows ||
+				ix->level[b] > RS_PYRAMID_LEVELS) {
+			status = RS_EFORMAT;
+			goto fail;
+		}
+		if ((int) ix->level[b] > s->levels)
+			s->levels = (int) ix->level[b];
+		width = level_width(s->ncols, (int) ix->level[b]);
+		if ((status = index_reserve(ix, nblocks, ix->ncolumns + width)) != RS_OK)
+			goto fail;
+		for (c = ix->ncolumns; c < ix->ncolumns + width; c++) {
+			if (fread(rec, 1, RS_COLUMN_SIZE, s->fp) != RS_COLUMN_SIZE) {
+				status = RS_EFORMAT;
+				goto fail;
+			}
+			ix->off[c] = get_u64(rec);
+			ix->len[c] = get_u32(rec + 8);
+			if (ix->len[c] > (rs_u32) s->blockrows * RS_MAX_ENCODED) {
+				status = RS_EFORMAT;
+				goto fail;
+			}
+		}
+		ix->ncolumns += width;
+	}
+	ix->nblocks = nblocks;
+	*out = s;
+	return RS_OK;
+
+fail:
+	rs_free(s);
+	return status;
+}
+
+void rs_info(const RunStore *s, RunStoreInfo *info)
+{
+	info->ncols = s->ncols;
+	info->blockrows = s->blockrows;
+	info->levels = s->levels;
+	info->nblocks = s->index.nblocks;
+	info->nrows = (double) s->nrows;
+	info->tmin = s->tmin;
+	info->tmax = s->tmax;
+}
+
+void rs_free(RunStore *s)
+{
+	if (!s)
+		return;
+	if (s->fp)
+		fclose(s->fp);
+	free(s->tbuf);
+	free(s->vbuf);
+	free(s->enc);
+	index_free(&s->index);
+	free(s);
+}
+
+/* Reads and decodes column c of block b into v. */
+static int read_column(RunStore *s, long b, int c, double *v)
+{
+	RSIndex *ix = &s->index;
+	long col = ix->first[b] + c;
+	size_t len = ix->len[col];
+
+	if (rs_fseek(s->fp, (rs_off) ix->off[col], SEEK_SET) != 0 ||
+			fread(s->enc, 1, len, s->fp) != len)
+		return RS_EIO;
+	return rs_decode(s->enc, len, v, ix->nrows[b]);
+}
+
+/* End of the span of block b. A pyramid entry covers its 2^k samples, up to
+ * the next entry of the level: the span of a pyramid block ends at the next
+ * block of its level, or at the last sample of the run. A level 0 block ends
+ * at its last row. */
+static double block_end(const RunStore *s, long b)
+{
+	const RSIndex *ix = &s->index;
+	long c;
+
+	if (ix->level[b] == 0)
+		return ix->tmax[b];
+	for (c = b + 1; c < ix->nblocks; c++)
+		if (ix->level[c] == ix->level[b])
+			return ix->tmin[c];
+	return s->tmax;
+}
+
+/* Row range [*i0, *i1) of block b inside [t0, t1], b overlapping it. At a
+ * pyramid level the range starts at the last entry with t <= t0, whose
+ * samples straddle t0. Only boundary blocks need their time column; s->tbuf
+ * holds it on return when *loaded is set. */
+static int block_rows(RunStore *s, long b, double t0, double t1,
+		long *i0, long *i1, int *loaded)
+{
+	RSIndex *ix = &s->index;
+	long n = (long) ix->nrows[b];
+	int status;
+
+	*loaded = 0;
+	*i0 = 0;
+	*i1 = n;
+	if (ix->tmin[b] >= t0 && ix->tmax[b] <= t1)
+		return RS_OK;
+	if ((status = read_column(s, b, 0, s->tbuf)) != RS_OK)
+		return status;
+	*loaded = 1;
+	while (*i0 < n && s->tbuf[*i0] < t0)
+		(*i0)++;
+	if (ix->level[b] > 0 && *i0 > 0 && (*i0 == n || s->tbuf[*i0] > t0))
+		(*i0)--;
+	while (*i1 > *i0 && s->tbuf[*i1 - 1] > t1)
+		(*i1)--;
+	return RS_OK;
+}
+
+static int overlaps(const RunStore *s, long b, int level, double t0, double t1)
+{
+	const RSIndex *ix = &s->index;
+	double end;
+
+	if ((int) ix->level[b] != level || ix->tmin[b] > t1)
+		return 0;
+	/* The next block of the level starts at end; the last one holds the
+	 * last sample. */
+	end = block_end(s, b);
+	return level == 0 || end == s->tmax ? end >= t0 : end > t0;
+}
+
+size_t rs_count_level(RunStore *s, int level, double t0, double t1)
+{
+	RSIndex *ix = &s->index;
+	long b, i0, i1;
+	int loaded;
+	size_t n = 0;
+
+	for (b = 0; b < ix->nblocks; b++) {
+		if (!overlaps(s, b, level, t0, t1))
+			continue;
+		if (block_rows(s, b, t0, t1, &i0, &i1, &loaded) != RS_OK)
+			return 0;
+		n += (size_t) (i1 - i0);
+	}
+	return n;
+}
+
+size_t rs_count(RunStore *s, double t0, double t1)
+{
+	return rs_count_level(s, 0, t0, t1);
+}
+
+/* Reads block columns cols[j] of the blocks at the given level into dst[j],
+ * rows in [t0, t1] only. */
+static long read_level(RunStore *s, int level, const int *cols, int ncols,
+		double t0, double t1, double *t, double **dst, size_t maxrows)
+{
+	RSIndex *ix = &s->index;
+	long b, i0, i1, m;
+	size_t n = 0;
+	int j, loaded, status;
+
+	for (b = 0; b < ix->nblocks && n < maxrows; b++) {
+		if (!overlaps(s, b, level, t0, t1))
+			continue;
+		if ((status = block_rows(s, b, t0, t1, &i0, &i1, &loaded)) != RS_OK)
+			return status;
+		if ((size_t) (i1 - i0) > maxrows - n)
+			i1 = i0 + (long) (maxrows - n);
+		if (i1 <= i0)
+			continue;
+		m = i1 - i0;
+		if (t) {
+			if (!loaded && (status = read_column(s, b, 0, s->tbuf)) != RS_OK)
+				return status;
+			memcpy(&t[n], &s->tbuf[i0], (size_t) m * sizeof(double));
+		}
+		for (j = 0; j < ncols; j++) {
+			if ((status = read_column(s, b, cols[j], s->vbuf)) != RS_OK)
+				return status;
+			memcpy(&dst[j][n], &s->vbuf[i0], (size_t) m * sizeof(double));
+		}
+		n += (size_t) m;
+	}
+	return (long) n;
+}
+
+long rs_read(RunStore *s, const int *cols, int ncols, double t0, double t1,
+		double *t, double *y, size_t maxrows)
+{
+	double **dst;
+	long n;
+	int j;
+
+	for (j = 0; j < ncols; j++)
+		if (cols[j] < 1 || cols[j] > s->ncols)
+			return RS_EARG;
+	if (!(dst = (double **) malloc((ncols > 0 ? ncols : 1) * sizeof(double *))))
+		return RS_ENOMEM;
+	for (j = 0; j < ncols; j++)
+		dst[j] = &y[(size_t) j*maxrows];
+	n = read_level(s, 0, cols, ncols, t0, t1, t, dst, maxrows);
+	free(dst);
+	return n;
+}
+
+long rs_next(RunStore *s, long *pos, const int *cols, int ncols, double *t,
+		double *y, size_t maxrows)
+{
+	RSIndex *ix = &s->index;
+	long b = *pos;
+	int j, status;
+
+	while (b < ix->nblocks && ix->level[b] != 0)
+		b++;
+	if (b >= ix->nblocks) {
+		*pos = b;
+		return 0;
+	}
+	if (ix->nrows[b] > maxrows)
+		return RS_EARG;
+	for (j = 0; j < ncols; j++)
+		if (cols[j] < 1 || cols[j] > s->ncols)
+			return RS_EARG;
+	if (t && (status = read_column(s, b, 0, t)) != RS_OK)
+		return status;
+	for (j = 0; j < ncols; j++)
+		if ((status = read_column(s, b, cols[j], &y[(size_t) j*maxrows])) != RS_OK)
+			return status;
+	*pos = b + 1;
+	return (long) ix->nrows[b];
+}
+
+int rs_level(RunStore *s, double t0, double t1, int width)
+{
+	RSIndex *ix = &s->index;
+	double rows = 0.;
+	long b;
+	int k;
+
+	if (width < 1)
+		return 0;
+	for (b = 0; b < ix->nblocks; b++)
+		if (overlaps(s, b, 0, t0, t1))
+			rows += ix->nrows[b];
+	if (rows <= 2.*width || s->levels < RS_PYRAMID_FIRST)
+		return 0;
+	for (k = RS_PYRAMID_FIRST; k < s->levels; k++)
+		if (rows / (double) (1L << k) <= 2.*width)
+			break;
+	return k;
+}
+
+long rs_read_summary(RunStore *s, int level, const int *cols, int ncols,
+		double t0, double t1, double *t, double *ymin, double *ymax,
+		double *ymean, size_t maxrows)
+{
+	double **dst;
+	int *bcols;
+	long n;
+	int j;
+
+	for (j = 0; j < ncols; j++)
+		if (cols[j] < 1 || cols[j] > s->ncols)
+			return RS_EARG;
+	if (level == 0) {
+		if ((n = rs_read(s, cols, ncols, t0, t1, t, ymean, maxrows)) > 0) {
+			memcpy(ymin, ymean, (size_t) ncols * maxrows * sizeof(double));
+			memcpy(ymax, ymean, (size_t) ncols * maxrows * sizeof(double));
+		}
+		return n;
+	}
+	if (level < RS_PYRAMID_FIRST || level > s->levels)
+		return RS_EARG;
+	dst = (double **) malloc((ncols > 0 ? 3*ncols : 1) * sizeof(double *));
+	bcols = (int *) malloc((ncols > 0 ? 3*ncols : 1) * sizeof(int));
+	if (!dst || !bcols) {
+		free(dst);
+		free(bcols);
+		return RS_ENOMEM;
+	}
+	for (j = 0; j < ncols; j++) {
+		bcols[3*j] = 3*(cols[j] - 1) + 1;
+		bcols[3*j + 1] = 3*(cols[j] - 1) + 2;
+		bcols[3*j + 2] = 3*(cols[j] - 1) + 3;
+		dst[3*j] = &ymin[(size_t) j*maxrows];
+		dst[3*j + 1] = &ymax[(size_t) j*maxrows];
+		dst[3*j + 2] = &ymean[(size_t) j*maxrows];
+	}
+	n = read_level(s, level, bcols, 3*ncols, t0, t1, t, dst, maxrows);
+	free(dst);
+	free(bcols);
+	return n;
+}
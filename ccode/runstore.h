@@ -0,0 +1,116 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Chunked columnar run store.
+ *
+ * A run is stored as a sequence of blocks of at most BlockRows rows. Every
+ * block holds the time column followed by the value columns, each column
+ * compressed separately (XOR with the previous sample, leading/trailing zero
+ * bytes dropped). A sparse index at the end of the file keeps, per block,
+ * its min/max time and the offset and length of every column, so that a read
+ * of (columns, t0..t1) only touches the blocks and columns it needs.
+ *
+ * While a run is written, a min/max/mean pyramid is built next to the raw
+ * blocks: level k (k >= RS_PYRAMID_FIRST) has one entry per 2^k samples.
+ * A plot of N pixels then reads about 2N entries from the matching level
+ * (rs_level, rs_read_summary) instead of every sample in the window.
+ *
+ * Layout used for TE runs: columns 1..41 are xmeas (simout), 42..53 are xmv.
+ */
+
+#ifndef __RUNSTORE_H__
+#define __RUNSTORE_H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RS_XMEAS_COLUMN  1   /* first xmeas column (1-based) */
+#define RS_XMV_COLUMN    42  /* first xmv column (1-based) */
+#define RS_TE_COLUMNS    53  /* 41 xmeas + 12 xmv */
+
+#define RS_DEFAULT_BLOCK_ROWS 4096
+
+#define RS_PYRAMID_FIRST      4    /* finest level: 16 samples per entry */
+#define RS_PYRAMID_LEVELS     30   /* coarsest level */
+#define RS_PYRAMID_BLOCK_ROWS 256  /* entries per pyramid block */
+
+/* Status codes */
+#define RS_OK        0
+#define RS_EIO      -1
+#define RS_EFORMAT  -2
+#define RS_ENOMEM   -3
+#define RS_EARG     -4
+
+typedef struct RunStoreWriter RunStoreWriter;
+typedef struct RunStore RunStore;
+
+typedef struct {
+	int ncols;          /* number of value columns (time excluded) */
+	int blockrows;
+	int levels;         /* coarsest pyramid level present, 0 if none */
+	long nblocks;       /* raw and pyramid blocks */
+	double nrows;       /* total rows, as double for MATLAB */
+	double tmin, tmax;
+} RunStoreInfo;
+
+const char *rs_strerror(int status);
+
+/* Writer. Rows must be appended in non-decreasing time order. No memory is
+ * allocated per row; one block per level is buffered and flushed when full. */
+int rs_create(const char *path, int ncols, int blockrows, RunStoreWriter **out);
+int rs_append(RunStoreWriter *w, double t, const double *row);
+int rs_close(RunStoreWriter *w);
+
+/* Reader. cols are 1-based value column numbers. */
+int rs_open(const char *path, RunStore **out);
+void rs_info(const RunStore *s, RunStoreInfo *info);
+
+/* Number of rows in the window [t0, t1]. Blocks fully inside the window
+ * are counted from the index; only the two boundary blocks are read. */
+size_t rs_count(RunStore *s, double t0, double t1);
+
+/* Reads the rows with t0 <= t <= t1 into t (length maxrows) and y, stored
+ * column-major with leading dimension maxrows. Returns the number of rows
+ * read, or a negative status. */
+long rs_read(RunStore *s, const int *cols, int ncols, double t0, double t1,
+		double *t, double *y, size_t maxrows);
+
+/* Reads the next raw block, the first after *pos (0 to start), into t and
+ * y as rs_read does, and advances *pos; maxrows must be at least
+ * blockrows. Streams a whole store in memory for one block. Returns the
+ * number of rows read, 0 past the last block, or a negative status. */
+long rs_next(RunStore *s, long *pos, const int *cols, int ncols, double *t,
+		double *y, size_t maxrows);
+
+/* Pyramid level to read for a plot width pixels wide: 0 (raw rows) if the
+ * window holds at most 2*width rows, else the finest level with at most
+ * about 2*width entries in the window, limited to the coarsest level. */
+int rs_level(RunStore *s, double t0, double t1, int width);
+
+/* Number of entries of the given level in the window [t0, t1], as read by
+ * rs_read_summary. */
+size_t rs_count_level(RunStore *s, int level, double t0, double t1);
+
+/* Reads the entries of a pyramid level whose samples fall in [t0, t1]: t is
+ * the time of the first sample of each entry, so the first entry may start
+ * before t0. ymin, ymax and ymean are laid out as y in rs_read. Level 0
+ * returns the raw rows in all three. */
+long rs_read_summary(RunStore *s, int level, const int *cols, int ncols,
+		double t0, double t1, double *t, double *ymin, double *ymax,
+		double *ymean, size_t maxrows);
+
+void rs_free(RunStore *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RUNSTORE_H__ */
@@ -0,0 +1,156 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Asynchronous sink for tesim_run(), see teasync.h.
+ *
+ * The buffers form a ring. The simulation thread fills buffer "fill" and
+ * passes it on by incrementing nfull; the writer thread empties buffer
+ * "drain" and releases it by decrementing nfull. Buffer "fill" is free as
+ * long as nfull < nbuf.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "teasync.h"
+#include "tethread.h"
+
+#define TEASYNC_ROW (1 + TE_NY + TE_NU)  /* t, xmeas, xmv */
+
+struct TEAsync {
+	TESink out;
+	int nbuf, rows;
+	double *mem;           /* [nbuf][rows][TEASYNC_ROW] */
+	int *count;            /* samples in each buffer */
+	int fill, drain, nfull;
+	int done, status;
+	te_mutex lock;
+	te_cond cond;
+	te_thread thread;
+};
+
+static TE_THREAD_FN(writer, arg)
+{
+	TEAsync *a = (TEAsync *) arg;
+	const double *row;
+	int i, n, status = 0;
+
+	te_mutex_lock(&a->lock);
+	for (;;) {
+		while (a->nfull == 0 && !a->done)
+			te_cond_wait(&a->cond, &a->lock);
+		if (a->nfull == 0)
+			break;
+		n = a->count[a->drain];
+		row = &a->mem[(size_t) a->drain * a->rows * TEASYNC_ROW];
+		te_mutex_unlock(&a->lock);
+
+		/* After an error the remaining buffers are only released. */
+		for (i = 0; i < n && status == 0; i++, row += TEASYNC_ROW)
+			status = a->out.sample(a->out.ctx, row[0], &row[1], &row[1 + TE_NY]);
+
+		te_mutex_lock(&a->lock);
+		if (status != 0 && a->status == 0)
+			a->status = status;
+		a->drain = (a->drain + 1) % a->nbuf;
+		a->nfull--;
+		te_cond_broadcast(&a->cond);
+	}
+	te_mutex_unlock(&a->lock);
+	return TE_THREAD_RETURN;
+}
+
+/* Passes the current buffer to the writer and waits for a free one. */
+static int teasync_push(TEAsync *a)
+{
+	int status;
+
+	te_mutex_lock(&a->lock);
+	a->nfull++;
+	a->fill = (a->fill + 1) % a->nbuf;
+	te_cond_broadcast(&a->cond);
+	while (a->nfull == a->nbuf)
+		te_cond_wait(&a->cond, &a->lock);
+	status = a->status;
+	te_mutex_unlock(&a->lock);
+	a->count[a->fill] = 0;
+	return status;
+}
+
+static int asyncsample(void *ctx, double t, const double *xmeas, const double *xmv)
+{
+	TEAsync *a = (TEAsync *) ctx;
+	double *row;
+
+	row = &a->mem[((size_t) a->fill * a->rows + a->count[a->fill]) * TEASYNC_ROW];
+	row[0] = t;
+	memcpy(&row[1], xmeas, TE_NY * sizeof(double));
+	memcpy(&row[1 + TE_NY], xmv, TE_NU * sizeof(double));
+	if (++a->count[a->fill] == a->rows)
+		return teasync_push(a);
+	return 0;
+}
+
+int teasync_open(const TESink *out, int nbuf, int rows, TEAsync **out_a)
+{
+	TEAsync *a;
+
+	*out_a = NULL;
+	if (!(a = (TEAsync *) calloc(1, sizeof(*a))))
+		return TEASYNC_ENOMEM;
+	a->out = *out;
+	a->nbuf = nbuf >= 2 ? nbuf : TEASYNC_BUFFERS;
+	a->rows = rows >= 1 ? rows : TEASYNC_ROWS;
+	a->mem = (double *) malloc((size_t) a->nbuf * a->rows * TEASYNC_ROW * sizeof(double));
+	a->count = (int *) calloc(a->nbuf, sizeof(int));
+	if (!a->mem || !a->count) {
+		free(a->mem);
+		free(a->count);
+		free(a);
+		return TEASYNC_ENOMEM;
+	}
+	te_mutex_init(&a->lock);
+	te_cond_init(&a->cond);
+	if (te_thread_create(&a->thread, writer, a) != 0) {
+		te_cond_destroy(&a->cond);
+		te_mutex_destroy(&a->lock);
+		free(a->mem);
+		free(a->count);
+		free(a);
+		return TEASYNC_ETHREAD;
+	}
+	*out_a = a;
+	return TEASYNC_OK;
+}
+
+void teasync_sink(TEAsync *a, TESink *sink)
+{
+	sink->sample = asyncsample;
+	sink->ctx = a;
+}
+
+int teasync_close(TEAsync *a)
+{
+	int status;
+
+	te_mutex_lock(&a->lock);
+	if (a->count[a->fill] > 0)
+		a->nfull++;
+	a->done = 1;
+	te_cond_broadcast(&a->cond);
+	te_mutex_unlock(&a->lock);
+	te_thread_join(a->thread);
+
+	status = a->status;
+	te_cond_destroy(&a->cond);
+	te_mutex_destroy(&a->lock);
+	free(a->mem);
+	free(a->count);
+	free(a);
+	return status;
+}
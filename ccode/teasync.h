@@ -0,0 +1,55 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Asynchronous sink for tesim_run().
+ *
+ * Decouples the simulation from the output files: the simulation thread
+ * copies every sample into one of a fixed set of buffers allocated up
+ * front, and a writer thread hands the full buffers, in order, to the real
+ * sink (MAT-file, run store). When all buffers are waiting to be written
+ * the simulation waits for the writer, so memory use stays bounded. The
+ * simulation thread never allocates and never touches a file.
+ */
+
+#ifndef __TEASYNC_H__
+#define __TEASYNC_H__
+
+#include "tesim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEASYNC_BUFFERS  4      /* default number of buffers */
+#define TEASYNC_ROWS     512    /* default samples per buffer */
+
+/* Status codes */
+#define TEASYNC_OK        0
+#define TEASYNC_ENOMEM   -1
+#define TEASYNC_ETHREAD  -2
+
+typedef struct TEAsync TEAsync;
+
+/* Starts the writer thread in front of out. nbuf (>= 2) buffers of rows
+ * samples each; 0 selects the defaults. */
+int teasync_open(const TESink *out, int nbuf, int rows, TEAsync **a);
+
+/* Sink to pass to tesim_run(). It returns the first non-zero value of the
+ * real sink, typically one buffer after it occurred. */
+void teasync_sink(TEAsync *a, TESink *sink);
+
+/* Writes the remaining samples, stops the thread and frees a. Returns the
+ * first non-zero value returned by the real sink, else 0. */
+int teasync_close(TEAsync *a);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TEASYNC_H__ */
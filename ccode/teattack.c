@@ -0,0 +1,308 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Attack injection for native runs, see teattack.h. */
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "teattack.h"
+#include "teplant.h"
+
+#define TA_LINE 65536
+
+typedef struct {
+	int channel;            /* 0-based */
+	int type, mode, afterend;
+	double value, start, duration;
+	double t0, dt;          /* custom: time of the first sample, sampling */
+	double *signal;
+	size_t n;
+} TAEntry;
+
+struct TEAttackTable {
+	TAEntry *e[2];          /* per art */
+	int n[2];
+};
+
+const char *ta_strerror(int status)
+{
+	switch (status) {
+	case TA_OK:      return "no error";
+	case TA_EIO:     return "cannot read the file";
+	case TA_ESYNTAX: return "syntax error";
+	case TA_ENOMEM:  return "out of memory";
+	case TA_EARG:    return "invalid attack";
+	default:         return "unknown error";
+	}
+}
+
+TEAttackTable *ta_new(void)
+{
+	return (TEAttackTable *) calloc(1, sizeof(TEAttackTable));
+}
+
+void ta_free(TEAttackTable *t)
+{
+	int a, i;
+
+	if (!t)
+		return;
+	for (a = 0; a < 2; a++) {
+		for (i = 0; i < t->n[a]; i++)
+			free(t->e[a][i].signal);
+		free(t->e[a]);
+	}
+	free(t);
+}
+
+int ta_add(TEAttackTable *t, const TEAttack *a)
+{
+	TAEntry *e, *p;
+	int i, art = a->art;
+
+	if ((art != TA_XMEAS && art != TA_XMV) || a->block < 1 ||
+			a->block > (art == TA_XMV ? TE_NU : TE_NY) ||
+			a->type < TA_INTEGRITY || a->type > TA_CUSTOM ||
+			a->mode < TA_NONE || a->mode > TA_PERIODIC ||
+			(a->type == TA_CUSTOM && (a->nsignal == 0 ||
+				a->afterend < TA_EXTRAPOLATE || a->afterend > TA_CYCLIC)))
+		return TA_EARG;
+	for (i = 0; i < t->n[art]; i++)
+		if (t->e[art][i].channel == a->block - 1)
+			break;
+	if (i == t->n[art]) {
+		if (!(p = (TAEntry *) realloc(t->e[art], (i + 1) * sizeof(TAEntry))))
+			return TA_ENOMEM;
+		t->e[art] = p;
+		t->n[art]++;
+	} else
+		free(t->e[art][i].signal);
+	e = &t->e[art][i];
+	memset(e, 0, sizeof(*e));
+	e->channel = a->block - 1;
+	e->type = a->type;
+	e->mode = a->mode;
+	e->value = a->value;
+	e->start = a->start;
+	e->duration = a->duration;
+	if (a->type == TA_CUSTOM) {
+		e->afterend = a->afterend;
+		e->dt = a->sampling > 0. ? a->sampling : TE_TS_BASE;
+		e->t0 = e->dt * ceil(a->start / e->dt);
+		e->n = a->nsignal;
+		if (!(e->signal = (double *) malloc(e->n * sizeof(double)))) {
+			t->n[art]--;
+			return TA_ENOMEM;
+		}
+		memcpy(e->signal, a->signal, e->n * sizeof(double));
+	}
+	return TA_OK;
+}
+
+/* ============================================================================= */
+
+static int attacked(const TAEntry *e, double t)
+{
+	switch (e->mode) {
+	case TA_STEP:
+		return t >= e->start;
+	case TA_INTERVAL:
+		return t >= e->start && t < e->start + e->duration;
+	case TA_PERIODIC:
+		return t >= e->start &&
+			fmod(t - e->start, e->start + e->duration) < e->duration;
+	default:
+		return 0;
+	}
+}
+
+/* Value of a custom signal at t, as a From Workspace block with
+ * interpolation. */
+static double custom(const TAEntry *e, double t)
+{
+	double x = (t - e->t0) / e->dt, span = (double) (e->n - 1);
+	size_t i;
+
+	if (e->n == 1)
+		return x > 0. && e->afterend == TA_ZERO ? 0. : e->signal[0];
+	if (x > span) {
+		switch (e->afterend) {
+		case TA_ZERO:
+			return 0.;
+		case TA_HOLD:
+			return e->signal[e->n - 1];
+		case TA_CYCLIC:
+			x = fmod(x, span);
+			break;
+		default:
+			break;  /* extrapolate from the last two samples */
+		}
+	}
+	if (x < 0.)
+		i = 0;
+	else if ((i = (size_t) x) > e->n - 2)
+		i = e->n - 2;
+	return e->signal[i] + (x - (double) i) * (e->signal[i + 1] - e->signal[i]);
+}
+
+void ta_apply(const TEAttackTable *t, int art, double time, double *v, double *hold)
+{
+	const TAEntry *e = t->e[art], *end = e + t->n[art];
+
+	for (; e < end; e++) {
+		if (attacked(e, time)) {
+			switch (e->type) {
+			case TA_INTEGRITY:
+				v[e->channel] = e->value;
+				break;
+			case TA_DOS:
+				v[e->channel] = hold[e->channel];
+				break;
+			default:
+				v[e->channel] = custom(e, time);
+				break;
+			}
+		}
+		hold[e->channel] = v[e->channel];
+	}
+}
+
+/* ============================================================================= */
+
+/* Table file */
+
+static int keyword(const char *s, const char *const *words, int n)
+{
+	char *end;
+	long v;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		const char *a = s, *b = words[i];
+
+		while (*a && *b && tolower((unsigned char) *a) == *b) {
+			a++;
+			b++;
+		}
+		if (!*a && !*b)
+			return i + 1;
+	}
+	v = strtol(s, &end, 10);
+	return *end == '\0' && v >= 1 && v <= n ? (int) v : 0;
+}
+
+static int number(const char *s, double *v)
+{
+	char *end;
+
+	if (!s)
+		return 0;
+	*v = strtod(s, &end);
+	return end != s && *end == '\0';
+}
+
+static int parse(char *s, TEAttackTable *t, double **buf, size_t *cap)
+{
+	static const char *const arts[] = {"xmeas", "xmv"};
+	static const char *const types[] = {"integrity", "dos", "custom"};
+	static const char *const modes[] = {"none", "step", "interval", "periodic"};
+	static const char *const afterends[] = {"extrapolation", "zero", "hold", "cyclic"};
+	static const char *const sep = " \t\r\n";
+	TEAttack a;
+	char *tok[7];
+	double block, *p;
+	int i;
+
+	for (i = 0; i < 7; i++)
+		if (!(tok[i] = strtok(i == 0 ? s : NULL, sep)))
+			return i == 0 ? TA_OK : TA_ESYNTAX;   /* blank line */
+	memset(&a, 0, sizeof(a));
+	if (!(a.art = keyword(tok[0], arts, 2)) || !number(tok[1], &block) ||
+			!(a.type = keyword(tok[2], types, 3)) ||
+			!(a.mode = keyword(tok[3], modes, 4)) || !number(tok[4], &a.value) ||
+			!number(tok[5], &a.start) || !number(tok[6], &a.duration))
+		return TA_ESYNTAX;
+	a.art--;
+	a.block = (int) block;
+	if (a.type == TA_CUSTOM) {
+		if (!number(strtok(NULL, sep), &a.sampling) ||
+				!(tok[0] = strtok(NULL, sep)) ||
+				!(a.afterend = keyword(tok[0], afterends, 4)))
+			return TA_ESYNTAX;
+		while ((tok[0] = strtok(NULL, sep))) {
+			if (a.nsignal == *cap) {
+				*cap = *cap ? 2 * *cap : 256;
+				if (!(p = (double *) realloc(*buf, *cap * sizeof(double))))
+					return TA_ENOMEM;
+				*buf = p;
+			}
+			if (!number(tok[0], &(*buf)[a.nsignal++]))
+				return TA_ESYNTAX;
+		}
+		a.signal = *buf;
+	} else if (strtok(NULL, sep))
+		return TA_ESYNTAX;
+	return ta_add(t, &a) == TA_EARG ? TA_ESYNTAX : TA_OK;
+}
+
+int ta_parse(char *s, TEAttackTable *t)
+{
+	double *buf = NULL;
+	size_t cap = 0;
+	char *c;
+	int status;
+
+	if ((c = strchr(s, '#')))
+		*c = '\0';
+	status = parse(s, t, &buf, &cap);
+	free(buf);
+	return status;
+}
+
+int ta_load(const char *path, TEAttackTable **out, int *line)
+{
+	TEAttackTable *t;
+	FILE *fp;
+	char *s, *c;
+	double *buf = NULL;
+	size_t cap = 0;
+	int status = TA_OK;
+
+	*out = NULL;
+	*line = 0;
+	if (!(fp = fopen(path, "r")))
+		return TA_EIO;
+	s = (char *) malloc(TA_LINE);
+	if (!s || !(t = ta_new())) {
+		free(s);
+		fclose(fp);
+		return TA_ENOMEM;
+	}
+	while (status == TA_OK && fgets(s, TA_LINE, fp)) {
+		++*line;
+		if ((c = strchr(s, '#')))
+			*c = '\0';
+		status = parse(s, t, &buf, &cap);
+	}
+	if (status == TA_OK && ferror(fp))
+		status = TA_EIO;
+	free(buf);
+	free(s);
+	fclose(fp);
+	if (status != TA_OK) {
+		ta_free(t);
+		return status;
+	}
+	*line = 0;
+	*out = t;
+	return TA_OK;
+}
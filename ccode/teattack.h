@@ -0,0 +1,118 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Attack injection for native runs.
+ *
+ * Same semantics as the Attack Controller blocks of TElib.mdl, configured
+ * from MATLAB through AttackController (model/objects):
+ *
+ *   type  INTEGRITY  the channel reads Value
+ *         DOS        the channel keeps its last output (Memory block)
+ *         CUSTOM     the channel follows Signal, sampled every Sampling
+ *                    hours from Start rounded up to a multiple of Sampling,
+ *                    linearly interpolated; after the last sample as set by
+ *                    OutputType (extrapolate, zero, hold, cyclic)
+ *   mode  NONE       never attacked
+ *         STEP       attacked from Start on
+ *         INTERVAL   attacked for Start <= t < Start + Duration
+ *         PERIODIC   pulse of width Duration, period Start + Duration,
+ *                    first pulse at Start
+ *
+ * Only attacked channels are in the table, so an attack costs nothing on
+ * the other channels. xmv attacks act on the plant input, xmeas attacks on
+ * the measurements handed on by the driver; the plant's own pv.xmeas is
+ * left alone, as in the model where the attack blocks sit outside tefunc.
+ *
+ * A table is read-only during a run and may be shared by concurrent runs;
+ * the DOS memory belongs to the run (ta_apply's hold argument).
+ *
+ * Table file, one attack per line, '#' starts a comment, times in hours:
+ *   xmv|xmeas block type mode value start duration [sampling afterend v1 v2 ...]
+ * with type integrity|dos|custom, mode none|step|interval|periodic and
+ * afterend extrapolation|zero|hold|cyclic; the numeric values of AttackType,
+ * AttackMode are accepted too. Sampling <= 0 means Ts_base, as -1 in the
+ * block mask.
+ */
+
+#ifndef __TEATTACK_H__
+#define __TEATTACK_H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TA_XMEAS        0
+#define TA_XMV          1
+
+/* AttackType values */
+#define TA_INTEGRITY    1
+#define TA_DOS          2
+#define TA_CUSTOM       3
+
+/* AttackMode values */
+#define TA_NONE         1
+#define TA_STEP         2
+#define TA_INTERVAL     3
+#define TA_PERIODIC     4
+
+/* Output after the last sample of a custom signal */
+#define TA_EXTRAPOLATE  1
+#define TA_ZERO         2
+#define TA_HOLD         3
+#define TA_CYCLIC       4
+
+/* Status codes */
+#define TA_OK        0
+#define TA_EIO      -1
+#define TA_ESYNTAX  -2
+#define TA_ENOMEM   -3
+#define TA_EARG     -4
+
+typedef struct {
+	int art;                /* TA_XMEAS or TA_XMV */
+	int block;              /* channel, 1-based */
+	int type, mode;
+	double value;           /* INTEGRITY */
+	double start, duration; /* hours */
+	double sampling;        /* CUSTOM, hours; <= 0 for Ts_base */
+	int afterend;           /* CUSTOM */
+	const double *signal;   /* CUSTOM samples, copied by ta_add() */
+	size_t nsignal;
+} TEAttack;
+
+typedef struct TEAttackTable TEAttackTable;
+
+const char *ta_strerror(int status);
+
+TEAttackTable *ta_new(void);
+
+/* Adds an attack; a later attack on the same channel replaces it. */
+int ta_add(TEAttackTable *t, const TEAttack *a);
+
+/* Adds the attack of one table line, which the call modifies; a blank or
+ * comment-only line adds nothing. */
+int ta_parse(char *s, TEAttackTable *t);
+
+/* Reads a table file; on TA_ESYNTAX *line is the offending line. */
+int ta_load(const char *path, TEAttackTable **out, int *line);
+
+/* Applies the attacks of art (TA_XMEAS or TA_XMV) at time t to v in place.
+ * hold (TE_NY or TE_NU values, zero at the start of a run) keeps each
+ * attacked channel's last output for DOS. Call once per major step. */
+void ta_apply(const TEAttackTable *t, int art, double time, double *v, double *hold);
+
+void ta_free(TEAttackTable *t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TEATTACK_H__ */
@@ -0,0 +1,410 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Headless batch run of the TE plant.
+ *
+ *   tebatch [-t hours] [-d idv[,idv...]] [-s seed] [-a attacks] [-C control]
+ *           [-e model|fused] [-T timing] [-L trace [-l level]] [-M model]
+ *           [-D detectors] [-p ring]
+ *           [-r speed [-c cpu] [-f priority] [-m metrics]] [-o file.mat]
+ *
+ * Runs the open-loop plant with constant xmv for the given time (default 72
+ * h) with the listed disturbances switched on and writes tout, simout and
+ * xmv to a MAT-file (default tebatch.mat) as the Simulink model saves them,
+ * so that TEplot and extractData read it with load. A file name not ending
+ * in ".mat" gets a run store (runstore.h) instead. -C closes the loop with
+ * the multiloop controller of a configuration file (temloop.h), e.g.
+ * data/Mode1Control.txt, starting from its plant states. -e fused
+ * evaluates the plant once per step instead of twice as the model does
+ * (tesim.h). -T writes the time spent per part of the loop to a file ("-"
+ * for stdout). -L traces the run (tetrace.h) up to level (error, warn,
+ * info or debug, default info) and saves the trace to a file at the end,
+ * for tetrfmt. -a injects the attacks
+ * of a table file (teattack.h); xmv is logged as applied to the plant. -M
+ * runs a PCA monitor (tepca.h) on the samples and reports its first T^2
+ * and SPE alarms, raised after TEBATCH_PERSIST samples over the limit. -D
+ * runs the CUSUM/EWMA/Shewhart bank (tedetect.h) with the channel
+ * parameters of the given file, printing its alarm events as they are
+ * raised and its first alarms at the end.
+ *
+ * The files are written by a separate thread (teasync.h). With -p every
+ * step is also published to the telemetry ring of that name (tetelem.h).
+ *
+ * -r runs in real time times speed (terealtime.h), optionally pinned to a
+ * CPU (-c) and under SCHED_FIFO with the given priority (-f, 0 for the
+ * lowest). The pacing metrics go to the file given by -m ("-" for stdout)
+ * at the end of the run.
+ *
+ * Build: cc -O2 -o tebatch tebatch.c tesim.c teplant.c temloop.c teattack.c
+ *        tepca.c tedetect.c teasync.c matwriter.c runstore.c tetelem.c
+ *        terealtime.c tetrace.c -lm -lpthread -lrt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matwriter.h"
+#include "runstore.h"
+#include "teasync.h"
+#include "tedetect.h"
+#include "tepca.h"
+#include "tesim.h"
+
+#define TEBATCH_PERSIST 3
+
+typedef struct {
+	MatVar *tout, *simout, *xmv;
+	int status;
+} MatSink;
+
+static int matsample(void *ctx, double t, const double *xmeas, const double *xmv)
+{
+	MatSink *m = (MatSink *) ctx;
+
+	if ((m->status = mat_append(m->tout, &t)) != MAT_OK ||
+			(m->status = mat_append(m->simout, xmeas)) != MAT_OK ||
+			(m->status = mat_append(m->xmv, xmv)) != MAT_OK)
+		return 1;
+	return 0;
+}
+
+typedef struct {
+	RunStoreWriter *w;
+	int status;
+} StoreSink;
+
+static int storesample(void *ctx, double t, const double *xmeas, const double *xmv)
+{
+	StoreSink *r = (StoreSink *) ctx;
+	double row[RS_TE_COLUMNS];
+
+	memcpy(&row[RS_XMEAS_COLUMN - 1], xmeas, TE_NY * sizeof(double));
+	memcpy(&row[RS_XMV_COLUMN - 1], xmv, TE_NU * sizeof(double));
+	return (r->status = rs_append(r->w, t, row)) != RS_OK;
+}
+
+/* Both monitors, for TESimConfig.monitor. */
+static int bothsample(void *ctx, double t, const double *xmeas, const double *xmv)
+{
+	const TESink *s = (const TESink *) ctx;
+	int status;
+
+	if ((status = s[0].sample(s[0].ctx, t, xmeas, xmv)) != 0)
+		return status;
+	return s[1].sample(s[1].ctx, t, xmeas, xmv);
+}
+
+static void putevent(void *ctx, const TDEvent *ev)
+{
+	static const char *names[] = {"", "CUSUM", "EWMA", "", "Shewhart"};
+
+	(void) ctx;
+	fprintf(stderr, "tebatch: t = %g h: %s%c alarm on xmeas %d (%g)\n", ev->t,
+			names[ev->detector], ev->sign > 0 ? '+' : '-', ev->channel, ev->stat);
+}
+
+static int ismat(const char *name)
+{
+	size_t n = strlen(name);
+
+	return n >= 4 && strcmp(name + n - 4, ".mat") == 0;
+}
+
+static int putmetrics(TERealtime *rt, const char *name)
+{
+	TERTMetrics m;
+	FILE *fp;
+	char *buf;
+	int n;
+
+	tert_metrics(rt, &m);
+	n = tert_format(&m, NULL, 0);
+	if (n < 0 || !(buf = (char *) malloc(n + 1)))
+		return -1;
+	tert_format(&m, buf, n + 1);
+	fp = strcmp(name, "-") == 0 ? stdout : fopen(name, "w");
+	if (fp) {
+		fputs(buf, fp);
+		if (fp != stdout)
+			fclose(fp);
+	}
+	free(buf);
+	return fp ? 0 : -1;
+}
+
+static int puttiming(const TESimTiming *tm, const char *name)
+{
+	const char *parts[] = {"plant", "control", "attack", "io", "pacing", "total"};
+	double s[6];
+	FILE *fp;
+	int i;
+
+	s[0] = tm->plant;
+	s[1] = tm->control;
+	s[2] = tm->attack;
+	s[3] = tm->io;
+	s[4] = tm->pacing;
+	s[5] = s[0] + s[1] + s[2] + s[3] + s[4];
+	if (!(fp = strcmp(name, "-") == 0 ? stdout : fopen(name, "w")))
+		return -1;
+	fprintf(fp, "# %ld steps\n# part      seconds   us/step   share\n", tm->steps);
+	for (i = 0; i < 6; i++)
+		fprintf(fp, "%-8s %9.4f %9.3f %7.1f%%\n", parts[i], s[i],
+				tm->steps > 0 ? s[i] * 1e6 / (double) tm->steps : 0.,
+				s[5] > 0. ? 100. * s[i] / s[5] : 0.);
+	if (fp != stdout)
+		fclose(fp);
+	return 0;
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "Usage: tebatch [-t hours] [-d idv[,idv...]] [-s seed] [-a attacks]\n"
+			"               [-C control] [-e model|fused] [-T timing]\n"
+			"               [-L trace [-l level]] [-M model] [-D detectors] [-p ring]\n"
+			"               [-r speed [-c cpu] [-f priority] [-m metrics]] [-o file.mat]\n");
+	exit(2);
+}
+
+/* Switches on the disturbances listed in s, e.g. "1,6". */
+static void parseidv(const char *s, double *idv)
+{
+	char *end;
+	long i;
+
+	for (;;) {
+		i = strtol(s, &end, 10);
+		if (end == s || i < 1 || i > TE_NIDV)
+			usage();
+		idv[i - 1] = 1.;
+		if (*end == '\0')
+			return;
+		if (*end != ',')
+			usage();
+		s = end + 1;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	TESimConfig cfg;
+	TERTConfig rtcfg;
+	TESimResult res;
+	TESimTiming timing;
+	TESink sink, out, monitor, monitors[2];
+	TEAsync *a;
+	TEAttackTable *attack = NULL;
+	TPModel *model = NULL;
+	TPMonitor *mon = NULL;
+	TDConfig tdcfg;
+	TDBank *bank = NULL;
+	TMLConfig tmlcfg;
+	MatSink m;
+	StoreSink r;
+	MatFile *f = NULL;
+	double idv[TE_NIDV];
+	const char *name = "tebatch.mat", *ring = NULL, *metrics = NULL, *err = NULL;
+	const char *table = NULL, *pca = NULL, *detect = NULL, *control = NULL;
+	const char *timed = NULL, *traced = NULL;
+	TTRBuffer *trace = NULL;
+	int level = TTR_INFO;
+	size_t rows;
+	int i, status;
+
+	memset(&cfg, 0, sizeof(cfg));
+	memset(idv, 0, sizeof(idv));
+	memset(&rtcfg, 0, sizeof(rtcfg));
+	rtcfg.cpu = -1;
+	cfg.tstop = 72.;
+	cfg.idv = idv;
+	for (i = 1; i < argc; i++) {
+		if (argv[i][0] != '-' || argv[i][2] != '\0' || i + 1 == argc)
+			usage();
+		switch (argv[i][1]) {
+		case 't': cfg.tstop = atof(argv[++i]); break;
+		case 'd': parseidv(argv[++i], idv); break;
+		case 's': cfg.seed = atof(argv[++i]); break;
+		case 'a': table = argv[++i]; break;
+		case 'C': control = argv[++i]; break;
+		case 'e':
+			if (strcmp(argv[++i], "fused") == 0)
+				cfg.fused = 1;
+			else if (strcmp(argv[i], "model") != 0)
+				usage();
+			break;
+		case 'T': timed = argv[++i]; cfg.timing = &timing; break;
+		case 'L': traced = argv[++i]; break;
+		case 'l':
+			if ((level = ttr_level(argv[++i])) < 0)
+				usage();
+			break;
+		case 'M': pca = argv[++i]; break;
+		case 'D': detect = argv[++i]; break;
+		case 'p': ring = argv[++i]; break;
+		case 'r': rtcfg.speed = atof(argv[++i]); break;
+		case 'c': rtcfg.cpu = atoi(argv[++i]); break;
+		case 'f': rtcfg.fifo = 1; rtcfg.priority = atoi(argv[++i]); break;
+		case 'm': metrics = argv[++i]; break;
+		case 'o': name = argv[++i]; break;
+		default:  usage();
+		}
+	}
+
+	rows = tesim_samples(&cfg);
+	if (rows == 0)
+		usage();
+	if (table && (status = ta_load(table, &attack, &i)) != TA_OK) {
+		if (status == TA_ESYNTAX)
+			fprintf(stderr, "tebatch: %s:%d: %s\n", table, i, ta_strerror(status));
+		else
+			fprintf(stderr, "tebatch: %s: %s\n", table, ta_strerror(status));
+		return 1;
+	}
+	cfg.attack = attack;
+	if (traced) {
+		if ((status = ttr_open(0, level, &trace)) != TTR_OK) {
+			fprintf(stderr, "tebatch: %s: %s\n", traced, ttr_strerror(status));
+			return 1;
+		}
+		cfg.trace = trace;
+	}
+	if (control) {
+		tml_defaults(&tmlcfg);
+		if ((status = tml_load(control, &tmlcfg, &i)) != TML_OK) {
+			if (status == TML_ESYNTAX)
+				fprintf(stderr, "tebatch: %s:%d: %s\n", control, i, tml_strerror(status));
+			else
+				fprintf(stderr, "tebatch: %s: %s\n", control, tml_strerror(status));
+			return 1;
+		}
+		cfg.control = &tmlcfg;
+	}
+	if (pca) {
+		if ((status = tp_load(pca, &model)) != TP_OK ||
+				(status = tp_open(model, TEBATCH_PERSIST, &mon)) != TP_OK) {
+			fprintf(stderr, "tebatch: %s: %s\n", pca, tp_strerror(status));
+			return 1;
+		}
+		tp_sink(mon, &monitors[0]);
+		cfg.monitor = &monitors[0];
+	}
+	if (detect) {
+		td_defaults(&tdcfg);
+		tdcfg.reset = TD_RESET;
+		tdcfg.event = putevent;
+		if ((status = td_load(detect, &tdcfg, &i)) != TD_OK ||
+				(status = td_open(&tdcfg, &bank)) != TD_OK) {
+			if (status == TD_ESYNTAX)
+				fprintf(stderr, "tebatch: %s:%d: %s\n", detect, i, td_strerror(status));
+			else
+				fprintf(stderr, "tebatch: %s: %s\n", detect, td_strerror(status));
+			return 1;
+		}
+		td_sink(bank, &monitors[1]);
+		if (mon) {
+			monitor.sample = bothsample;
+			monitor.ctx = monitors;
+			cfg.monitor = &monitor;
+		} else
+			cfg.monitor = &monitors[1];
+	}
+	if (ring && (status = tl_create(ring, 0, &cfg.telemetry)) != TL_OK) {
+		fprintf(stderr, "tebatch: %s: %s\n", ring, tl_strerror(status));
+		return 1;
+	}
+	m.status = MAT_OK;
+	r.status = RS_OK;
+	if (ismat(name)) {
+		if ((status = mat_create(name, &f)) != MAT_OK ||
+				(status = mat_begin(f, "tout", 1, rows, &m.tout)) != MAT_OK ||
+				(status = mat_begin(f, "simout", TE_NY, rows, &m.simout)) != MAT_OK ||
+				(status = mat_begin(f, "xmv", TE_NU, rows, &m.xmv)) != MAT_OK) {
+			fprintf(stderr, "tebatch: %s: %s\n", name, mat_strerror(status));
+			return 1;
+		}
+		out.sample = matsample;
+		out.ctx = &m;
+	} else {
+		if ((status = rs_create(name, RS_TE_COLUMNS, 0, &r.w)) != RS_OK) {
+			fprintf(stderr, "tebatch: %s: %s\n", name, rs_strerror(status));
+			return 1;
+		}
+		out.sample = storesample;
+		out.ctx = &r;
+	}
+	if ((status = teasync_open(&out, 0, 0, &a)) != TEASYNC_OK) {
+		fprintf(stderr, "tebatch: cannot start the writer thread\n");
+		return 1;
+	}
+	teasync_sink(a, &sink);
+	if (rtcfg.speed > 0.) {
+		if (tert_open(&rtcfg, cfg.ts_base > 0. ? cfg.ts_base : TE_TS_BASE,
+				&cfg.realtime) != TERT_OK)
+			usage();
+		if (rtcfg.cpu >= 0 && !(tert_flags(cfg.realtime) & TERT_PINNED))
+			fprintf(stderr, "tebatch: cannot pin to CPU %d\n", rtcfg.cpu);
+		if (rtcfg.fifo && !(tert_flags(cfg.realtime) & TERT_FIFO))
+			fprintf(stderr, "tebatch: no real-time priority, running without\n");
+	}
+	status = tesim_run(&cfg, &sink, &res);
+	if (cfg.realtime) {
+		if (metrics && putmetrics(cfg.realtime, metrics) != 0)
+			fprintf(stderr, "tebatch: cannot write %s\n", metrics);
+		tert_close(cfg.realtime);
+	}
+	if (timed && puttiming(&timing, timed) != 0)
+		fprintf(stderr, "tebatch: cannot write %s\n", timed);
+	if (trace) {
+		if ((i = ttr_save(trace, traced)) != TTR_OK)
+			fprintf(stderr, "tebatch: %s: %s\n", traced, ttr_strerror(i));
+		ttr_close(trace);
+	}
+	teasync_close(a);
+	tl_destroy(cfg.telemetry);
+	ta_free(attack);
+	if (mon) {
+		if (tp_alarm(mon, TP_T2) >= 0.)
+			fprintf(stderr, "tebatch: first T^2 alarm at t = %g h\n", tp_alarm(mon, TP_T2));
+		if (tp_alarm(mon, TP_SPE) >= 0.)
+			fprintf(stderr, "tebatch: first SPE alarm at t = %g h\n", tp_alarm(mon, TP_SPE));
+		tp_close(mon);
+		tp_model_free(model);
+	}
+	if (bank) {
+		static const int which[] = {TD_CUSUM, TD_EWMA, TD_SHEWHART};
+		static const char *names[] = {"CUSUM", "EWMA", "Shewhart"};
+		double t;
+		int c;
+
+		for (i = 0; i < 3; i++)
+			if ((t = td_alarm(bank, which[i], &c)) >= 0.)
+				fprintf(stderr, "tebatch: first %s alarm at t = %g h (xmeas %d)\n",
+						names[i], t, c);
+		td_close(bank);
+	}
+
+	if (f) {
+		if (m.status != MAT_OK)
+			err = mat_strerror(m.status);
+		if ((i = mat_close(f)) != MAT_OK && !err)
+			err = mat_strerror(i);
+	} else {
+		if (r.status != RS_OK)
+			err = rs_strerror(r.status);
+		if ((i = rs_close(r.w)) != RS_OK && !err)
+			err = rs_strerror(i);
+	}
+	if (err) {
+		fprintf(stderr, "tebatch: %s: %s\n", name, err);
+		return 1;
+	}
+	if (res.isd != 0)
+		fprintf(stderr, "tebatch: %s (t = %g h)\n", res.msg, res.t);
+	return status == TESIM_OK ? 0 : 1;
+}
@@ -0,0 +1,610 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Benchmarks of the native plant.
+ *
+ *   tebench [-b name[,name...]] [-r reps] [-m ms] [-R reps] [-C control]
+ *           [-e model|fused] [-n runs] [-u hours] [-j threads] [-o results]
+ *
+ * Microbenchmarks time the plant routines on the plant as it runs open
+ * loop at t = 1 h:
+ *
+ *   tefunc    one evaluation of the plant (outputs and derivatives)
+ *   tesub1    enthalpy of a stream (tesub1_ of the feed stream)
+ *   tesub2    temperature from enthalpy by Newton's method (reactor liquid,
+ *             from a guess 0.01 degC off, as between two steps)
+ *   tesub3    derivative of the enthalpy in the temperature
+ *   tesub4    liquid density (reactor)
+ *   tesub6    one measurement noise draw (sum of 12 tesub7 draws), not
+ *             with -DTE_NOISE=0
+ *   tesub7    one draw of the noise generator
+ *   tesub8    the twelve random walks at t
+ *
+ * A repetition calls the routine as often as takes about ms milliseconds
+ * (default 20), found once beforehand; reps repetitions (default 15) are
+ * timed after a warm-up. End-to-end benchmarks time whole runs (tesim.h),
+ * reps times each (-R, default 3):
+ *
+ *   open72    72 h open loop with the initial valves; the plant shuts down
+ *             at about 3.5 h (high reactor pressure), the steps taken count
+ *   closed72  72 h closed loop with the multiloop controller of -C (default
+ *             the tml_defaults() tunings from the default plant states)
+ *   ensemble  runs closed-loop runs of hours each (default 1000 runs of 1
+ *             h) with the seeds 1..runs on threads threads (default all
+ *             CPUs)
+ *
+ * -e fused times the end-to-end runs with one plant evaluation per step.
+ * Without -b all benchmarks run.
+ *
+ * Every benchmark gives the median and the median absolute deviation of
+ * its repetitions in ns per call (micro) or per plant step (end-to-end),
+ * and its instructions per cycle where the hardware counters can be read
+ * (Linux perf events, which perf_event_paranoid may forbid; "-" otherwise).
+ * The results are printed and, with -o, written to a file with one line per
+ * benchmark:
+ *
+ *   name calls reps median_ns mad_ns ipc seconds
+ *
+ * with calls the calls or steps per repetition, seconds the median time
+ * of a repetition and ipc -1 where not measured; lines starting with '#'
+ * are comments.
+ *
+ * teplant.c is compiled in here so that its routines can be called.
+ *
+ * Build: cc -O2 -o tebench tebench.c tesim.c temloop.c teattack.c
+ *        terealtime.c tetelem.c tetrace.c -lm -lpthread -lrt
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE     /* syscall */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tesim.h"
+#include "tethread.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "teplant.c"
+
+#define TEBENCH_MAX_REPS     1000
+#define TEBENCH_MAX_THREADS  256
+
+typedef struct {
+	const char *name;
+	double median, mad;     /* ns per call or step */
+	double ipc;             /* -1 if not measured */
+	double seconds;         /* median of a repetition */
+	long calls;             /* per repetition */
+	int reps;
+} TBResult;
+
+/* Keeps the results of the microbenchmarks alive. */
+static volatile double tb_sink;
+
+/* ============================================================================= */
+/* Hardware counters */
+
+typedef struct {
+	int fd[2];              /* instructions, cycles; -1 if not available */
+	long long start[2];
+} TBCounters;
+
+#if defined(__linux__)
+static int tb_open(unsigned long long config)
+{
+	struct perf_event_attr a;
+
+	memset(&a, 0, sizeof(a));
+	a.type = PERF_TYPE_HARDWARE;
+	a.size = sizeof(a);
+	a.config = config;
+	a.exclude_kernel = 1;
+	a.exclude_hv = 1;
+	a.inherit = 1;          /* threads started later, for the ensemble */
+	return (int) syscall(__NR_perf_event_open, &a, 0, -1, -1, 0);
+}
+
+static long long tb_read(int fd)
+{
+	long long v;
+
+	return read(fd, &v, sizeof(v)) == (ssize_t) sizeof(v) ? v : -1;
+}
+
+static void tb_counters(TBCounters *c)
+{
+	c->fd[0] = tb_open(PERF_COUNT_HW_INSTRUCTIONS);
+	c->fd[1] = c->fd[0] >= 0 ? tb_open(PERF_COUNT_HW_CPU_CYCLES) : -1;
+	if (c->fd[1] < 0 && c->fd[0] >= 0) {
+		close(c->fd[0]);
+		c->fd[0] = -1;
+	}
+}
+
+static void tb_start(TBCounters *c)
+{
+	if (c->fd[0] >= 0) {
+		c->start[0] = tb_read(c->fd[0]);
+		c->start[1] = tb_read(c->fd[1]);
+	}
+}
+
+/* Instructions per cycle since tb_start(), or -1. */
+static double tb_ipc(const TBCounters *c)
+{
+	long long n, cycles;
+
+	if (c->fd[0] < 0 || c->start[0] < 0 || c->start[1] < 0)
+		return -1.;
+	n = tb_read(c->fd[0]) - c->start[0];
+	cycles = tb_read(c->fd[1]) - c->start[1];
+	return cycles > 0 && n >= 0 ? (double) n / (double) cycles : -1.;
+}
+
+static void tb_close(TBCounters *c)
+{
+	if (c->fd[0] >= 0) {
+		close(c->fd[0]);
+		close(c->fd[1]);
+	}
+}
+#else
+static void tb_counters(TBCounters *c)
+{
+	c->fd[0] = c->fd[1] = -1;
+}
+
+static void tb_start(TBCounters *c)
+{
+	(void) c;
+}
+
+static double tb_ipc(const TBCounters *c)
+{
+	(void) c;
+	return -1.;
+}
+
+static void tb_close(TBCounters *c)
+{
+	(void) c;
+}
+#endif
+
+/* ============================================================================= */
+/* Statistics */
+
+static int tb_cmp(const void *a, const void *b)
+{
+	double x = *(const double *) a, y = *(const double *) b;
+
+	return x < y ? -1 : x > y;
+}
+
+/* Median of v[0..n-1], which the call sorts. */
+static double tb_median(double *v, int n)
+{
+	qsort(v, n, sizeof(double), tb_cmp);
+	return n % 2 ? v[n / 2] : .5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+/* Fills r from the times s of r->reps repetitions of r->calls calls each
+ * and their instructions per cycle (-1 where not measured). */
+static void tb_summary(TBResult *r, const double *s, const double *ipc)
+{
+	double v[TEBENCH_MAX_REPS];
+	int i, n = 0;
+
+	for (i = 0; i < r->reps; i++)
+		v[i] = s[i];
+	r->seconds = tb_median(v, r->reps);
+	r->median = r->seconds * 1e9 / (double) r->calls;
+	for (i = 0; i < r->reps; i++)
+		v[i] = fabs(s[i] * 1e9 / (double) r->calls - r->median);
+	r->mad = tb_median(v, r->reps);
+	for (i = 0; i < r->reps; i++)
+		if (ipc[i] >= 0.)
+			v[n++] = ipc[i];
+	r->ipc = n > 0 ? tb_median(v, n) : -1.;
+}
+
+/* ============================================================================= */
+/* Microbenchmarks */
+
+typedef void (*TBMicro)(TEPlant *te, long n);
+
+static void m_tefunc(TEPlant *te, long n)
+{
+	double dx[TE_NX];
+
+	while (n-- > 0)
+		tefunc(te, &c__50, &te->t, te->x, dx);
+	tb_sink = dx[0];
+}
+
+static void m_tesub1(TEPlant *te, long n)
+{
+	while (n-- > 0)
+		tesub1_(te, te->teproc.xst, te->teproc.tst, te->teproc.hst, &c__1);
+	tb_sink = te->teproc.hst[0];
+}
+
+static void m_tesub2(TEPlant *te, long n)
+{
+	double t0 = te->teproc.tcr - .01, t;
+
+	while (n-- > 0) {
+		t = t0;
+		tesub2_(te, te->teproc.xlr, &t, &te->teproc.esr, &c__0);
+	}
+	tb_sink = t;
+}
+
+static void m_tesub3(TEPlant *te, long n)
+{
+	double dh = 0.;
+
+	while (n-- > 0)
+		tesub3_(te, te->teproc.xlr, &te->teproc.tcr, &dh, &c__0);
+	tb_sink = dh;
+}
+
+static void m_tesub4(TEPlant *te, long n)
+{
+	double r = 0.;
+
+	while (n-- > 0)
+		tesub4_(te, te->teproc.xlr, &te->teproc.tcr, &r);
+	tb_sink = r;
+}
+
+#if TE_NOISE
+static void m_tesub6(TEPlant *te, long n)
+{
+	double std = 1., x = 0.;
+
+	while (n-- > 0)
+		tesub6_(te, &std, &x);
+	tb_sink = x;
+}
+#endif
+
+static void m_tesub7(TEPlant *te, long n)
+{
+	integer i = -1;
+	double x = 0.;
+
+	while (n-- > 0)
+		x += tesub7_(te, &i);
+	tb_sink = x;
+}
+
+static void m_tesub8(TEPlant *te, long n)
+{
+	integer i;
+	double x = 0.;
+
+	while (n-- > 0)
+		for (i = 1; i <= 12; i++)
+			x += tesub8_(te, &i, &te->t);
+	tb_sink = x;
+}
+
+static const struct {
+	const char *name;
+	TBMicro fn;
+} tb_micro[] = {
+	{"tefunc", m_tefunc}, {"tesub1", m_tesub1}, {"tesub2", m_tesub2},
+	{"tesub3", m_tesub3}, {"tesub4", m_tesub4},
+#if TE_NOISE
+	{"tesub6", m_tesub6},
+#endif
+	{"tesub7", m_tesub7}, {"tesub8", m_tesub8}
+};
+
+#define TB_NMICRO ((int) (sizeof(tb_micro) / sizeof(tb_micro[0])))
+
+/* The open-loop plant at t = 1 h. */
+static void tb_plant(TEPlant *te)
+{
+	long k;
+
+	te_init(te, NULL);
+	te_setxmv(te, &te->x[38]);
+	for (k = 0; k < 2000; k++) {
+		te->t = k * TE_TS_BASE;
+		te_outputs(te);
+		te_step(te, TE_TS_BASE);
+	}
+	te->t = k * TE_TS_BASE;
+	te_outputs(te);
+}
+
+static void micro(int m, const TEPlant *te0, int reps, double ms, TBCounters *c,
+		TBResult *r)
+{
+	TEPlant te = *te0;
+	double s[TEBENCH_MAX_REPS], ipc[TEBENCH_MAX_REPS], t;
+	long n = 1;
+	int i;
+
+	/* Calls per repetition, doubled until they take ms. */
+	for (;;) {
+		t = tert_clock();
+		tb_micro[m].fn(&te, n);
+		t = tert_clock() - t;
+		if (t * 1e3 >= ms || n >= 1L << 40)
+			break;
+		n *= t * 1e3 < ms / 16. ? 8 : 2;
+	}
+	for (i = 0; i < reps; i++) {
+		te = *te0;
+		tb_start(c);
+		t = tert_clock();
+		tb_micro[m].fn(&te, n);
+		s[i] = tert_clock() - t;
+		ipc[i] = tb_ipc(c);
+	}
+	r->name = tb_micro[m].name;
+	r->calls = n;
+	r->reps = reps;
+	tb_summary(r, s, ipc);
+}
+
+/* ============================================================================= */
+/* End-to-end benchmarks */
+
+typedef struct {
+	const TESimConfig *sim;
+	long runs;
+	te_mutex lock;
+	long next;              /* next run */
+	long steps;             /* steps taken by all runs */
+	int status;
+} TBEnsemble;
+
+static long tb_steps(const TESimConfig *sim, const TESimResult *res)
+{
+	double h = sim->ts_base > 0. ? sim->ts_base : TE_TS_BASE;
+
+	return (long) floor(res->t / h + .5) + 1;
+}
+
+static TE_THREAD_FN(tb_worker, arg)
+{
+	TBEnsemble *e = (TBEnsemble *) arg;
+	TESimConfig sim = *e->sim;
+	TESimResult res;
+	long i, steps = 0;
+	int status = TESIM_OK;
+
+	for (;;) {
+		te_mutex_lock(&e->lock);
+		i = e->next++;
+		te_mutex_unlock(&e->lock);
+		if (i >= e->runs)
+			break;
+		sim.seed = (double) (i + 1);
+		if ((status = tesim_run(&sim, NULL, &res)) != TESIM_OK)
+			break;
+		steps += tb_steps(&sim, &res);
+	}
+	te_mutex_lock(&e->lock);
+	e->steps += steps;
+	if (status != TESIM_OK)
+		e->status = status;
+	te_mutex_unlock(&e->lock);
+	return TE_THREAD_RETURN;
+}
+
+/* Runs sim runs times on nthreads threads; returns the steps taken or -1. */
+static long ensemble(const TESimConfig *sim, long runs, int nthreads)
+{
+	te_thread t[TEBENCH_MAX_THREADS];
+	TBEnsemble e;
+	int i, n = 0;
+
+	e.sim = sim;
+	e.runs = runs;
+	e.next = 0;
+	e.steps = 0;
+	e.status = TESIM_OK;
+	te_mutex_init(&e.lock);
+	for (i = 0; i < nthreads; i++)
+		if (te_thread_create(&t[n], tb_worker, &e) == 0)
+			n++;
+	if (n == 0)
+		tb_worker(&e);
+	for (i = 0; i < n; i++)
+		te_thread_join(t[i]);
+	te_mutex_destroy(&e.lock);
+	return e.status == TESIM_OK ? e.steps : -1;
+}
+
+/* Times sim (runs > 0: an ensemble of runs on nthreads) reps times; the
+ * last run's result is left in res. */
+static int endtoend(const char *name, const TESimConfig *sim, long runs,
+		int nthreads, int reps, TBCounters *c, TBResult *r, TESimResult *res)
+{
+	double s[TEBENCH_MAX_REPS], ipc[TEBENCH_MAX_REPS], t;
+	long steps = 0;
+	int i;
+
+	for (i = 0; i < reps; i++) {
+		tb_start(c);
+		t = tert_clock();
+		if (runs > 0)
+			steps = ensemble(sim, runs, nthreads);
+		else
+			steps = tesim_run(sim, NULL, res) == TESIM_OK ? tb_steps(sim, res) : -1;
+		s[i] = tert_clock() - t;
+		ipc[i] = tb_ipc(c);
+		if (steps <= 0)
+			return -1;
+	}
+	r->name = name;
+	r->calls = steps;
+	r->reps = reps;
+	tb_summary(r, s, ipc);
+	return 0;
+}
+
+/* ============================================================================= */
+
+static void put(FILE *fp, const TBResult *r)
+{
+	if (r->ipc >= 0.)
+		fprintf(fp, "%-10s %12ld %4d %12.3f %10.3f %6.3f %10.6f\n", r->name,
+				r->calls, r->reps, r->median, r->mad, r->ipc, r->seconds);
+	else
+		fprintf(fp, "%-10s %12ld %4d %12.3f %10.3f %6s %10.6f\n", r->name,
+				r->calls, r->reps, r->median, r->mad, "-", r->seconds);
+}
+
+static int putresults(const char *name, const TBResult *r, int n,
+		char note[][128], int fused, int nthreads, long runs, double hours)
+{
+	FILE *fp;
+	int i, ok;
+
+	if (!(fp = fopen(name, "w")))
+		return -1;
+	fprintf(fp, "# tebench: %s evaluation, %d threads, %ld runs of %g h\n",
+			fused ? "fused" : "model", nthreads, runs, hours);
+	fprintf(fp, "# name calls reps median_ns mad_ns ipc seconds\n");
+	for (i = 0; i < n; i++)
+		put(fp, &r[i]);
+	for (i = 0; i < 3; i++)
+		if (note[i][0])
+			fprintf(fp, "# %s\n", note[i]);
+	ok = !ferror(fp);
+	return fclose(fp) == 0 && ok ? 0 : -1;
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "Usage: tebench [-b name[,name...]] [-r reps] [-m ms] [-R reps]\n"
+			"               [-C control] [-e model|fused] [-n runs] [-u hours]\n"
+			"               [-j threads] [-o results]\n");
+	exit(2);
+}
+
+/* Whether name is in the comma separated list, or the list is NULL. */
+static int listed(const char *list, const char *name)
+{
+	size_t n = strlen(name);
+	const char *s;
+
+	if (!list)
+		return 1;
+	for (s = list; (s = strstr(s, name)) != NULL; s += n)
+		if ((s == list || s[-1] == ',') && (s[n] == '\0' || s[n] == ','))
+			return 1;
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	TBResult r[TB_NMICRO + 3];
+	TBCounters c;
+	TESimConfig sim;
+	TESimResult res;
+	TMLConfig tmlcfg;
+	TEPlant te;
+	const char *list = NULL, *control = NULL, *name = NULL;
+	const char *e2e[] = {"open72", "closed72", "ensemble"};
+	char note[3][128];
+	double ms = 20., hours = 1.;
+	long runs = 1000;
+	int reps = 15, ereps = 3, nthreads = 0, fused = 0, i, n = 0, status;
+
+	for (i = 1; i < argc; i++) {
+		if (argv[i][0] != '-' || argv[i][2] != '\0' || i + 1 == argc)
+			usage();
+		switch (argv[i][1]) {
+		case 'b': list = argv[++i]; break;
+		case 'r': reps = atoi(argv[++i]); break;
+		case 'm': ms = atof(argv[++i]); break;
+		case 'R': ereps = atoi(argv[++i]); break;
+		case 'C': control = argv[++i]; break;
+		case 'e':
+			if (strcmp(argv[++i], "fused") == 0)
+				fused = 1;
+			else if (strcmp(argv[i], "model") != 0)
+				usage();
+			break;
+		case 'n': runs = atol(argv[++i]); break;
+		case 'u': hours = atof(argv[++i]); break;
+		case 'j': nthreads = atoi(argv[++i]); break;
+		case 'o': name = argv[++i]; break;
+		default:  usage();
+		}
+	}
+	if (reps < 1 || reps > TEBENCH_MAX_REPS || ereps < 1 || ereps > TEBENCH_MAX_REPS ||
+			!(ms > 0.) || runs < 1 || !(hours > 0.) || nthreads < 0 ||
+			nthreads > TEBENCH_MAX_THREADS)
+		usage();
+	if (nthreads == 0) {
+		nthreads = te_ncpu();
+		if (nthreads < 1)
+			nthreads = 1;
+		if (nthreads > TEBENCH_MAX_THREADS)
+			nthreads = TEBENCH_MAX_THREADS;
+	}
+	tml_defaults(&tmlcfg);
+	if (control && (status = tml_load(control, &tmlcfg, &i)) != TML_OK) {
+		if (status == TML_ESYNTAX)
+			fprintf(stderr, "tebench: %s:%d: %s\n", control, i, tml_strerror(status));
+		else
+			fprintf(stderr, "tebench: %s: %s\n", control, tml_strerror(status));
+		return 1;
+	}
+	tb_counters(&c);
+
+	tb_plant(&te);
+	for (i = 0; i < TB_NMICRO; i++)
+		if (listed(list, tb_micro[i].name)) {
+			micro(i, &te, reps, ms, &c, &r[n]);
+			put(stdout, &r[n++]);
+		}
+
+	memset(&sim, 0, sizeof(sim));
+	sim.fused = fused;
+	memset(note, 0, sizeof(note));
+	for (i = 0; i < 3; i++) {
+		if (!listed(list, e2e[i]))
+			continue;
+		sim.tstop = i < 2 ? 72. : hours;
+		sim.control = i > 0 ? &tmlcfg : NULL;
+		if (endtoend(e2e[i], &sim, i == 2 ? runs : 0, nthreads, ereps, &c, &r[n],
+				&res) != 0) {
+			fprintf(stderr, "tebench: %s: run failed\n", e2e[i]);
+			tb_close(&c);
+			return 1;
+		}
+		if (i < 2 && res.isd != 0)
+			sprintf(note[i], "%s: shutdown at %g h: %.80s", e2e[i], res.t, res.msg);
+		put(stdout, &r[n++]);
+		if (note[i][0])
+			printf("# %s\n", note[i]);
+	}
+	tb_close(&c);
+
+	if (name && putresults(name, r, n, note, fused, nthreads, runs, hours) != 0) {
+		fprintf(stderr, "tebench: cannot write %s\n", name);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,872 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Tennessee Eastman plant code, shared by the native driver (teplant.c)
+ * and the S-functions (tesfun.c), which include this file.
+ *
+ * This is the plant code of the original temex.c with the common blocks
+ * moved into TEPlant: every routine takes the plant as its first argument
+ * and "pv_." reads "te->pv.", "teproc_." reads "te->teproc." and so on.
+ * Its configuration is compiled in, so the plant never tests it at run time:
+ *
+ *   TE_NOISE        1 (default) adds the measurement noise, 0 leaves
+ *                   XMEAS noise free; the random walks are not affected
+ *   TE_TRACE_LEVEL  trace points compiled in (tetrace.h)
+ *   TE_STATS        counters and timers (testats.h)
+ *
+ * tefunc dispatches to a kernel compiled for the disturbances in use
+ * (tefunc.c): without disturbances their terms are folded away. teidv
+ * selects the kernel whenever the disturbance codes change.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "teplant.h"
+
+#ifndef TE_NOISE
+#define TE_NOISE 1
+#endif
+
+typedef long int integer;
+typedef double doublereal;
+
+#define abs(x) ((x) >= 0 ? (x) : -(x))
+
+/* Table of constant values */
+
+static const integer c__50 = 50;
+static const integer c__0 = 0;
+static const integer c__1 = 1;
+static const integer c__2 = 2;
+static const integer c__3 = 3;
+static const integer c__4 = 4;
+static const integer c__5 = 5;
+static const integer c__6 = 6;
+static const integer c__7 = 7;
+static const integer c__8 = 8;
+static const integer c__9 = 9;
+static const integer c__10 = 10;
+static const integer c__11 = 11;
+static const integer c__12 = 12;
+static const doublereal c_b73 = 1.1544;
+static const doublereal c_b74 = .3735;
+
+/* Prototypes*/
+static int tefunc(TEPlant *te, const integer *nn, doublereal *time,
+		doublereal *yy, doublereal *yp);
+static void teidv(TEPlant *te);
+static doublereal tezc(const TEPlant *te, doublereal *zc);
+static doublereal tecost(const doublereal *xmeas, const doublereal *xmv);
+static void teopcost(TEPlant *te, doublereal t, const doublereal *xmv);
+static int teinit(TEPlant *te, const integer *nn, doublereal *time,
+		doublereal *yy, doublereal *yp);
+static int tesub1_(TEPlant *te, doublereal *z__, doublereal *t, doublereal *h__,
+		const integer *ity);
+static int tesub2_(TEPlant *te, doublereal *z__, doublereal *t, doublereal *h__,
+		const integer *ity);
+static int tesub3_(TEPlant *te, doublereal *z__, doublereal *t, doublereal *dh,
+		const integer *ity);
+static int tesub4_(TEPlant *te, doublereal *x, doublereal *t, doublereal *r__);
+static int tesub5_(TEPlant *te, doublereal *s, doublereal *sp, doublereal *adist,
+		doublereal *bdist, doublereal *cdist, doublereal *ddist,
+		doublereal *tlast, doublereal *tnext, doublereal *hspan,
+		doublereal *hzero, doublereal *sspan, doublereal *szero,
+		doublereal *spspan, integer *idvflag);
+#if TE_NOISE
+static int tesub6_(TEPlant *te, doublereal *std, doublereal *x);
+#endif
+static doublereal tesub7_(TEPlant *te, integer *i__);
+static doublereal tesub8_(TEPlant *te, const integer *i__, doublereal *t);
+static double pow_dd(doublereal *ap, const doublereal *bp);
+static double d_mod(doublereal *x, doublereal *y);
+
+/* ============================================================================= */
+
+/* SUBROUTINE TEFUNC*/
+
+/* Kernels of tefunc, one per configuration of the disturbances */
+
+#define TE_KERNEL_NODIST  0     /* all disturbances off */
+#define TE_KERNEL_DIST    1
+
+#define TE_KERNEL  tefunc_nodist
+#define TE_DIST    0
+#include "tefunc.c"
+
+#define TE_KERNEL  tefunc_dist
+#define TE_DIST    1
+#include "tefunc.c"
+
+static int (*const te_kernels[])(TEPlant *, const integer *, doublereal *,
+		doublereal *, doublereal *) = {tefunc_nodist, tefunc_dist};
+
+static int tefunc(TEPlant *te, const integer *nn, doublereal *time, doublereal *yy, doublereal *yp)
+{
+/* 		Time of the evaluation, for the trace points */
+    te->t = *time;
+    return te_kernels[te->kernel](te, nn, time, yy, yp);
+} /* tefunc_ */
+
+/* Normalizes the disturbance codes to 0 or 1, derives the flags of the */
+/* random walks from them and selects the kernel of tefunc. Called */
+/* whenever dvec.idv changes. */
+
+static void teidv(TEPlant *te)
+{
+    integer i__;
+
+    te->kernel = TE_KERNEL_NODIST;
+    for (i__ = 1; i__ <= 20; ++i__) {
+	if (te->dvec.idv[i__ - 1] > 0) {
+	    te->dvec.idv[i__ - 1] = 1;
+	    te->kernel = TE_KERNEL_DIST;
+	} else {
+	    te->dvec.idv[i__ - 1] = 0;
+	}
+/* L500: */
+    }
+    te->wlk.idvwlk[0] = te->dvec.idv[7];
+    te->wlk.idvwlk[1] = te->dvec.idv[7];
+    te->wlk.idvwlk[2] = te->dvec.idv[8];
+    te->wlk.idvwlk[3] = te->dvec.idv[9];
+    te->wlk.idvwlk[4] = te->dvec.idv[10];
+    te->wlk.idvwlk[5] = te->dvec.idv[11];
+    te->wlk.idvwlk[6] = te->dvec.idv[12];
+    te->wlk.idvwlk[7] = te->dvec.idv[12];
+    te->wlk.idvwlk[8] = te->dvec.idv[15];
+    te->wlk.idvwlk[9] = te->dvec.idv[16];
+    te->wlk.idvwlk[10] = te->dvec.idv[17];
+    te->wlk.idvwlk[11] = te->dvec.idv[19];
+} /* teidv */
+
+/* Zero-crossing functions and next time event of the plant as of its */
+/* last evaluation, see te_events in teplant.h. The pressure functions */
+/* change sign where tefunc switches branch; the time events are the */
+/* analyzer samples and the knots of the random walks, at which tefunc */
+/* updates its discrete state. Neither reads xmv. */
+
+static doublereal tezc(const TEPlant *te, doublereal *zc)
+{
+    integer i__;
+    doublereal tnext;
+
+    if (zc) {
+/* 		Flows cut off at no pressure difference */
+	zc[0] = te->teproc.ptv - te->teproc.ptr;
+	zc[1] = te->teproc.ptr - te->teproc.pts;
+	zc[2] = te->teproc.pts - (float)760.;
+	zc[3] = te->teproc.ptv - te->teproc.pts;
+    }
+    tnext = te->teproc.tgas;
+    if (te->teproc.tprod < tnext) {
+	tnext = te->teproc.tprod;
+    }
+    for (i__ = 1; i__ <= 12; ++i__) {
+	if (te->wlk.tnext[i__ - 1] < tnext) {
+	    tnext = te->wlk.tnext[i__ - 1];
+	}
+    }
+    return tnext;
+} /* tezc */
+
+/* Operating cost [$/h] of XMEAS(1..41) and XMV, as the HourlyCost block */
+/* of TEModel.mdl computes OpCost: the one cost formula of the plant. */
+
+static doublereal tecost(const doublereal *xmeas, const doublereal *xmv)
+{
+    doublereal purge, product;
+
+/* 		Purge: component costs weighted by the analysis of stream 9 */
+    purge = xmeas[28] * 2.209 + xmeas[30] * 6.177 + xmeas[31] * 22.06 + 
+	    xmeas[32] * 14.56 + xmeas[33] * 17.89 + xmeas[34] * 30.44 + 
+	    xmeas[35] * 22.94;
+/* 		Product: D, E and F lost with stream 11 */
+    product = xmeas[36] * .2206 + xmeas[37] * .1456 + xmeas[38] * .1789;
+    return xmeas[18] * .0318 + xmeas[19] * .0536 + xmeas[9] * .44791 * 
+	    purge + xmv[7] * 4.541 * product;
+} /* tecost */
+
+/* Run totals of operating cost and product, XMEAS(42) with them. Called */
+/* once per accepted step at its time T, after the outputs, with the XMV */
+/* of the step: integrates the rates of the previous step up to T and */
+/* takes the rates at T. A call at T = 0 restarts the totals; time never */
+/* runs back on accepted steps, so an earlier T is ignored. */
+
+static void teopcost(TEPlant *te, doublereal t, const doublereal *xmv)
+{
+    if (t <= 0.) {
+	te->opcost.total = 0.;
+	te->opcost.product = 0.;
+    } else if (t > te->opcost.tlast) {
+	te->opcost.total += (t - te->opcost.tlast) * te->opcost.rate;
+	te->opcost.product += (t - te->opcost.tlast) * te->opcost.prate;
+    } else if (t < te->opcost.tlast) {
+	return;
+    }
+    te->opcost.tlast = t;
+    te->opcost.prate = te->teproc.ftm[12] * .454;
+    te->opcost.rate = tecost(te->pv.xmeas, xmv);
+    te->opcost.xmeas[0] = 0.;
+    if (te->opcost.prate > 0.) {
+	te->opcost.xmeas[0] = te->opcost.rate * 100. / te->opcost.prate;
+    }
+} /* teopcost */
+
+
+
+/* ============================================================================= */
+
+/* SUBROUTINE TEINIT*/
+
+static int teinit(TEPlant *te, const integer *nn, doublereal *time, doublereal *yy, doublereal *yp)
+{
+    /* Local variables */
+    integer i__;
+#define isd (&te->dvec.idv[20])
+
+
+/*       Initialization */
+
+/*         Inputs: */
+
+/*           NN   = Number of differential equations */
+
+/*         Outputs: */
+
+/*           Time = Current time(hrs) */
+/*           YY   = Current state values */
+/*           YP   = Current derivative values */
+
+/*  MEASUREMENT AND VALVE COMMON BLOCK */
+
+
+/*   DISTURBANCE VECTOR COMMON BLOCK */
+
+/* 	NOTE: I have included isd in the /IDV/ common.  This is set */
+/* 		non-zero when the process is shutting down. */
+/* 		Output XMEAS(42) is for cost [cents/kmol product]. */
+/* 		Output XMEAS(43) is production rate of G [kmol G generated/h] */
+/* 		Output XMEAS(44) is production rate of H [kmol H generated/h] */
+/* 		Output XMEAS(45) is production rate of F [kmol F generated/h] */
+/* 		Output XMEAS(46) is partial pressure of A in reactor [kPa] */
+/* 		Output XMEAS(47) is partial pressure of C in reactor [kPa] */
+/* 		Output XMEAS(48) is partial pressure of D in reactor [kPa] */
+/* 		Output XMEAS(49) is partial pressure of E in reactor [kPa] */
+/* 		Output XMEAS(50) is true (delay free) mole % G in product */
+/* 		Output XMEAS(51) is true (delay free) mole % H in product */
+    /* Parameter adjustments */
+    --yp;
+    --yy;
+
+    /* Function Body */
+    te->const_.xmw[0] = (float)2.;
+    te->const_.xmw[1] = (float)25.4;
+    te->const_.xmw[2] = (float)28.;
+    te->const_.xmw[3] = (float)32.;
+    te->const_.xmw[4] = (float)46.;
+    te->const_.xmw[5] = (float)48.;
+    te->const_.xmw[6] = (float)62.;
+    te->const_.xmw[7] = (float)76.;
+    te->const_.avp[0] = (float)0.;
+    te->const_.avp[1] = (float)0.;
+    te->const_.avp[2] = (float)0.;
+    te->const_.avp[3] = (float)15.92;
+    te->const_.avp[4] = (float)16.35;
+    te->const_.avp[5] = (float)16.35;
+    te->const_.avp[6] = (float)16.43;
+    te->const_.avp[7] = (float)17.21;
+    te->const_.bvp[0] = (float)0.;
+    te->const_.bvp[1] = (float)0.;
+    te->const_.bvp[2] = (float)0.;
+    te->const_.bvp[3] = (float)-1444.;
+    te->const_.bvp[4] = (float)-2114.;
+    te->const_.bvp[5] = (float)-2114.;
+    te->const_.bvp[6] = (float)-2748.;
+    te->const_.bvp[7] = (float)-3318.;
+    te->const_.cvp[0] = (float)0.;
+    te->const_.cvp[1] = (float)0.;
+    te->const_.cvp[2] = (float)0.;
+    te->const_.cvp[3] = (float)259.;
+    te->const_.cvp[4] = (float)265.5;
+    te->const_.cvp[5] = (float)265.5;
+    te->const_.cvp[6] = (float)232.9;
+    te->const_.cvp[7] = (float)249.6;
+    te->const_.ad[0] = (float)1.;
+    te->const_.ad[1] = (float)1.;
+    te->const_.ad[2] = (float)1.;
+    te->const_.ad[3] = (float)23.3;
+    te->const_.ad[4] = (float)33.9;
+    te->const_.ad[5] = (float)32.8;
+    te->const_.ad[6] = (float)49.9;
+    te->const_.ad[7] = (float)50.5;
+    te->const_.bd[0] = (float)0.;
+    te->const_.bd[1] = (float)0.;
+    te->const_.bd[2] = (float)0.;
+    te->const_.bd[3] = (float)-.07;
+    te->const_.bd[4] = (float)-.0957;
+    te->const_.bd[5] = (float)-.0995;
+    te->const_.bd[6] = (float)-.0191;
+    te->const_.bd[7] = (float)-.0541;
+    te->const_.cd[0] = (float)0.;
+    te->const_.cd[1] = (float)0.;
+    te->const_.cd[2] = (float)0.;
+    te->const_.cd[3] = (float)-2e-4;
+    te->const_.cd[4] = (float)-1.52e-4;
+    te->const_.cd[5] = (float)-2.33e-4;
+    te->const_.cd[6] = (float)-4.25e-4;
+    te->const_.cd[7] = (float)-1.5e-4;
+    te->const_.ah[0] = 1e-6;
+    te->const_.ah[1] = 1e-6;
+    te->const_.ah[2] = 1e-6;
+    te->const_.ah[3] = 9.6e-7;
+    te->const_.ah[4] = 5.73e-7;
+    te->const_.ah[5] = 6.52e-7;
+    te->const_.ah[6] = 5.15e-7;
+    te->const_.ah[7] = 4.71e-7;
+    te->const_.bh[0] = (float)0.;
+    te->const_.bh[1] = (float)0.;
+    te->const_.bh[2] = (float)0.;
+    te->const_.bh[3] = 8.7e-9;
+    te->const_.bh[4] = 2.41e-9;
+    te->const_.bh[5] = 2.18e-9;
+    te->const_.bh[6] = 5.65e-10;
+    te->const_.bh[7] = 8.7e-10;
+    te->const_.ch[0] = (float)0.;
+    te->const_.ch[1] = (float)0.;
+    te->const_.ch[2] = (float)0.;
+    te->const_.ch[3] = 4.81e-11;
+    te->const_.ch[4] = 1.82e-11;
+    te->const_.ch[5] = 1.94e-11;
+    te->const_.ch[6] = 3.82e-12;
+    te->const_.ch[7] = 2.62e-12;
+    te->const_.av[0] = 1e-6;
+    te->const_.av[1] = 1e-6;
+    te->const_.av[2] = 1e-6;
+    te->const_.av[3] = 8.67e-5;
+    te->const_.av[4] = 1.6e-4;
+    te->const_.av[5] = 1.6e-4;
+    te->const_.av[6] = 2.25e-4;
+    te->const_.av[7] = 2.09e-4;
+    te->const_.ag[0] = 3.411e-6;
+    te->const_.ag[1] = 3.799e-7;
+    te->const_.ag[2] = 2.491e-7;
+    te->const_.ag[3] = 3.567e-7;
+    te->const_.ag[4] = 3.463e-7;
+    te->const_.ag[5] = 3.93e-7;
+    te->const_.ag[6] = 1.7e-7;
+    te->const_.ag[7] = 1.5e-7;
+    te->const_.bg[0] = 7.18e-10;
+    te->const_.bg[1] = 1.08e-9;
+    te->const_.bg[2] = 1.36e-11;
+    te->const_.bg[3] = 8.51e-10;
+    te->const_.bg[4] = 8.96e-10;
+    te->const_.bg[5] = 1.02e-9;
+    te->const_.bg[6] = 0.;
+    te->const_.bg[7] = 0.;
+    te->const_.cg[0] = 6e-13;
+    te->const_.cg[1] = -3.98e-13;
+    te->const_.cg[2] = -3.93e-14;
+    te->const_.cg[3] = -3.12e-13;
+    te->const_.cg[4] = -3.27e-13;
+    te->const_.cg[5] = -3.12e-13;
+    te->const_.cg[6] = 0.;
+    te->const_.cg[7] = 0.;
+    yy[1] = (float)10.40491389;
+    yy[2] = (float)4.363996017;
+    yy[3] = (float)7.570059737;
+    yy[4] = (float).4230042431;
+    yy[5] = (float)24.15513437;
+    yy[6] = (float)2.942597645;
+    yy[7] = (float)154.3770655;
+    yy[8] = (float)159.186596;
+    yy[9] = (float)2.808522723;
+    yy[10] = (float)63.75581199;
+    yy[11] = (float)26.74026066;
+    yy[12] = (float)46.38532432;
+    yy[13] = (float).2464521543;
+    yy[14] = (float)15.20484404;
+    yy[15] = (float)1.852266172;
+    yy[16] = (float)52.44639459;
+    yy[17] = (float)41.20394008;
+    yy[18] = (float).569931776;
+    yy[19] = (float).4306056376;
+    yy[20] = .0079906200783;
+    yy[21] = (float).9056036089;
+    yy[22] = .016054258216;
+    yy[23] = (float).7509759687;
+    yy[24] = .088582855955;
+    yy[25] = (float)48.27726193;
+    yy[26] = (float)39.38459028;
+    yy[27] = (float).3755297257;
+    yy[28] = (float)107.7562698;
+    yy[29] = (float)29.77250546;
+    yy[30] = (float)88.32481135;
+    yy[31] = (float)23.03929507;
+    yy[32] = (float)62.85848794;
+    yy[33] = (float)5.546318688;
+    yy[34] = (float)11.92244772;
+    yy[35] = (float)5.555448243;
+    yy[36] = (float).9218489762;
+    yy[37] = (float)94.59927549;
+    yy[38] = (float)77.29698353;
+    yy[39] = (float)63.05263039;
+    yy[40] = (float)53.97970677;
+    yy[41] = (float)24.64355755;
+    yy[42] = (float)61.30192144;
+    yy[43] = (float)22.21;
+    yy[44] = (float)40.06374673;
+    yy[45] = (float)38.1003437;
+    yy[46] = (float)46.53415582;
+    yy[47] = (float)47.44573456;
+    yy[48] = (float)41.10581288;
+    yy[49] = (float)18.11349055;
+    yy[50] = (float)50.;
+    for (i__ = 1; i__ <= 12; ++i__) {
+	te->pv.xmv[i__ - 1] = yy[i__ + 38];
+	te->teproc.vcv[i__ - 1] = te->pv.xmv[i__ - 1];
+	te->teproc.vst[i__ - 1] = 2.;
+	te->teproc.ivst[i__ - 1] = 0;
+/* L200: */
+    }
+    te->teproc.vrng[0] = (float)400.;
+    te->teproc.vrng[1] = (float)400.;
+    te->teproc.vrng[2] = (float)100.;
+    te->teproc.vrng[3] = (float)1500.;
+    te->teproc.vrng[6] = (float)1500.;
+    te->teproc.vrng[7] = (float)1e3;
+    te->teproc.vrng[8] = (float).03;
+    te->teproc.vrng[9] = (float)1e3;
+    te->teproc.vrng[10] = (float)1200.;
+    te->teproc.vtr = (float)1300.;
+    te->teproc.vts = (float)3500.;
+    te->teproc.vtc = (float)156.5;
+    te->teproc.vtv = (float)5e3;
+    te->teproc.htr[0] = .06899381054;
+    te->teproc.htr[1] = .05;
+    te->teproc.hwr = (float)7060.;
+    te->teproc.hws = (float)11138.;
+    te->teproc.sfr[0] = (float).995;
+    te->teproc.sfr[1] = (float).991;
+    te->teproc.sfr[2] = (float).99;
+    te->teproc.sfr[3] = (float).916;
+    te->teproc.sfr[4] = (float).936;
+    te->teproc.sfr[5] = (float).938;
+    te->teproc.sfr[6] = .058;
+    te->teproc.sfr[7] = .0301;
+    te->teproc.xst[0] = (float)0.;
+    te->teproc.xst[1] = (float)1e-4;
+    te->teproc.xst[2] = (float)0.;
+    te->teproc.xst[3] = (float).9999;
+    te->teproc.xst[4] = (float)0.;
+    te->teproc.xst[5] = (float)0.;
+    te->teproc.xst[6] = (float)0.;
+    te->teproc.xst[7] = (float)0.;
+    te->teproc.tst[0] = (float)45.;
+    te->teproc.xst[8] = (float)0.;
+    te->teproc.xst[9] = (float)0.;
+    te->teproc.xst[10] = (float)0.;
+    te->teproc.xst[11] = (float)0.;
+    te->teproc.xst[12] = (float).9999;
+    te->teproc.xst[13] = (float)1e-4;
+    te->teproc.xst[14] = (float)0.;
+    te->teproc.xst[15] = (float)0.;
+    te->teproc.tst[1] = (float)45.;
+    te->teproc.xst[16] = (float).9999;
+    te->teproc.xst[17] = (float)1e-4;
+    te->teproc.xst[18] = (float)0.;
+    te->teproc.xst[19] = (float)0.;
+    te->teproc.xst[20] = (float)0.;
+    te->teproc.xst[21] = (float)0.;
+    te->teproc.xst[22] = (float)0.;
+    te->teproc.xst[23] = (float)0.;
+    te->teproc.tst[2] = (float)45.;
+    te->teproc.xst[24] = (float).485;
+    te->teproc.xst[25] = (float).005;
+    te->teproc.xst[26] = (float).51;
+    te->teproc.xst[27] = (float)0.;
+    te->teproc.xst[28] = (float)0.;
+    te->teproc.xst[29] = (float)0.;
+    te->teproc.xst[30] = (float)0.;
+    te->teproc.xst[31] = (float)0.;
+    te->teproc.tst[3] = (float)45.;
+    te->teproc.cpflmx = (float)280275.;
+    te->teproc.cpprmx = (float)1.3;
+    te->teproc.vtau[0] = (float)8.;
+    te->teproc.vtau[1] = (float)8.;
+    te->teproc.vtau[2] = (float)6.;
+    te->teproc.vtau[3] = (float)9.;
+    te->teproc.vtau[4] = (float)7.;
+    te->teproc.vtau[5] = (float)5.;
+    te->teproc.vtau[6] = (float)5.;
+    te->teproc.vtau[7] = (float)5.;
+    te->teproc.vtau[8] = (float)120.;
+    te->teproc.vtau[9] = (float)5.;
+    te->teproc.vtau[10] = (float)5.;
+    te->teproc.vtau[11] = (float)5.;
+    for (i__ = 1; i__ <= 12; ++i__) {
+	te->teproc.vtau[i__ - 1] /= (float)3600.;
+/* L300: */
+    }
+    te->randsd.g = 1431655765.;
+    te->teproc.xns[0] = .0012;
+    te->teproc.xns[1] = 18.;
+    te->teproc.xns[2] = 22.;
+    te->teproc.xns[3] = .05;
+    te->teproc.xns[4] = .2;
+    te->teproc.xns[5] = .21;
+    te->teproc.xns[6] = .3;
+    te->teproc.xns[7] = .5;
+    te->teproc.xns[8] = .01;
+    te->teproc.xns[9] = .0017;
+    te->teproc.xns[10] = .01;
+    te->teproc.xns[11] = 1.;
+    te->teproc.xns[12] = .3;
+    te->teproc.xns[13] = .125;
+    te->teproc.xns[14] = 1.;
+    te->teproc.xns[15] = .3;
+    te->teproc.xns[16] = .115;
+    te->teproc.xns[17] = .01;
+    te->teproc.xns[18] = 1.15;
+    te->teproc.xns[19] = .2;
+    te->teproc.xns[20] = .01;
+    te->teproc.xns[21] = .01;
+    te->teproc.xns[22] = .25;
+    te->teproc.xns[23] = .1;
+    te->teproc.xns[24] = .25;
+    te->teproc.xns[25] = .1;
+    te->teproc.xns[26] = .25;
+    te->teproc.xns[27] = .025;
+    te->teproc.xns[28] = .25;
+    te->teproc.xns[29] = .1;
+    te->teproc.xns[30] = .25;
+    te->teproc.xns[31] = .1;
+    te->teproc.xns[32] = .25;
+    te->teproc.xns[33] = .025;
+    te->teproc.xns[34] = .05;
+    te->teproc.xns[35] = .05;
+    te->teproc.xns[36] = .01;
+    te->teproc.xns[37] = .01;
+    te->teproc.xns[38] = .01;
+    te->teproc.xns[39] = .5;
+    te->teproc.xns[40] = .5;
+    for (i__ = 1; i__ <= 20; ++i__) {
+	te->dvec.idv[i__ - 1] = 0;
+/* L500: */
+    }
+    teidv(te);
+    te->wlk.hspan[0] = .2;
+    te->wlk.hzero[0] = .5;
+    te->wlk.sspan[0] = .03;
+    te->wlk.szero[0] = .485;
+    te->wlk.spspan[0] = 0.;
+    te->wlk.hspan[1] = .7;
+    te->wlk.hzero[1] = 1.;
+    te->wlk.sspan[1] = .003;
+    te->wlk.szero[1] = .005;
+    te->wlk.spspan[1] = 0.;
+    te->wlk.hspan[2] = .25;
+    te->wlk.hzero[2] = .5;
+    te->wlk.sspan[2] = 10.;
+    te->wlk.szero[2] = 45.;
+    te->wlk.spspan[2] = 0.;
+    te->wlk.hspan[3] = .7;
+    te->wlk.hzero[3] = 1.;
+    te->wlk.sspan[3] = 10.;
+    te->wlk.szero[3] = 45.;
+    te->wlk.spspan[3] = 0.;
+    te->wlk.hspan[4] = .15;
+    te->wlk.hzero[4] = .25;
+    te->wlk.sspan[4] = 10.;
+    te->wlk.szero[4] = 35.;
+    te->wlk.spspan[4] = 0.;
+    te->wlk.hspan[5] = .15;
+    te->wlk.hzero[5] = .25;
+    te->wlk.sspan[5] = 10.;
+    te->wlk.szero[5] = 40.;
+    te->wlk.spspan[5] = 0.;
+    te->wlk.hspan[6] = 1.;
+    te->wlk.hzero[6] = 2.;
+    te->wlk.sspan[6] = .25;
+    te->wlk.szero[6] = 1.;
+    te->wlk.spspan[6] = 0.;
+    te->wlk.hspan[7] = 1.;
+    te->wlk.hzero[7] = 2.;
+    te->wlk.sspan[7] = .25;
+    te->wlk.szero[7] = 1.;
+    te->wlk.spspan[7] = 0.;
+    te->wlk.hspan[8] = .4;
+    te->wlk.hzero[8] = .5;
+    te->wlk.sspan[8] = .25;
+    te->wlk.szero[8] = 0.;
+    te->wlk.spspan[8] = 0.;
+    te->wlk.hspan[9] = 1.5;
+    te->wlk.hzero[9] = 2.;
+    te->wlk.sspan[9] = 0.;
+    te->wlk.szero[9] = 0.;
+    te->wlk.spspan[9] = 0.;
+    te->wlk.hspan[10] = 2.;
+    te->wlk.hzero[10] = 3.;
+    te->wlk.sspan[10] = 0.;
+    te->wlk.szero[10] = 0.;
+    te->wlk.spspan[10] = 0.;
+    te->wlk.hspan[11] = 1.5;
+    te->wlk.hzero[11] = 2.;
+    te->wlk.sspan[11] = 0.;
+    te->wlk.szero[11] = 0.;
+    te->wlk.spspan[11] = 0.;
+    for (i__ = 1; i__ <= 12; ++i__) {
+	te->wlk.tlast[i__ - 1] = 0.;
+	te->wlk.tnext[i__ - 1] = .1;
+	te->wlk.adist[i__ - 1] = te->wlk.szero[i__ - 1];
+	te->wlk.bdist[i__ - 1] = 0.;
+	te->wlk.cdist[i__ - 1] = 0.;
+	te->wlk.ddist[i__ - 1] = 0.;
+/* L550: */
+    }
+    *time = (float)0.;
+    tefunc(te, nn, time, &yy[1], &yp[1]);
+    return 0;
+} /* teinit */
+
+#undef isd
+
+
+/* ============================================================================= */
+
+/* Subroutine */static int tesub1_(TEPlant *te, doublereal *z__, doublereal *t, 
+		doublereal *h__, const integer *ity)
+{
+    /* System generated locals */
+    doublereal d__1;
+
+    /* Local variables */
+    integer i__;
+    doublereal r__, hi;
+
+    /* Parameter adjustments */
+    --z__;
+
+    /* Function Body */
+    if (*ity == 0) {
+	*h__ = 0.;
+	for (i__ = 1; i__ <= 8; ++i__) {
+/* Computing 2nd power */
+	    d__1 = *t;
+	    hi = *t * (te->const_.ah[i__ - 1] + te->const_.bh[i__ - 1] * *t / 2. + 
+		    te->const_.ch[i__ - 1] * (d__1 * d__1) / 3.);
+	    hi *= 1.8;
+	    *h__ += z__[i__] * te->const_.xmw[i__ - 1] * hi;
+/* L100: */
+	}
+    } else {
+	*h__ = 0.;
+	for (i__ = 1; i__ <= 8; ++i__) {
+/* Computing 2nd power */
+	    d__1 = *t;
+	    hi = *t * (te->const_.ag[i__ - 1] + te->const_.bg[i__ - 1] * *t / 2. + 
+		    te->const_.cg[i__ - 1] * (d__1 * d__1) / 3.);
+	    hi *= 1.8;
+	    hi += te->const_.av[i__ - 1];
+	    *h__ += z__[i__] * te->const_.xmw[i__ - 1] * hi;
+/* L200: */
+	}
+    }
+    if (*ity == 2) {
+	r__ = 3.57696e-6;
+	*h__ -= r__ * (*t + (float)273.15);
+    }
+    return 0;
+} /* tesub1_ */
+
+/* Subroutine */static int tesub2_(TEPlant *te, doublereal *z__, doublereal *t, doublereal *h__, 
+           const integer *ity)
+{
+    integer j;
+    doublereal htest;
+    doublereal dh;
+    doublereal dt, err, tin;
+
+    /* Parameter adjustments */
+    --z__;
+
+    /* Function Body */
+    tin = *t;
+    for (j = 1; j <= 100; ++j) {
+	tesub1_(te, &z__[1], t, &htest, ity);
+	err = htest - *h__;
+	tesub3_(te, &z__[1], t, &dh, ity);
+	dt = -err / dh;
+	*t += dt;
+	TE_STATS_COUNT(te->stats, newton);
+/* L250: */
+	if (abs(dt) < 1e-12) {
+	    goto L300;
+	}
+    }
+    TE_STATS_COUNT(te->stats, fallback);
+    TTR(te->trace, TTR_WARN, TTR_NEWTON, te->t, tin, *h__, (double) *ity);
+    *t = tin;
+L300:
+    return 0;
+} /* tesub2_ */
+
+/* Subroutine */static int tesub3_(TEPlant *te, doublereal *z__, doublereal *t, doublereal *dh, 
+		   const integer *ity)
+{
+    /* System generated locals */
+    doublereal d__1;
+
+    /* Local variables */
+    integer i__;
+    doublereal r__, dhi;
+
+    /* Parameter adjustments */
+    --z__;
+
+    /* Function Body */
+    if (*ity == 0) {
+	*dh = 0.;
+	for (i__ = 1; i__ <= 8; ++i__) {
+/* Computing 2nd power */
+	    d__1 = *t;
+	    dhi = te->const_.ah[i__ - 1] + te->const_.bh[i__ - 1] * *t + te->const_.ch[
+		    i__ - 1] * (d__1 * d__1);
+	    dhi *= 1.8;
+	    *dh += z__[i__] * te->const_.xmw[i__ - 1] * dhi;
+/* L100: */
+	}
+    } else {
+	*dh = 0.;
+	for (i__ = 1; i__ <= 8; ++i__) {
+/* Computing 2nd power */
+	    d__1 = *t;
+	    dhi = te->const_.ag[i__ - 1] + te->const_.bg[i__ - 1] * *t + te->const_.cg[
+		    i__ - 1] * (d__1 * d__1);
+	    dhi *= 1.8;
+	    *dh += z__[i__] * te->const_.xmw[i__ - 1] * dhi;
+/* L200: */
+	}
+    }
+    if (*ity == 2) {
+	r__ = 3.57696e-6;
+	*dh -= r__;
+    }
+    return 0;
+} /* tesub3_ */
+
+/* Subroutine */static int tesub4_(TEPlant *te, doublereal *x, doublereal *t, doublereal *r__)
+{
+    integer i__;
+    doublereal v;
+
+    /* Parameter adjustments */
+    --x;
+
+    /* Function Body */
+    v = (float)0.;
+    for (i__ = 1; i__ <= 8; ++i__) {
+	v += x[i__] * te->const_.xmw[i__ - 1] / (te->const_.ad[i__ - 1] + (
+		te->const_.bd[i__ - 1] + te->const_.cd[i__ - 1] * *t) * *t);
+/* L10: */
+    }
+    *r__ = (float)1. / v;
+    return 0;
+} /* tesub4_ */
+
+static int tesub5_(TEPlant *te, doublereal *s, doublereal *sp, doublereal *adist, doublereal *bdist, 
+			doublereal *cdist, doublereal *ddist, doublereal *tlast, 
+			doublereal *tnext, doublereal *hspan, doublereal *hzero, 
+			doublereal *sspan, doublereal *szero, doublereal *spspan, 
+			integer *idvflag)
+{
+    /* System generated locals */
+    doublereal d__1;
+
+    /* Local variables */
+    doublereal h__;
+    integer i__;
+    doublereal s1;
+    doublereal s1p;
+
+    i__ = -1;
+    h__ = *hspan * tesub7_(te, &i__) + *hzero;
+    s1 = *sspan * tesub7_(te, &i__) * *idvflag + *szero;
+    s1p = *spspan * tesub7_(te, &i__) * *idvflag;
+    *adist = *s;
+    *bdist = *sp;
+/* Computing 2nd power */
+    d__1 = h__;
+    *cdist = ((s1 - *s) * 3. - h__ * (s1p + *sp * 2.)) / (d__1 * d__1);
+/* Computing 3rd power */
+    d__1 = h__;
+    *ddist = ((*s - s1) * 2. + h__ * (s1p + *sp)) / (d__1 * (d__1 * d__1));
+    *tnext = *tlast + h__;
+    return 0;
+} /* tesub5_ */
+
+#if TE_NOISE
+/* Subroutine */static int tesub6_(TEPlant *te, doublereal *std, doublereal *x)
+{
+    integer i__;
+
+    *x = 0.;
+    for (i__ = 1; i__ <= 12; ++i__) {
+	*x += tesub7_(te, &i__);
+    }
+    *x = (*x - 6.) * *std;
+    return 0;
+} /* tesub6_ */
+#endif
+
+static doublereal tesub7_(TEPlant *te, integer *i__)
+{
+    /* System generated locals */
+    doublereal ret_val, d__1, c_b78;
+
+    d__1 = te->randsd.g * 9228907.;
+	c_b78 = 4294967296.;
+    te->randsd.g = d_mod(&d__1, &c_b78);
+    TE_STATS_COUNT(te->stats, draws);
+    if (*i__ >= 0) {
+	ret_val = te->randsd.g / 4294967296.;
+    }
+    if (*i__ < 0) {
+	ret_val = te->randsd.g * 2. / 4294967296. - 1.;
+    }
+    return ret_val;
+} /* tesub7_ */
+
+static doublereal tesub8_(TEPlant *te, const integer *i__, doublereal *t)
+{
+    /* System generated locals */
+    doublereal ret_val;
+
+    /* Local variables */
+    doublereal h__;
+
+    h__ = *t - te->wlk.tlast[*i__ - 1];
+    ret_val = te->wlk.adist[*i__ - 1] + h__ * (te->wlk.bdist[*i__ - 1] + h__ * (
+	    te->wlk.cdist[*i__ - 1] + h__ * te->wlk.ddist[*i__ - 1]));
+    return ret_val;
+} /* tesub8_ */
+
+static double d_mod(doublereal *x, doublereal *y)
+{
+	double quotient;
+	if( (quotient = *x / *y) >= 0)
+		quotient = floor(quotient);
+	else
+		quotient = -floor(-quotient);
+	return(*x - (*y) * quotient );
+}
+
+static double pow_dd(doublereal *ap, const doublereal *bp)
+{
+return(pow(*ap, *bp) );
+}
@@ -0,0 +1,288 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Mean and covariance accumulator and PCA fit, see tecov.h. */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tecov.h"
+
+#define TC_SWEEPS 100   /* Jacobi sweeps at most */
+
+int tc_init(TCAcc *acc, int m)
+{
+	memset(acc, 0, sizeof(*acc));
+	if (m < 1)
+		return TC_EARG;
+	if (!(acc->mean = (double *) calloc((size_t) m * (m + 3), sizeof(double))))
+		return TC_ENOMEM;
+	acc->m2 = acc->mean + m;
+	acc->work = acc->m2 + (size_t) m * m;
+	acc->m = m;
+	return TC_OK;
+}
+
+void tc_free(TCAcc *acc)
+{
+	free(acc->mean);
+	memset(acc, 0, sizeof(*acc));
+}
+
+/* Merges a set of nb samples of mean mb and co-moments m2b (NULL for a set
+ * whose co-moments were already added to a->m2). */
+static void merge(TCAcc *a, double nb, const double *mb, const double *m2b)
+{
+	int m = a->m, i, j;
+	double n = a->n + nb, f = a->n * nb / n;
+	double *d = a->work;
+
+	for (i = 0; i < m; i++)
+		d[i] = mb[i] - a->mean[i];
+	for (i = 0; i < m; i++) {
+		double *restrict row = &a->m2[(size_t) i * m];
+		double di = d[i] * f;
+
+		if (m2b)
+			for (j = 0; j < m; j++)
+				row[j] += m2b[(size_t) i * m + j] + di * d[j];
+		else
+			for (j = 0; j < m; j++)
+				row[j] += di * d[j];
+	}
+	for (i = 0; i < m; i++)
+		a->mean[i] += d[i] * nb / n;
+	a->n = n;
+}
+
+void tc_add(TCAcc *acc, const double *y, size_t ld, size_t n, const char *use)
+{
+	int m = acc->m, i, j;
+	double *mb = acc->work + m, nb = 0.;
+	size_t r;
+
+	for (r = 0; r < n; r++)
+		nb += !use || use[r];
+	if (nb == 0.)
+		return;
+	for (i = 0; i < m; i++) {
+		const double *restrict c = &y[(size_t) i * ld];
+		double s = 0.;
+
+		for (r = 0; r < n; r++)
+			if (!use || use[r])
+				s += c[r];
+		mb[i] = s / nb;
+	}
+	/* Co-moments about the block mean go straight to m2; the merge then
+	 * adds the term for the difference of the means. */
+	for (i = 0; i < m; i++) {
+		const double *restrict ci = &y[(size_t) i * ld];
+
+		for (j = i; j < m; j++) {
+			const double *restrict cj = &y[(size_t) j * ld];
+			double s = 0.;
+
+			for (r = 0; r < n; r++)
+				if (!use || use[r])
+					s += (ci[r] - mb[i]) * (cj[r] - mb[j]);
+			acc->m2[(size_t) i * m + j] += s;
+			if (j != i)
+				acc->m2[(size_t) j * m + i] += s;
+		}
+	}
+	merge(acc, nb, mb, NULL);
+}
+
+void tc_merge(TCAcc *a, const TCAcc *b)
+{
+	if (b->n == 0.)
+		return;
+	if (a->n == 0.) {
+		a->n = b->n;
+		memcpy(a->mean, b->mean, (size_t) a->m * sizeof(double));
+		memcpy(a->m2, b->m2, (size_t) a->m * a->m * sizeof(double));
+		return;
+	}
+	merge(a, b->n, b->mean, b->m2);
+}
+
+/* ============================================================================= */
+
+/* PCA */
+
+/* Eigenvalues d and eigenvectors (columns of v) of the symmetric n x n
+ * matrix a, which is destroyed; cyclic Jacobi rotations. */
+static void jacobi(double *a, int n, double *d, double *v)
+{
+	int i, j, p, q, sweep;
+	double off, theta, t, c, s, tau, apq;
+
+	for (i = 0; i < n; i++)
+		for (j = 0; j < n; j++)
+			v[i * n + j] = i == j;
+	for (sweep = 0; sweep < TC_SWEEPS; sweep++) {
+		off = 0.;
+		for (p = 0; p < n; p++)
+			for (q = p + 1; q < n; q++)
+				off += a[p * n + q] * a[p * n + q];
+		if (off < 1e-30)
+			break;
+		for (p = 0; p < n; p++) {
+			for (q = p + 1; q < n; q++) {
+				apq = a[p * n + q];
+				if (fabs(apq) < 1e-300)
+					continue;
+				theta = (a[q * n + q] - a[p * n + p]) / (2. * apq);
+				t = (theta >= 0. ? 1. : -1.) / (fabs(theta) + sqrt(theta * theta + 1.));
+				c = 1. / sqrt(t * t + 1.);
+				s = t * c;
+				tau = s / (1. + c);
+				for (i = 0; i < n; i++) {
+					double aip = a[i * n + p], aiq = a[i * n + q];
+
+					a[i * n + p] = aip - s * (aiq + tau * aip);
+					a[i * n + q] = aiq + s * (aip - tau * aiq);
+				}
+				for (i = 0; i < n; i++) {
+					double api = a[p * n + i], aqi = a[q * n + i];
+
+					a[p * n + i] = api - s * (aqi + tau * api);
+					a[q * n + i] = aqi + s * (api - tau * aqi);
+				}
+				for (i = 0; i < n; i++) {
+					double vip = v[i * n + p], viq = v[i * n + q];
+
+					v[i * n + p] = vip - s * (viq + tau * vip);
+					v[i * n + q] = viq + s * (vip - tau * viq);
+				}
+			}
+		}
+	}
+	for (i = 0; i < n; i++)
+		d[i] = a[i * n + i];
+}
+
+/* Standard normal quantile (Acklam's rational approximation). */
+static double normq(double p)
+{
+	static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02,
+		-2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01,
+		2.506628277459239e+00};
+	static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02,
+		-1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01};
+	static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01,
+		-2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00,
+		2.938163982698783e+00};
+	static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01,
+		2.445134137142996e+00, 3.754408661907416e+00};
+	double q, r;
+
+	if (p < .02425) {
+		q = sqrt(-2. * log(p));
+		return (((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+			((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1.);
+	}
+	if (p > 1. - .02425)
+		return -normq(1. - p);
+	q = p - .5;
+	r = q * q;
+	return (((((a[0]*r + a[1])*r + a[2])*r + a[3])*r + a[4])*r + a[5])*q /
+		(((((b[0]*r + b[1])*r + b[2])*r + b[3])*r + b[4])*r + 1.);
+}
+
+int tc_pca(const TCAcc *acc, const int *vars, int k, double frac, double alpha,
+		TPModel **out)
+{
+	TPModel *p;
+	int m = acc->m, i, j, *order;
+	double *r, *v, *sd, *ev, total = 0., sum, th[3], h0, z, w;
+
+	*out = NULL;
+	if (acc->n < 2. || m > TP_MAX_VARS || k < 0 || k > m ||
+			!(alpha > 0. && alpha < 1.))
+		return TC_EARG;
+	r = (double *) malloc(((size_t) 2 * m * m + 2 * m) * sizeof(double));
+	order = (int *) malloc((size_t) m * sizeof(int));
+	if (!r || !order) {
+		free(r);
+		free(order);
+		return TC_ENOMEM;
+	}
+	v = r + (size_t) m * m;
+	sd = v + (size_t) m * m;
+	ev = sd + m;
+
+	/* Correlation matrix; constant variables are left at zero */
+	for (i = 0; i < m; i++)
+		sd[i] = sqrt(acc->m2[(size_t) i * m + i] / (acc->n - 1.));
+	for (i = 0; i < m; i++)
+		for (j = 0; j < m; j++)
+			r[i * m + j] = sd[i] > 0. && sd[j] > 0. ?
+				acc->m2[(size_t) i * m + j] / (acc->n - 1.) / (sd[i] * sd[j]) : 0.;
+	jacobi(r, m, ev, v);
+
+	/* Components by decreasing variance */
+	for (i = 0; i < m; i++)
+		order[i] = i;
+	for (i = 1; i < m; i++) {
+		int o = order[i];
+
+		for (j = i; j > 0 && ev[order[j - 1]] < ev[o]; j--)
+			order[j] = order[j - 1];
+		order[j] = o;
+	}
+	for (i = 0; i < m; i++)
+		total += ev[i] > 0. ? ev[i] : 0.;
+	if (k == 0) {
+		for (sum = 0.; k < m && sum < frac * total && ev[order[k]] > 0.; k++)
+			sum += ev[order[k]];
+		if (k == 0)
+			k = 1;
+	}
+
+	if (tp_model(m, k, &p) != TP_OK) {
+		free(r);
+		free(order);
+		return TC_ENOMEM;
+	}
+	for (i = 0; i < m; i++) {
+		p->vars[i] = vars[i];
+		p->mean[i] = acc->mean[i];
+		p->scale[i] = sd[i] > 0. ? sd[i] : 1.;
+	}
+	for (j = 0; j < k; j++) {
+		p->lambda[j] = ev[order[j]] > 1e-12 ? ev[order[j]] : 1e-12;
+		for (i = 0; i < m; i++)
+			p->pt[j * m + i] = v[i * m + order[j]];
+	}
+
+	/* Control limits */
+	z = normq(1. - alpha);
+	w = 2. / (9. * k);
+	p->t2lim = k * pow(1. - w + z * sqrt(w), 3.);
+	th[0] = th[1] = th[2] = 0.;
+	for (j = k; j < m; j++) {
+		double l = ev[order[j]] > 0. ? ev[order[j]] : 0.;
+
+		th[0] += l;
+		th[1] += l * l;
+		th[2] += l * l * l;
+	}
+	if (th[1] > 0.) {
+		h0 = 1. - 2. * th[0] * th[2] / (3. * th[1] * th[1]);
+		p->spelim = th[0] * pow(z * sqrt(2. * th[1] * h0 * h0) / th[0] + 1. +
+				th[1] * h0 * (h0 - 1.) / (th[0] * th[0]), 1. / h0);
+	} else
+		p->spelim = 1e-12;
+	free(r);
+	free(order);
+	*out = p;
+	return TC_OK;
+}
@@ -0,0 +1,66 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Mean and covariance accumulated over any number of samples, and a PCA
+ * model (tepca.h) fitted to them.
+ *
+ * Samples are added a block at a time: the block's own mean and
+ * co-moments are formed around the block mean and merged into the
+ * accumulator with the pairwise update of Chan, Golub and LeVeque, so
+ * that neither a large mean nor a long run costs precision. Accumulators
+ * filled on separate threads are combined with the same update
+ * (tc_merge). Memory is O(m^2) whatever the number of samples.
+ */
+
+#ifndef __TECOV_H__
+#define __TECOV_H__
+
+#include "tepca.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Status codes */
+#define TC_OK        0
+#define TC_ENOMEM   -1
+#define TC_EARG     -2
+
+typedef struct {
+	int m;
+	double n;               /* samples */
+	double *mean;           /* m */
+	double *m2;             /* m x m sums of products of deviations */
+	double *work;           /* m for a block mean */
+} TCAcc;
+
+int tc_init(TCAcc *acc, int m);
+void tc_free(TCAcc *acc);
+
+/* Adds n samples of y, column-major with leading dimension ld (m columns).
+ * Rows whose flag in use is zero are skipped; use may be NULL. */
+void tc_add(TCAcc *acc, const double *y, size_t ld, size_t n, const char *use);
+
+/* Adds the samples of b to a. */
+void tc_merge(TCAcc *a, const TCAcc *b);
+
+/* Fits a PCA model to the correlation matrix of the samples. vars are the
+ * run store columns of the m variables. k components are kept, or if k is
+ * 0 the fewest that explain the fraction frac of the variance. The control
+ * limits are for a false alarm rate alpha: T^2 from the chi-square
+ * distribution (Wilson-Hilferty), SPE after Jackson and Mudholkar.
+ * Variables that never change get scale 1 and do not contribute. */
+int tc_pca(const TCAcc *acc, const int *vars, int k, double frac, double alpha,
+		TPModel **out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TECOV_H__ */
@@ -0,0 +1,259 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Bank of univariate detectors, see tedetect.h. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tedetect.h"
+
+#define TD_LINE 1024
+
+struct TDBank {
+	TDConfig cfg;
+	double isigma[TE_NY];   /* 1/sigma, 0 for channels not monitored */
+	double elim[TE_NY];     /* EWMA limit */
+	double z[TE_NY], cp[TE_NY], cn[TE_NY], e[TE_NY];
+	int flags[TE_NY], next[TE_NY];
+	double talarm[3];
+	int calarm[3];
+};
+
+const char *td_strerror(int status)
+{
+	switch (status) {
+	case TD_OK:      return "no error";
+	case TD_EIO:     return "input/output error";
+	case TD_ESYNTAX: return "syntax error";
+	case TD_ENOMEM:  return "out of memory";
+	case TD_EARG:    return "invalid argument";
+	default:         return "unknown error";
+	}
+}
+
+void td_defaults(TDConfig *cfg)
+{
+	int c;
+
+	memset(cfg, 0, sizeof(*cfg));
+	for (c = 0; c < TE_NY; c++) {
+		cfg->k[c] = TD_CUSUM_K;
+		cfg->h[c] = TD_CUSUM_H;
+		cfg->lambda[c] = TD_EWMA_LAMBDA;
+		cfg->L[c] = TD_EWMA_L;
+		cfg->shewhart[c] = TD_SHEWHART_L;
+	}
+	cfg->detectors = TD_ALL;
+}
+
+/* One line: channel mean sigma [k h lambda L shewhart]. */
+static int parse(char *s, TDConfig *cfg)
+{
+	double v[8];
+	char *end;
+	int n, c;
+
+	for (n = 0; n < 8; n++) {
+		v[n] = strtod(s, &end);
+		if (end == s)
+			break;
+		s = end;
+	}
+	while (*s == ' ' || *s == '\t' || *s == '\r' || *s == '\n')
+		s++;
+	if (n == 0 && *s == '\0')
+		return TD_OK;
+	if (*s != '\0' || n < 3 || v[0] != floor(v[0]) || v[0] < 1 || v[0] > TE_NY ||
+			v[2] < 0.)
+		return TD_ESYNTAX;
+	c = (int) v[0] - 1;
+	cfg->mean[c] = v[1];
+	cfg->sigma[c] = v[2];
+	if (n > 3) cfg->k[c] = v[3];
+	if (n > 4) cfg->h[c] = v[4];
+	if (n > 5) cfg->lambda[c] = v[5];
+	if (n > 6) cfg->L[c] = v[6];
+	if (n > 7) cfg->shewhart[c] = v[7];
+	if (!(cfg->lambda[c] > 0. && cfg->lambda[c] <= 1.) || cfg->k[c] < 0. ||
+			!(cfg->h[c] > 0.) || !(cfg->L[c] > 0.) || !(cfg->shewhart[c] > 0.))
+		return TD_ESYNTAX;
+	return TD_OK;
+}
+
+int td_load(const char *path, TDConfig *cfg, int *line)
+{
+	FILE *fp;
+	char s[TD_LINE], *c;
+	int status = TD_OK;
+
+	*line = 0;
+	if (!(fp = fopen(path, "r")))
+		return TD_EIO;
+	while (status == TD_OK && fgets(s, TD_LINE, fp)) {
+		++*line;
+		if ((c = strchr(s, '#')))
+			*c = '\0';
+		status = parse(s, cfg);
+	}
+	if (status == TD_OK && ferror(fp))
+		status = TD_EIO;
+	fclose(fp);
+	if (status == TD_OK)
+		*line = 0;
+	return status;
+}
+
+int td_open(const TDConfig *cfg, TDBank **out)
+{
+	TDBank *bank;
+	int c;
+
+	*out = NULL;
+	for (c = 0; c < TE_NY; c++)
+		if (cfg->sigma[c] < 0. || !(cfg->lambda[c] > 0. && cfg->lambda[c] <= 1.))
+			return TD_EARG;
+	if (!(bank = (TDBank *) calloc(1, sizeof(TDBank))))
+		return TD_ENOMEM;
+	bank->cfg = *cfg;
+	for (c = 0; c < TE_NY; c++) {
+		bank->isigma[c] = cfg->sigma[c] > 0. ? 1. / cfg->sigma[c] : 0.;
+		bank->elim[c] = cfg->L[c] * sqrt(cfg->lambda[c] / (2. - cfg->lambda[c]));
+	}
+	td_reset(bank);
+	*out = bank;
+	return TD_OK;
+}
+
+void td_reset(TDBank *bank)
+{
+	int j;
+
+	memset(bank->z, 0, sizeof(bank->z));
+	memset(bank->cp, 0, sizeof(bank->cp));
+	memset(bank->cn, 0, sizeof(bank->cn));
+	memset(bank->e, 0, sizeof(bank->e));
+	memset(bank->flags, 0, sizeof(bank->flags));
+	for (j = 0; j < 3; j++) {
+		bank->talarm[j] = -1.;
+		bank->calarm[j] = 0;
+	}
+}
+
+static void fire(TDBank *bank, double t, int c, int detector, int sign, double stat)
+{
+	TDEvent ev;
+	int j = detector == TD_CUSUM ? 0 : detector == TD_EWMA ? 1 : 2;
+
+	if (bank->talarm[j] < 0.) {
+		bank->talarm[j] = t;
+		bank->calarm[j] = c + 1;
+	}
+	if (bank->cfg.event) {
+		ev.t = t;
+		ev.channel = c + 1;
+		ev.detector = detector;
+		ev.sign = sign;
+		ev.stat = stat;
+		bank->cfg.event(bank->cfg.ctx, &ev);
+	}
+}
+
+/* Raises the events of the alarms that went on in this sample and restarts
+ * the CUSUMs that alarmed. */
+static void events(TDBank *bank, double t)
+{
+	const TDConfig *cfg = &bank->cfg;
+	int c, on;
+
+	for (c = 0; c < TE_NY; c++) {
+		on = bank->next[c] & ~bank->flags[c];
+		if (on & TD_CUSUM) {
+			if (bank->cp[c] > cfg->h[c])
+				fire(bank, t, c, TD_CUSUM, 1, bank->cp[c]);
+			else
+				fire(bank, t, c, TD_CUSUM, -1, bank->cn[c]);
+		}
+		if (on & TD_EWMA)
+			fire(bank, t, c, TD_EWMA, bank->e[c] > 0. ? 1 : -1, bank->e[c]);
+		if (on & TD_SHEWHART)
+			fire(bank, t, c, TD_SHEWHART, bank->z[c] > 0. ? 1 : -1, bank->z[c]);
+		bank->flags[c] = bank->next[c];
+		if ((cfg->reset & TD_RESET) && (bank->next[c] & TD_CUSUM)) {
+			bank->cp[c] = bank->cn[c] = 0.;
+			bank->flags[c] &= ~TD_CUSUM;
+		}
+	}
+}
+
+int td_update(TDBank *bank, double t, const double *xmeas)
+{
+	const TDConfig *cfg = &bank->cfg;
+	const double *restrict mean = cfg->mean, *restrict isigma = bank->isigma;
+	const double *restrict k = cfg->k, *restrict h = cfg->h;
+	const double *restrict lambda = cfg->lambda, *restrict elim = bank->elim;
+	const double *restrict slim = cfg->shewhart;
+	double *restrict z = bank->z, *restrict cp = bank->cp;
+	double *restrict cn = bank->cn, *restrict e = bank->e;
+	const int *restrict flags = bank->flags;
+	int *restrict next = bank->next;
+	double zc, pc, nc;
+	int c, mask = cfg->detectors, any = 0, change = 0;
+
+	for (c = 0; c < TE_NY; c++) {
+		zc = (xmeas[c] - mean[c]) * isigma[c];
+		pc = cp[c] + zc - k[c];
+		nc = cn[c] - zc - k[c];
+		z[c] = zc;
+		cp[c] = pc > 0. ? pc : 0.;
+		cn[c] = nc > 0. ? nc : 0.;
+		e[c] += lambda[c] * (zc - e[c]);
+		next[c] = ((cp[c] > h[c]) | (cn[c] > h[c])) * TD_CUSUM |
+				(fabs(e[c]) > elim[c]) * TD_EWMA |
+				(fabs(z[c]) > slim[c]) * TD_SHEWHART;
+		next[c] &= mask;
+		any |= next[c];
+		change |= next[c] ^ flags[c];
+	}
+	if (change)
+		events(bank, t);
+	return any;
+}
+
+int td_flags(const TDBank *bank, int c)
+{
+	return c >= 1 && c <= TE_NY ? bank->flags[c - 1] : 0;
+}
+
+double td_alarm(const TDBank *bank, int detector, int *channel)
+{
+	int j = detector == TD_CUSUM ? 0 : detector == TD_EWMA ? 1 : 2;
+
+	if (channel)
+		*channel = bank->calarm[j];
+	return bank->talarm[j];
+}
+
+static int tdsample(void *ctx, double t, const double *xmeas, const double *xmv)
+{
+	(void) xmv;
+	td_update((TDBank *) ctx, t, xmeas);
+	return 0;
+}
+
+void td_sink(TDBank *bank, TESink *sink)
+{
+	sink->sample = tdsample;
+	sink->ctx = bank;
+}
+
+void td_close(TDBank *bank)
+{
+	free(bank);
+}
@@ -0,0 +1,128 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Bank of univariate detectors over the 41 xmeas channels.
+ *
+ * Every sample x of channel c is standardized with the channel's in-control
+ * mean and sigma, z = (x - mean) / sigma, and fed to three detectors:
+ *
+ *   CUSUM     c+ = max(0, c+ + z - k),  c- = max(0, c- - z - k),
+ *             alarm when c+ or c- exceeds h
+ *   EWMA      e = (1 - lambda) e + lambda z,
+ *             alarm when |e| exceeds L sqrt(lambda / (2 - lambda))
+ *   Shewhart  alarm when |z| exceeds its limit
+ *
+ * k, h, L and the Shewhart limit are in units of sigma. All parameters are
+ * per channel and stored as arrays, one entry per channel, so that a sample
+ * updates every statistic of every channel in one straight-line,
+ * branch-free loop, which the compiler vectorizes for AVX2 and wider (e.g.
+ * -O3 -march=native). Only samples that raise or clear an alarm take the
+ * slow path.
+ *
+ * An alarm is reported as an event (TDEvent) when it is raised, through the
+ * event callback of the configuration, and the first alarm of each detector
+ * is timed as in tepca.h. With TD_RESET a CUSUM that alarmed restarts from
+ * zero, so that a persistent shift raises an event about every h/(shift-k)
+ * samples instead of one that never clears.
+ *
+ * Channels with sigma 0 are not monitored. Parameter file: text, '#'
+ * starts a comment, one line per channel
+ *   channel mean sigma [k h lambda L shewhart]
+ * with channel 1..41; omitted tunings keep the defaults below.
+ */
+
+#ifndef __TEDETECT_H__
+#define __TEDETECT_H__
+
+#include "tesim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Detectors, also the alarm flags */
+#define TD_CUSUM     1
+#define TD_EWMA      2
+#define TD_SHEWHART  4
+#define TD_ALL       7
+
+/* Default tunings, in sigma */
+#define TD_CUSUM_K     0.5
+#define TD_CUSUM_H     5.
+#define TD_EWMA_LAMBDA 0.2
+#define TD_EWMA_L      3.
+#define TD_SHEWHART_L  4.
+
+/* Status codes */
+#define TD_OK        0
+#define TD_EIO      -1
+#define TD_ESYNTAX  -2
+#define TD_ENOMEM   -3
+#define TD_EARG     -4
+
+typedef struct {
+	double t;               /* hours */
+	int channel;            /* xmeas 1..41 */
+	int detector;           /* TD_CUSUM, TD_EWMA or TD_SHEWHART */
+	int sign;               /* direction of the shift, +1 or -1 */
+	double stat;            /* c+, c-, e or z at the alarm */
+} TDEvent;
+
+typedef void (*TDEventFn)(void *ctx, const TDEvent *ev);
+
+typedef struct {
+	double mean[TE_NY], sigma[TE_NY];
+	double k[TE_NY], h[TE_NY];
+	double lambda[TE_NY], L[TE_NY];
+	double shewhart[TE_NY];
+	int detectors;          /* TD_CUSUM | TD_EWMA | TD_SHEWHART */
+	int reset;              /* TD_RESET: restart a CUSUM after its alarm */
+	TDEventFn event;        /* may be NULL */
+	void *ctx;
+} TDConfig;
+
+#define TD_RESET 1
+
+typedef struct TDBank TDBank;
+
+const char *td_strerror(int status);
+
+/* Default tunings, all detectors, no reset, no channel monitored. */
+void td_defaults(TDConfig *cfg);
+
+/* Reads the channel lines of a parameter file into cfg. On TD_ESYNTAX,
+ * *line is the offending line. */
+int td_load(const char *path, TDConfig *cfg, int *line);
+
+/* The bank copies cfg. */
+int td_open(const TDConfig *cfg, TDBank **out);
+
+/* Updates all channels with the sample at time t; returns the detectors
+ * in alarm on any channel. */
+int td_update(TDBank *bank, double t, const double *xmeas);
+
+/* Alarm flags of channel c (1..41). */
+int td_flags(const TDBank *bank, int c);
+
+/* Time of the first alarm of a detector on any channel, negative if none
+ * yet; *channel (may be NULL) receives its channel. */
+double td_alarm(const TDBank *bank, int detector, int *channel);
+
+/* Zeroes all statistics and clears the alarms for a new run. */
+void td_reset(TDBank *bank);
+
+/* A sink that feeds the bank, for TESimConfig.monitor. */
+void td_sink(TDBank *bank, TESink *sink);
+
+void td_close(TDBank *bank);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TEDETECT_H__ */
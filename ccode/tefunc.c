@@ -0,0 +1,653 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Kernel of tefunc, included by tecore.c once per configuration:
+ *
+ *   TE_KERNEL  name of the kernel
+ *   TE_DIST    1: disturbances as in dvec.idv, 0: all disturbances off,
+ *              their terms folded away at compile time
+ *
+ * The disturbance codes are normalized and the walk flags derived when they
+ * change (teidv), not on every call.
+ *
+ * With yp NULL the kernel evaluates the outputs only: it stops after the
+ * measurements, before the derivatives and the valve commands, the only
+ * part of the plant that reads xmv.
+ */
+
+#if TE_DIST
+#define TE_IDV(k)     (te->dvec.idv[k])
+#define TE_STICKY(i)  (te->teproc.vst[i] * te->teproc.ivst[i])
+#else
+#define TE_IDV(k)     0
+#define TE_STICKY(i)  0.
+#endif
+
+static int TE_KERNEL(TEPlant *te, const integer *nn, doublereal *time, doublereal *yy, doublereal *yp)
+{
+    /* System generated locals */
+    integer i__1;
+    doublereal d__1;
+
+    /* Local variables */
+    doublereal flms, xcmp[41], hwlk, vpos[12], swlk;
+#if TE_NOISE
+    doublereal xmns;
+#endif
+    integer i__;
+    doublereal spwlk, vovrl;
+    doublereal rg, flcoef, pr, tmpfac, uarlev, r1f, r2f, uac, fin[8];
+#define isd (&te->dvec.idv[20])
+    doublereal dlp, vpr, uas;
+    TE_STATS_TIMER(tick)
+
+    /* Parameter adjustments */
+    if (yp) {
+	--yp;
+    }
+    --yy;
+
+    /* Function Body */
+    TE_STATS_COUNT(te->stats, tefunc);
+    for (i__ = 1; i__ <= 9; ++i__) {
+	if (*time >= te->wlk.tnext[i__ - 1]) {
+	    hwlk = te->wlk.tnext[i__ - 1] - te->wlk.tlast[i__ - 1];
+	    swlk = te->wlk.adist[i__ - 1] + hwlk * (te->wlk.bdist[i__ - 1] + hwlk 
+		    * (te->wlk.cdist[i__ - 1] + hwlk * te->wlk.ddist[i__ - 1]));
+	    spwlk = te->wlk.bdist[i__ - 1] + hwlk * (te->wlk.cdist[i__ - 1] * 2. 
+		    + hwlk * 3. * te->wlk.ddist[i__ - 1]);
+	    te->wlk.tlast[i__ - 1] = te->wlk.tnext[i__ - 1];
+	    tesub5_(te, &swlk, &spwlk, &te->wlk.adist[i__ - 1], &te->wlk.bdist[i__ - 
+		    1], &te->wlk.cdist[i__ - 1], &te->wlk.ddist[i__ - 1], &
+		    te->wlk.tlast[i__ - 1], &te->wlk.tnext[i__ - 1], &te->wlk.hspan[
+		    i__ - 1], &te->wlk.hzero[i__ - 1], &te->wlk.sspan[i__ - 1], &
+		    te->wlk.szero[i__ - 1], &te->wlk.spspan[i__ - 1], &
+		    te->wlk.idvwlk[i__ - 1]);
+	}
+/* L900: */
+    }
+    for (i__ = 10; i__ <= 12; ++i__) {
+	if (*time >= te->wlk.tnext[i__ - 1]) {
+	    hwlk = te->wlk.tnext[i__ - 1] - te->wlk.tlast[i__ - 1];
+	    swlk = te->wlk.adist[i__ - 1] + hwlk * (te->wlk.bdist[i__ - 1] + hwlk 
+		    * (te->wlk.cdist[i__ - 1] + hwlk * te->wlk.ddist[i__ - 1]));
+	    spwlk = te->wlk.bdist[i__ - 1] + hwlk * (te->wlk.cdist[i__ - 1] * 2. 
+		    + hwlk * 3. * te->wlk.ddist[i__ - 1]);
+	    te->wlk.tlast[i__ - 1] = te->wlk.tnext[i__ - 1];
+	    if (swlk > .1) {
+		te->wlk.adist[i__ - 1] = swlk;
+		te->wlk.bdist[i__ - 1] = spwlk;
+		te->wlk.cdist[i__ - 1] = -(swlk * 3. + spwlk * .2) / .01;
+		te->wlk.ddist[i__ - 1] = (swlk * 2. + spwlk * .1) / .001;
+		te->wlk.tnext[i__ - 1] = te->wlk.tlast[i__ - 1] + .1;
+	    } else {
+		*isd = -1;
+		hwlk = te->wlk.hspan[i__ - 1] * tesub7_(te, isd) + te->wlk.hzero[i__ 
+			- 1];
+		te->wlk.adist[i__ - 1] = 0.;
+		te->wlk.bdist[i__ - 1] = 0.;
+/* Computing 2nd power */
+		d__1 = hwlk;
+		te->wlk.cdist[i__ - 1] = (doublereal) te->wlk.idvwlk[i__ - 1] / (
+			d__1 * d__1);
+		te->wlk.ddist[i__ - 1] = 0.;
+		te->wlk.tnext[i__ - 1] = te->wlk.tlast[i__ - 1] + hwlk;
+	    }
+	}
+/* L910: */
+    }
+    if (*time == 0.) {
+	for (i__ = 1; i__ <= 12; ++i__) {
+	    te->wlk.adist[i__ - 1] = te->wlk.szero[i__ - 1];
+	    te->wlk.bdist[i__ - 1] = 0.;
+	    te->wlk.cdist[i__ - 1] = 0.;
+	    te->wlk.ddist[i__ - 1] = 0.;
+	    te->wlk.tlast[i__ - 1] = 0.;
+	    te->wlk.tnext[i__ - 1] = .1;
+/* L950: */
+	}
+    }
+    TE_STATS_LAP(te->stats, TE_PH_WALKS, tick);
+    te->teproc.esr = te->teproc.etr / te->teproc.utlr;
+    te->teproc.xst[24] = tesub8_(te, &c__1, time) - TE_IDV(0) * .03 - 
+	    TE_IDV(1) * .00243719;
+    te->teproc.xst[25] = tesub8_(te, &c__2, time) + TE_IDV(1) * .005;
+    te->teproc.xst[26] = 1. - te->teproc.xst[24] - te->teproc.xst[25];
+    te->teproc.tst[0] = tesub8_(te, &c__3, time) + TE_IDV(2) * 5.;
+    te->teproc.tst[3] = tesub8_(te, &c__4, time);
+    te->teproc.tcwr = tesub8_(te, &c__5, time) + TE_IDV(3) * 5.;
+    te->teproc.tcws = tesub8_(te, &c__6, time) + TE_IDV(4) * 5.;
+    r1f = tesub8_(te, &c__7, time);
+    r2f = tesub8_(te, &c__8, time);
+    for (i__ = 1; i__ <= 3; ++i__) {
+	te->teproc.ucvr[i__ - 1] = yy[i__];
+	te->teproc.ucvs[i__ - 1] = yy[i__ + 9];
+	te->teproc.uclr[i__ - 1] = (float)0.;
+	te->teproc.ucls[i__ - 1] = (float)0.;
+/* L1010: */
+    }
+    for (i__ = 4; i__ <= 8; ++i__) {
+	te->teproc.uclr[i__ - 1] = yy[i__];
+	te->teproc.ucls[i__ - 1] = yy[i__ + 9];
+/* L1020: */
+    }
+    for (i__ = 1; i__ <= 8; ++i__) {
+	te->teproc.uclc[i__ - 1] = yy[i__ + 18];
+	te->teproc.ucvv[i__ - 1] = yy[i__ + 27];
+/* L1030: */
+    }
+    te->teproc.etr = yy[9];
+    te->teproc.ets = yy[18];
+    te->teproc.etc = yy[27];
+    te->teproc.etv = yy[36];
+    te->teproc.twr = yy[37];
+    te->teproc.tws = yy[38];
+    for (i__ = 1; i__ <= 12; ++i__) {
+	vpos[i__ - 1] = yy[i__ + 38];
+/* L1035: */
+    }
+    te->teproc.utlr = (float)0.;
+    te->teproc.utls = (float)0.;
+    te->teproc.utlc = (float)0.;
+    te->teproc.utvv = (float)0.;
+    for (i__ = 1; i__ <= 8; ++i__) {
+	te->teproc.utlr += te->teproc.uclr[i__ - 1];
+	te->teproc.utls += te->teproc.ucls[i__ - 1];
+	te->teproc.utlc += te->teproc.uclc[i__ - 1];
+	te->teproc.utvv += te->teproc.ucvv[i__ - 1];
+/* L1040: */
+    }
+    for (i__ = 1; i__ <= 8; ++i__) {
+	te->teproc.xlr[i__ - 1] = te->teproc.uclr[i__ - 1] / te->teproc.utlr;
+	te->teproc.xls[i__ - 1] = te->teproc.ucls[i__ - 1] / te->teproc.utls;
+	te->teproc.xlc[i__ - 1] = te->teproc.uclc[i__ - 1] / te->teproc.utlc;
+	te->teproc.xvv[i__ - 1] = te->teproc.ucvv[i__ - 1] / te->teproc.utvv;
+/* L1050: */
+    }
+	te->teproc.esr = te->teproc.etr / te->teproc.utlr;
+    te->teproc.ess = te->teproc.ets / te->teproc.utls;
+    te->teproc.esc = te->teproc.etc / te->teproc.utlc;
+    te->teproc.esv = te->teproc.etv / te->teproc.utvv;
+    tesub2_(te, te->teproc.xlr, &te->teproc.tcr, &te->teproc.esr, &c__0);
+    te->teproc.tkr = te->teproc.tcr + (float)273.15;
+    tesub2_(te, te->teproc.xls, &te->teproc.tcs, &te->teproc.ess, &c__0);
+    te->teproc.tks = te->teproc.tcs + (float)273.15;
+    tesub2_(te, te->teproc.xlc, &te->teproc.tcc, &te->teproc.esc, &c__0);
+    tesub2_(te, te->teproc.xvv, &te->teproc.tcv, &te->teproc.esv, &c__2);
+    te->teproc.tkv = te->teproc.tcv + (float)273.15;
+    tesub4_(te, te->teproc.xlr, &te->teproc.tcr, &te->teproc.dlr);
+    tesub4_(te, te->teproc.xls, &te->teproc.tcs, &te->teproc.dls);
+    tesub4_(te, te->teproc.xlc, &te->teproc.tcc, &te->teproc.dlc);
+    te->teproc.vlr = te->teproc.utlr / te->teproc.dlr;
+    te->teproc.vls = te->teproc.utls / te->teproc.dls;
+    te->teproc.vlc = te->teproc.utlc / te->teproc.dlc;
+    te->teproc.vvr = te->teproc.vtr - te->teproc.vlr;
+    te->teproc.vvs = te->teproc.vts - te->teproc.vls;
+    rg = (float)998.9;
+    te->teproc.ptr = (float)0.;
+    te->teproc.pts = (float)0.;
+    for (i__ = 1; i__ <= 3; ++i__) {
+	te->teproc.ppr[i__ - 1] = te->teproc.ucvr[i__ - 1] * rg * te->teproc.tkr / 
+		te->teproc.vvr;
+	te->teproc.ptr += te->teproc.ppr[i__ - 1];
+	te->teproc.pps[i__ - 1] = te->teproc.ucvs[i__ - 1] * rg * te->teproc.tks / 
+		te->teproc.vvs;
+	te->teproc.pts += te->teproc.pps[i__ - 1];
+/* L1110: */
+    }
+    for (i__ = 4; i__ <= 8; ++i__) {
+	vpr = exp(te->const_.avp[i__ - 1] + te->const_.bvp[i__ - 1] / (te->teproc.tcr 
+		+ te->const_.cvp[i__ - 1]));
+	te->teproc.ppr[i__ - 1] = vpr * te->teproc.xlr[i__ - 1];
+	te->teproc.ptr += te->teproc.ppr[i__ - 1];
+	vpr = exp(te->const_.avp[i__ - 1] + te->const_.bvp[i__ - 1] / (te->teproc.tcs 
+		+ te->const_.cvp[i__ - 1]));
+	te->teproc.pps[i__ - 1] = vpr * te->teproc.xls[i__ - 1];
+	te->teproc.pts += te->teproc.pps[i__ - 1];
+/* L1120: */
+    }
+    te->teproc.ptv = te->teproc.utvv * rg * te->teproc.tkv / te->teproc.vtv;
+    for (i__ = 1; i__ <= 8; ++i__) {
+	te->teproc.xvr[i__ - 1] = te->teproc.ppr[i__ - 1] / te->teproc.ptr;
+	te->teproc.xvs[i__ - 1] = te->teproc.pps[i__ - 1] / te->teproc.pts;
+/* L1130: */
+    }
+    te->teproc.utvr = te->teproc.ptr * te->teproc.vvr / rg / te->teproc.tkr;
+    te->teproc.utvs = te->teproc.pts * te->teproc.vvs / rg / te->teproc.tks;
+    for (i__ = 4; i__ <= 8; ++i__) {
+	te->teproc.ucvr[i__ - 1] = te->teproc.utvr * te->teproc.xvr[i__ - 1];
+	te->teproc.ucvs[i__ - 1] = te->teproc.utvs * te->teproc.xvs[i__ - 1];
+/* L1140: */
+    }
+    te->teproc.rr[0] = exp((float)31.5859536 - (float)20130.85052843482 / 
+	    te->teproc.tkr) * r1f;
+    te->teproc.rr[1] = exp((float)3.00094014 - (float)10065.42526421741 / 
+	    te->teproc.tkr) * r2f;
+    te->teproc.rr[2] = exp((float)53.4060443 - (float)30196.27579265224 / 
+	    te->teproc.tkr);
+    te->teproc.rr[3] = te->teproc.rr[2] * .767488334;
+    if (te->teproc.ppr[0] > (float)0. && te->teproc.ppr[2] > (float)0.) {
+	r1f = pow_dd(te->teproc.ppr, &c_b73);
+	r2f = pow_dd(&te->teproc.ppr[2], &c_b74);
+	te->teproc.rr[0] = te->teproc.rr[0] * r1f * r2f * te->teproc.ppr[3];
+	te->teproc.rr[1] = te->teproc.rr[1] * r1f * r2f * te->teproc.ppr[4];
+    } else {
+	te->teproc.rr[0] = (float)0.;
+	te->teproc.rr[1] = (float)0.;
+    }
+    te->teproc.rr[2] = te->teproc.rr[2] * te->teproc.ppr[0] * te->teproc.ppr[4];
+    te->teproc.rr[3] = te->teproc.rr[3] * te->teproc.ppr[0] * te->teproc.ppr[3];
+    for (i__ = 1; i__ <= 4; ++i__) {
+	te->teproc.rr[i__ - 1] *= te->teproc.vvr;
+/* L1200: */
+    }
+    te->teproc.crxr[0] = -te->teproc.rr[0] - te->teproc.rr[1] - te->teproc.rr[2];
+    te->teproc.crxr[2] = -te->teproc.rr[0] - te->teproc.rr[1];
+    te->teproc.crxr[3] = -te->teproc.rr[0] - te->teproc.rr[3] * 1.5;
+    te->teproc.crxr[4] = -te->teproc.rr[1] - te->teproc.rr[2];
+    te->teproc.crxr[5] = te->teproc.rr[2] + te->teproc.rr[3];
+    te->teproc.crxr[6] = te->teproc.rr[0];
+    te->teproc.crxr[7] = te->teproc.rr[1];
+    te->teproc.rh = te->teproc.rr[0] * te->teproc.htr[0] + te->teproc.rr[1] * 
+	    te->teproc.htr[1];
+    te->teproc.xmws[0] = (float)0.;
+    te->teproc.xmws[1] = (float)0.;
+    te->teproc.xmws[5] = (float)0.;
+    te->teproc.xmws[7] = (float)0.;
+    te->teproc.xmws[8] = (float)0.;
+    te->teproc.xmws[9] = (float)0.;
+    for (i__ = 1; i__ <= 8; ++i__) {
+	te->teproc.xst[i__ + 39] = te->teproc.xvv[i__ - 1];
+	te->teproc.xst[i__ + 55] = te->teproc.xvr[i__ - 1];
+	te->teproc.xst[i__ + 63] = te->teproc.xvs[i__ - 1];
+	te->teproc.xst[i__ + 71] = te->teproc.xvs[i__ - 1];
+	te->teproc.xst[i__ + 79] = te->teproc.xls[i__ - 1];
+	te->teproc.xst[i__ + 95] = te->teproc.xlc[i__ - 1];
+	te->teproc.xmws[0] += te->teproc.xst[i__ - 1] * te->const_.xmw[i__ - 1];
+	te->teproc.xmws[1] += te->teproc.xst[i__ + 7] * te->const_.xmw[i__ - 1];
+	te->teproc.xmws[5] += te->teproc.xst[i__ + 39] * te->const_.xmw[i__ - 1];
+	te->teproc.xmws[7] += te->teproc.xst[i__ + 55] * te->const_.xmw[i__ - 1];
+	te->teproc.xmws[8] += te->teproc.xst[i__ + 63] * te->const_.xmw[i__ - 1];
+	te->teproc.xmws[9] += te->teproc.xst[i__ + 71] * te->const_.xmw[i__ - 1];
+/* L2010: */
+    }
+    te->teproc.tst[5] = te->teproc.tcv;
+    te->teproc.tst[7] = te->teproc.tcr;
+    te->teproc.tst[8] = te->teproc.tcs;
+    te->teproc.tst[9] = te->teproc.tcs;
+    te->teproc.tst[10] = te->teproc.tcs;
+    te->teproc.tst[12] = te->teproc.tcc;
+    tesub1_(te, te->teproc.xst, te->teproc.tst, te->teproc.hst, &c__1);
+    tesub1_(te, &te->teproc.xst[8], &te->teproc.tst[1], &te->teproc.hst[1], &c__1);
+    tesub1_(te, &te->teproc.xst[16], &te->teproc.tst[2], &te->teproc.hst[2], &c__1);
+    tesub1_(te, &te->teproc.xst[24], &te->teproc.tst[3], &te->teproc.hst[3], &c__1);
+    tesub1_(te, &te->teproc.xst[40], &te->teproc.tst[5], &te->teproc.hst[5], &c__1);
+    tesub1_(te, &te->teproc.xst[56], &te->teproc.tst[7], &te->teproc.hst[7], &c__1);
+    tesub1_(te, &te->teproc.xst[64], &te->teproc.tst[8], &te->teproc.hst[8], &c__1);
+    te->teproc.hst[9] = te->teproc.hst[8];
+    tesub1_(te, &te->teproc.xst[80], &te->teproc.tst[10], &te->teproc.hst[10], &c__0);
+    tesub1_(te, &te->teproc.xst[96], &te->teproc.tst[12], &te->teproc.hst[12], &c__0);
+    TE_STATS_LAP(te->stats, TE_PH_THERMO, tick);
+    te->teproc.ftm[0] = vpos[0] * te->teproc.vrng[0] / (float)100.;
+    te->teproc.ftm[1] = vpos[1] * te->teproc.vrng[1] / (float)100.;
+    te->teproc.ftm[2] = vpos[2] * (1. - TE_IDV(5)) * te->teproc.vrng[2] / (
+	    float)100.;
+    te->teproc.ftm[3] = vpos[3] * (1. - TE_IDV(6) * .2) * te->teproc.vrng[3] /
+	     (float)100. + 1e-10;
+    te->teproc.ftm[10] = vpos[6] * te->teproc.vrng[6] / (float)100.;
+    te->teproc.ftm[12] = vpos[7] * te->teproc.vrng[7] / (float)100.;
+    uac = vpos[8] * te->teproc.vrng[8] * (tesub8_(te, &c__9, time) + 1.) / (float)
+	    100.;
+    te->teproc.fwr = vpos[9] * te->teproc.vrng[9] / (float)100.;
+    te->teproc.fws = vpos[10] * te->teproc.vrng[10] / (float)100.;
+    te->teproc.agsp = (vpos[11] + (float)150.) / (float)100.;
+    dlp = te->teproc.ptv - te->teproc.ptr;
+    if (dlp < (float)0.) {
+	dlp = (float)0.;
+    }
+    flms = sqrt(dlp) * 1937.6;
+    te->teproc.ftm[5] = flms / te->teproc.xmws[5];
+    dlp = te->teproc.ptr - te->teproc.pts;
+    if (dlp < (float)0.) {
+	dlp = (float)0.;
+    }
+    flms = sqrt(dlp) * 4574.21 * (1. - tesub8_(te, &c__12, time) * .25);
+    te->teproc.ftm[7] = flms / te->teproc.xmws[7];
+    dlp = te->teproc.pts - (float)760.;
+    if (dlp < (float)0.) {
+	dlp = (float)0.;
+    }
+    flms = vpos[5] * .151169 * sqrt(dlp);
+    te->teproc.ftm[9] = flms / te->teproc.xmws[9];
+    pr = te->teproc.ptv / te->teproc.pts;
+    if (pr < (float)1.) {
+	pr = (float)1.;
+    }
+    if (pr > te->teproc.cpprmx) {
+	pr = te->teproc.cpprmx;
+    }
+    flcoef = te->teproc.cpflmx / 1.197;
+/* Computing 3rd power */
+    d__1 = pr;
+    flms = te->teproc.cpflmx + flcoef * ((float)1. - d__1 * (d__1 * d__1));
+    te->teproc.cpdh = flms * (te->teproc.tcs + 273.15) * 1.8e-6 * 1.9872 * (
+	    te->teproc.ptv - te->teproc.pts) / (te->teproc.xmws[8] * te->teproc.pts);
+    dlp = te->teproc.ptv - te->teproc.pts;
+    if (dlp < (float)0.) {
+	dlp = (float)0.;
+    }
+    flms -= vpos[4] * 53.349 * sqrt(dlp);
+    if (flms < .001) {
+	flms = .001;
+    }
+    te->teproc.ftm[8] = flms / te->teproc.xmws[8];
+    te->teproc.hst[8] += te->teproc.cpdh / te->teproc.ftm[8];
+    for (i__ = 1; i__ <= 8; ++i__) {
+	te->teproc.fcm[i__ - 1] = te->teproc.xst[i__ - 1] * te->teproc.ftm[0];
+	te->teproc.fcm[i__ + 7] = te->teproc.xst[i__ + 7] * te->teproc.ftm[1];
+	te->teproc.fcm[i__ + 15] = te->teproc.xst[i__ + 15] * te->teproc.ftm[2];
+	te->teproc.fcm[i__ + 23] = te->teproc.xst[i__ + 23] * te->teproc.ftm[3];
+	te->teproc.fcm[i__ + 39] = te->teproc.xst[i__ + 39] * te->teproc.ftm[5];
+	te->teproc.fcm[i__ + 55] = te->teproc.xst[i__ + 55] * te->teproc.ftm[7];
+	te->teproc.fcm[i__ + 63] = te->teproc.xst[i__ + 63] * te->teproc.ftm[8];
+	te->teproc.fcm[i__ + 71] = te->teproc.xst[i__ + 71] * te->teproc.ftm[9];
+	te->teproc.fcm[i__ + 79] = te->teproc.xst[i__ + 79] * te->teproc.ftm[10];
+	te->teproc.fcm[i__ + 95] = te->teproc.xst[i__ + 95] * te->teproc.ftm[12];
+/* L5020: */
+    }
+    if (te->teproc.ftm[10] > (float).1) {
+	if (te->teproc.tcc > (float)170.) {
+	    tmpfac = te->teproc.tcc - (float)120.262;
+	} else if (te->teproc.tcc < (float)5.292) {
+	    tmpfac = (float).1;
+	} else {
+	    tmpfac = (float)363.744 / ((float)177. - te->teproc.tcc) - (float)
+		    2.22579488;
+	}
+	vovrl = te->teproc.ftm[3] / te->teproc.ftm[10] * tmpfac;
+	te->teproc.sfr[3] = vovrl * (float)8.501 / (vovrl * (float)8.501 + (
+		float)1.);
+	te->teproc.sfr[4] = vovrl * (float)11.402 / (vovrl * (float)11.402 + (
+		float)1.);
+	te->teproc.sfr[5] = vovrl * (float)11.795 / (vovrl * (float)11.795 + (
+		float)1.);
+	te->teproc.sfr[6] = vovrl * (float).048 / (vovrl * (float).048 + (float)
+		1.);
+	te->teproc.sfr[7] = vovrl * (float).0242 / (vovrl * (float).0242 + (
+		float)1.);
+    } else {
+	te->teproc.sfr[3] = (float).9999;
+	te->teproc.sfr[4] = (float).999;
+	te->teproc.sfr[5] = (float).999;
+	te->teproc.sfr[6] = (float).99;
+	te->teproc.sfr[7] = (float).98;
+    }
+    for (i__ = 1; i__ <= 8; ++i__) {
+	fin[i__ - 1] = (float)0.;
+	fin[i__ - 1] += te->teproc.fcm[i__ + 23];
+	fin[i__ - 1] += te->teproc.fcm[i__ + 79];
+/* L6010: */
+    }
+    te->teproc.ftm[4] = (float)0.;
+    te->teproc.ftm[11] = (float)0.;
+    for (i__ = 1; i__ <= 8; ++i__) {
+	te->teproc.fcm[i__ + 31] = te->teproc.sfr[i__ - 1] * fin[i__ - 1];
+	te->teproc.fcm[i__ + 87] = fin[i__ - 1] - te->teproc.fcm[i__ + 31];
+	te->teproc.ftm[4] += te->teproc.fcm[i__ + 31];
+	te->teproc.ftm[11] += te->teproc.fcm[i__ + 87];
+/* L6020: */
+    }
+    for (i__ = 1; i__ <= 8; ++i__) {
+	te->teproc.xst[i__ + 31] = te->teproc.fcm[i__ + 31] / te->teproc.ftm[4];
+	te->teproc.xst[i__ + 87] = te->teproc.fcm[i__ + 87] / te->teproc.ftm[11];
+/* L6030: */
+    }
+    te->teproc.tst[4] = te->teproc.tcc;
+    te->teproc.tst[11] = te->teproc.tcc;
+    tesub1_(te, &te->teproc.xst[32], &te->teproc.tst[4], &te->teproc.hst[4], &c__1);
+    tesub1_(te, &te->teproc.xst[88], &te->teproc.tst[11], &te->teproc.hst[11], &c__0);
+    te->teproc.ftm[6] = te->teproc.ftm[5];
+    te->teproc.hst[6] = te->teproc.hst[5];
+    te->teproc.tst[6] = te->teproc.tst[5];
+    for (i__ = 1; i__ <= 8; ++i__) {
+	te->teproc.xst[i__ + 47] = te->teproc.xst[i__ + 39];
+	te->teproc.fcm[i__ + 47] = te->teproc.fcm[i__ + 39];
+/* L6130: */
+    }
+    if (te->teproc.vlr / (float)7.8 > (float)50.) {
+	uarlev = (float)1.;
+    } else if (te->teproc.vlr / (float)7.8 < (float)10.) {
+	uarlev = (float)0.;
+    } else {
+	uarlev = te->teproc.vlr * (float).025 / (float)7.8 - (float).25;
+    }
+/* Computing 2nd power */
+    d__1 = te->teproc.agsp;
+    te->teproc.uar = uarlev * (d__1 * d__1 * (float)-.5 + te->teproc.agsp * (
+	    float)2.75 - (float)2.5) * .85549;
+    te->teproc.qur = te->teproc.uar * (te->teproc.twr - te->teproc.tcr) * (1. - 
+	    tesub8_(te, &c__10, time) * .35);
+/* Computing 4th power */
+    d__1 = te->teproc.ftm[7] / (float)3528.73, d__1 *= d__1;
+    uas = ((float)1. - (float)1. / (d__1 * d__1 + (float)1.)) * (float)
+	    .404655;
+    te->teproc.qus = uas * (te->teproc.tws - te->teproc.tst[7]) * (1. - tesub8_(te, 
+	    &c__11, time) * .25);
+    te->teproc.quc = 0.;
+    if (te->teproc.tcc < (float)100.) {
+	te->teproc.quc = uac * ((float)100. - te->teproc.tcc);
+    }
+    TE_STATS_LAP(te->stats, TE_PH_FLOWS, tick);
+    te->pv.xmeas[0] = te->teproc.ftm[2] * (float).359 / (float)35.3145;
+    te->pv.xmeas[1] = te->teproc.ftm[0] * te->teproc.xmws[0] * (float).454;
+    te->pv.xmeas[2] = te->teproc.ftm[1] * te->teproc.xmws[1] * (float).454;
+    te->pv.xmeas[3] = te->teproc.ftm[3] * (float).359 / (float)35.3145;
+    te->pv.xmeas[4] = te->teproc.ftm[8] * (float).359 / (float)35.3145;
+    te->pv.xmeas[5] = te->teproc.ftm[5] * (float).359 / (float)35.3145;
+    te->pv.xmeas[6] = (te->teproc.ptr - (float)760.) / (float)760. * (float)
+	    101.325;
+    te->pv.xmeas[7] = (te->teproc.vlr - (float)84.6) / (float)666.7 * (float)100.;
+    te->pv.xmeas[8] = te->teproc.tcr;
+    te->pv.xmeas[9] = te->teproc.ftm[9] * (float).359 / (float)35.3145;
+    te->pv.xmeas[10] = te->teproc.tcs;
+    te->pv.xmeas[11] = (te->teproc.vls - (float)27.5) / (float)290. * (float)100.;
+    te->pv.xmeas[12] = (te->teproc.pts - (float)760.) / (float)760. * (float)
+	    101.325;
+    te->pv.xmeas[13] = te->teproc.ftm[10] / te->teproc.dls / (float)35.3145;
+    te->pv.xmeas[14] = (te->teproc.vlc - (float)78.25) / te->teproc.vtc * (float)
+	    100.;
+    te->pv.xmeas[15] = (te->teproc.ptv - (float)760.) / (float)760. * (float)
+	    101.325;
+    te->pv.xmeas[16] = te->teproc.ftm[12] / te->teproc.dlc / (float)35.3145;
+    te->pv.xmeas[17] = te->teproc.tcc;
+    te->pv.xmeas[18] = te->teproc.quc * 1040. * (float).454;
+    te->pv.xmeas[19] = te->teproc.cpdh * 392.7;
+    te->pv.xmeas[19] = te->teproc.cpdh * 293.07;
+    te->pv.xmeas[20] = te->teproc.twr;
+    te->pv.xmeas[21] = te->teproc.tws;
+    *isd = 0;
+    if (te->pv.xmeas[6] > (float)3e3) {
+	*isd = 1;
+	sprintf(te->msg,"High Reactor Pressure!!  Shutting down.");
+    }
+    if (te->teproc.vlr / (float)35.3145 > (float)24.) {
+	*isd = 2;
+	sprintf(te->msg,"High Reactor Liquid Level!!  Shutting down.");
+    }
+    if (te->teproc.vlr / (float)35.3145 < (float)2.) {
+	*isd = 3;
+	sprintf(te->msg,"Low Reactor Liquid Level!!  Shutting down.");
+    }
+    if (te->pv.xmeas[8] > (float)175.) {
+	sprintf(te->msg,"High Reactor Temperature!!  Shutting down.");
+	*isd = 4;
+    }
+    if (te->teproc.vls / (float)35.3145 > (float)12.) {
+	*isd = 5;
+	sprintf(te->msg,"High Separator Liquid Level!!  Shutting down.");
+    }
+    if (te->teproc.vls / (float)35.3145 < (float)1.) {
+	*isd = 6;
+	sprintf(te->msg,"Low Separator Liquid Level!!  Shutting down.");
+    }
+    if (te->teproc.vlc / (float)35.3145 > (float)8.) {
+	sprintf(te->msg,"High Stripper Liquid Level!!  Shutting down.");
+	*isd = 7;
+    }
+    if (te->teproc.vlc / (float)35.3145 < (float)1.) {
+	*isd = 8;
+	sprintf(te->msg,"Low Stripper Liquid Level!!  Shutting down.");
+    }
+#if TE_NOISE
+    if (*time > (float)0. && *isd == 0) {
+	for (i__ = 1; i__ <= 22; ++i__) {
+	    tesub6_(te, &te->teproc.xns[i__ - 1], &xmns);
+	    te->pv.xmeas[i__ - 1] += xmns;
+/* L6500: */
+	}
+    }
+#endif
+    xcmp[22] = te->teproc.xst[48] * (float)100.;
+    xcmp[23] = te->teproc.xst[49] * (float)100.;
+    xcmp[24] = te->teproc.xst[50] * (float)100.;
+    xcmp[25] = te->teproc.xst[51] * (float)100.;
+    xcmp[26] = te->teproc.xst[52] * (float)100.;
+    xcmp[27] = te->teproc.xst[53] * (float)100.;
+    xcmp[28] = te->teproc.xst[72] * (float)100.;
+    xcmp[29] = te->teproc.xst[73] * (float)100.;
+    xcmp[30] = te->teproc.xst[74] * (float)100.;
+    xcmp[31] = te->teproc.xst[75] * (float)100.;
+    xcmp[32] = te->teproc.xst[76] * (float)100.;
+    xcmp[33] = te->teproc.xst[77] * (float)100.;
+    xcmp[34] = te->teproc.xst[78] * (float)100.;
+    xcmp[35] = te->teproc.xst[79] * (float)100.;
+    xcmp[36] = te->teproc.xst[99] * (float)100.;
+    xcmp[37] = te->teproc.xst[100] * (float)100.;
+    xcmp[38] = te->teproc.xst[101] * (float)100.;
+    xcmp[39] = te->teproc.xst[102] * (float)100.;
+    xcmp[40] = te->teproc.xst[103] * (float)100.;
+/* 		Outputs XMEAS(43..51), delay and noise free; XMEAS(42) */
+/* 		and the run totals are kept per accepted step by teopcost. */
+    te->opcost.xmeas[1] = te->teproc.crxr[6] * .454;
+    te->opcost.xmeas[2] = te->teproc.crxr[7] * .454;
+    te->opcost.xmeas[3] = te->teproc.crxr[5] * .454;
+    te->opcost.xmeas[4] = te->teproc.ppr[0] * 101.325 / 760.;
+    te->opcost.xmeas[5] = te->teproc.ppr[2] * 101.325 / 760.;
+    te->opcost.xmeas[6] = te->teproc.ppr[3] * 101.325 / 760.;
+    te->opcost.xmeas[7] = te->teproc.ppr[4] * 101.325 / 760.;
+    te->opcost.xmeas[8] = te->teproc.xst[102] * 100.;
+    te->opcost.xmeas[9] = te->teproc.xst[103] * 100.;
+    if (*time == 0.) {
+	for (i__ = 23; i__ <= 41; ++i__) {
+	    te->teproc.xdel[i__ - 1] = xcmp[i__ - 1];
+	    te->pv.xmeas[i__ - 1] = xcmp[i__ - 1];
+/* L7010: */
+	}
+	te->teproc.tgas = (float).1;
+	te->teproc.tprod = (float).25;
+    }
+    if (*time >= te->teproc.tgas) {
+	for (i__ = 23; i__ <= 36; ++i__) {
+	    te->pv.xmeas[i__ - 1] = te->teproc.xdel[i__ - 1];
+#if TE_NOISE
+	    tesub6_(te, &te->teproc.xns[i__ - 1], &xmns);
+	    te->pv.xmeas[i__ - 1] += xmns;
+#endif
+	    te->teproc.xdel[i__ - 1] = xcmp[i__ - 1];
+/* L7020: */
+	}
+	te->teproc.tgas += (float).1;
+    }
+    if (*time >= te->teproc.tprod) {
+	for (i__ = 37; i__ <= 41; ++i__) {
+	    te->pv.xmeas[i__ - 1] = te->teproc.xdel[i__ - 1];
+#if TE_NOISE
+	    tesub6_(te, &te->teproc.xns[i__ - 1], &xmns);
+	    te->pv.xmeas[i__ - 1] += xmns;
+#endif
+	    te->teproc.xdel[i__ - 1] = xcmp[i__ - 1];
+/* L7030: */
+	}
+	te->teproc.tprod += (float).25;
+    }
+    TE_STATS_LAP(te->stats, TE_PH_MEASURE, tick);
+    if (! yp) {
+	return 0;
+    }
+    for (i__ = 1; i__ <= 8; ++i__) {
+	yp[i__] = te->teproc.fcm[i__ + 47] - te->teproc.fcm[i__ + 55] + 
+		te->teproc.crxr[i__ - 1];
+	yp[i__ + 9] = te->teproc.fcm[i__ + 55] - te->teproc.fcm[i__ + 63] - 
+		te->teproc.fcm[i__ + 71] - te->teproc.fcm[i__ + 79];
+	yp[i__ + 18] = te->teproc.fcm[i__ + 87] - te->teproc.fcm[i__ + 95];
+	yp[i__ + 27] = te->teproc.fcm[i__ - 1] + te->teproc.fcm[i__ + 7] + 
+		te->teproc.fcm[i__ + 15] + te->teproc.fcm[i__ + 31] + 
+		te->teproc.fcm[i__ + 63] - te->teproc.fcm[i__ + 39];
+/* L9010: */
+    }
+    yp[9] = te->teproc.hst[6] * te->teproc.ftm[6] - te->teproc.hst[7] * 
+	    te->teproc.ftm[7] + te->teproc.rh + te->teproc.qur;
+/* 		Here is the "correct" version of the separator energy balance: */
+/* 	YP(18)=HST(8)*FTM(8)- */
+/*    .(HST(9)*FTM(9)-cpdh)- */
+/*    .HST(10)*FTM(10)- */
+/*    .HST(11)*FTM(11)+ */
+/*    .QUS */
+/* 		Here is the original version */
+    yp[18] = te->teproc.hst[7] * te->teproc.ftm[7] - te->teproc.hst[8] * 
+	    te->teproc.ftm[8] - te->teproc.hst[9] * te->teproc.ftm[9] - 
+	    te->teproc.hst[10] * te->teproc.ftm[10] + te->teproc.qus;
+    yp[27] = te->teproc.hst[3] * te->teproc.ftm[3] + te->teproc.hst[10] * 
+	    te->teproc.ftm[10] - te->teproc.hst[4] * te->teproc.ftm[4] - 
+	    te->teproc.hst[12] * te->teproc.ftm[12] + te->teproc.quc;
+    yp[36] = te->teproc.hst[0] * te->teproc.ftm[0] + te->teproc.hst[1] * 
+	    te->teproc.ftm[1] + te->teproc.hst[2] * te->teproc.ftm[2] + 
+	    te->teproc.hst[4] * te->teproc.ftm[4] + te->teproc.hst[8] * 
+	    te->teproc.ftm[8] - te->teproc.hst[5] * te->teproc.ftm[5];
+    yp[37] = (te->teproc.fwr * (float)500.53 * (te->teproc.tcwr - te->teproc.twr) - 
+	    te->teproc.qur * 1e6 / (float)1.8) / te->teproc.hwr;
+    yp[38] = (te->teproc.fws * (float)500.53 * (te->teproc.tcws - te->teproc.tws) - 
+	    te->teproc.qus * 1e6 / (float)1.8) / te->teproc.hws;
+    te->teproc.ivst[9] = TE_IDV(13);
+    te->teproc.ivst[10] = TE_IDV(14);
+    te->teproc.ivst[4] = TE_IDV(18);
+    te->teproc.ivst[6] = TE_IDV(18);
+    te->teproc.ivst[7] = TE_IDV(18);
+    te->teproc.ivst[8] = TE_IDV(18);
+    for (i__ = 1; i__ <= 12; ++i__) {
+	if (*time == 0. || (d__1 = te->teproc.vcv[i__ - 1] - te->pv.xmv[i__ - 1], 
+		abs(d__1)) > TE_STICKY(i__ - 1)) {
+	    te->teproc.vcv[i__ - 1] = te->pv.xmv[i__ - 1];
+	}
+	if (te->teproc.vcv[i__ - 1] < (float)0.) {
+	    te->teproc.vcv[i__ - 1] = (float)0.;
+	}
+	if (te->teproc.vcv[i__ - 1] > (float)100.) {
+	    te->teproc.vcv[i__ - 1] = (float)100.;
+	}
+	yp[i__ + 38] = (te->teproc.vcv[i__ - 1] - vpos[i__ - 1]) / 
+		te->teproc.vtau[i__ - 1];
+/* L9020: */
+    }
+    if (*time > (float)0. && *isd != 0) {
+	i__1 = *nn;
+	for (i__ = 1; i__ <= i__1; ++i__) {
+	    yp[i__] = (float)0.;
+/* L9030: */
+	}
+    }
+    TE_STATS_LAP(te->stats, TE_PH_DERIV, tick);
+    return 0;
+} /* TE_KERNEL */
+
+#undef isd
+
+#undef TE_IDV
+#undef TE_STICKY
+#undef TE_KERNEL
+#undef TE_DIST
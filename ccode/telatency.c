@@ -0,0 +1,241 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Detection latency of detectors over a library of scenarios.
+ *
+ *   telatency [-l library] [-D detectors] [-M model] [-C control] [-n seeds]
+ *             [-s seed] [-t hours] [-j threads] [-c cache] [-o results]
+ *
+ * Simulates every scenario of the library (tescen.h; default the built-in
+ * one) with seeds fixed seeds (default 10) from seed on, keeping the runs
+ * in the cache directory (default telatency.cache), and scores them with
+ * the CUSUM, EWMA and Shewhart detectors of the bank configured by -D
+ * (tedetect.h, CUSUMs restarting after an alarm) and the PCA monitor of
+ * -M (tepca.h, T^2 or SPE, after TELATENCY_PERSIST samples over a
+ * limit). Runs already in the cache are only replayed, so that scoring
+ * another detector costs no simulation. The horizon defaults to 3 h, the
+ * open-loop plant shutting down soon after; -C runs the scenarios closed
+ * loop under the multiloop controller of a configuration file
+ * (temloop.h), so that they can be longer.
+ *
+ * Prints per scenario and detector, and per detector over all scenarios,
+ *
+ *   scenario detector runs detected falsealarms far min median mean p90 max
+ *
+ * the latencies in hours (-1 where nothing was detected). -o writes the
+ * score of every run: scenario seed detector onset tend tfalse tdetect.
+ *
+ * Build: cc -O2 -o telatency telatency.c tescen.c tedetect.c tepca.c
+ *        tesim.c teplant.c temloop.c teattack.c runstore.c terealtime.c
+ *        tetelem.c tetrace.c -lm -lpthread -lrt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tedetect.h"
+#include "tepca.h"
+#include "tescen.h"
+
+#define TELATENCY_PERSIST 3
+#define TELATENCY_MAX_DET 4
+
+static void usage(void)
+{
+	fprintf(stderr, "Usage: telatency [-l library] [-D detectors] [-M model] [-C control]\n"
+			"                 [-n seeds] [-s seed] [-t hours] [-j threads] [-c cache]\n"
+			"                 [-o results]\n");
+	exit(2);
+}
+
+static void bankreset(void *ctx)
+{
+	td_reset((TDBank *) ctx);
+}
+
+static int bankupdate(void *ctx, double t, const double *xmeas, const double *xmv)
+{
+	(void) xmv;
+	return td_update((TDBank *) ctx, t, xmeas);
+}
+
+static void pcareset(void *ctx)
+{
+	tp_reset((TPMonitor *) ctx);
+}
+
+static int pcaupdate(void *ctx, double t, const double *xmeas, const double *xmv)
+{
+	TPStat st;
+
+	return tp_update((TPMonitor *) ctx, t, xmeas, xmv, &st);
+}
+
+static void putstats(const char *scenario, const char *detector, const TSNStats *st)
+{
+	printf("%-12s %-9s %4d %4d %4d %8.5f %8.4f %8.4f %8.4f %8.4f %8.4f\n",
+			scenario, detector, st->runs, st->detected, st->falsealarms,
+			st->far, st->min, st->median, st->mean, st->p90, st->max);
+}
+
+static int putruns(const char *name, const TSNLibrary *lib, int nseeds,
+		const TSNDetector *det, int ndet, const TSNResult *res)
+{
+	const TSNResult *r = res;
+	FILE *fp;
+	int i, seed, j, ok;
+
+	if (!(fp = fopen(name, "w")))
+		return -1;
+	fprintf(fp, "# scenario seed detector onset tend tfalse tdetect\n");
+	for (i = 0; i < lib->n; i++)
+		for (seed = 0; seed < nseeds; seed++)
+			for (j = 0; j < ndet; j++, r++)
+				fprintf(fp, "%s %d %s %g %g %g %g\n", lib->s[i].name, seed,
+						det[j].name, r->onset, r->tend, r->tfalse, r->tdetect);
+	ok = !ferror(fp);
+	return fclose(fp) == 0 && ok ? 0 : -1;
+}
+
+int main(int argc, char *argv[])
+{
+	static const int kinds[] = {TD_CUSUM, TD_EWMA, TD_SHEWHART};
+	static const char *names[] = {"cusum", "ewma", "shewhart"};
+	TSNConfig cfg;
+	TSNLibrary *lib;
+	TSNDetector det[TELATENCY_MAX_DET];
+	TSNResult *res;
+	TSNStats st;
+	TDConfig tdcfg;
+	TDBank *bank[3] = {NULL, NULL, NULL};
+	TPModel *model = NULL;
+	TPMonitor *mon = NULL;
+	TMLConfig tmlcfg;
+	const char *libname = NULL, *detect = NULL, *pca = NULL, *out = NULL;
+	const char *control = NULL;
+	int i, j, ndet = 0, ran, status;
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.sim.tstop = 3.;
+	cfg.cache = "telatency.cache";
+	cfg.nseeds = 10;
+	for (i = 1; i < argc; i++) {
+		if (argv[i][0] != '-' || argv[i][2] != '\0' || i + 1 == argc)
+			usage();
+		switch (argv[i][1]) {
+		case 'l': libname = argv[++i]; break;
+		case 'D': detect = argv[++i]; break;
+		case 'M': pca = argv[++i]; break;
+		case 'C': control = argv[++i]; break;
+		case 'n': cfg.nseeds = atoi(argv[++i]); break;
+		case 's': cfg.sim.seed = atof(argv[++i]); break;
+		case 't': cfg.sim.tstop = atof(argv[++i]); break;
+		case 'j': cfg.nthreads = atoi(argv[++i]); break;
+		case 'c': cfg.cache = argv[++i]; break;
+		case 'o': out = argv[++i]; break;
+		default:  usage();
+		}
+	}
+	if ((!detect && !pca) || cfg.nseeds < 1)
+		usage();
+
+	if (libname)
+		status = tsn_load(libname, &lib, &i);
+	else
+		status = tsn_builtin(&lib);
+	if (status != TSN_OK) {
+		if (status == TSN_ESYNTAX)
+			fprintf(stderr, "telatency: %s:%d: %s\n", libname, i, tsn_strerror(status));
+		else
+			fprintf(stderr, "telatency: %s: %s\n", libname ? libname : "library",
+					tsn_strerror(status));
+		return 1;
+	}
+	if (control) {
+		tml_defaults(&tmlcfg);
+		if ((status = tml_load(control, &tmlcfg, &i)) != TML_OK) {
+			if (status == TML_ESYNTAX)
+				fprintf(stderr, "telatency: %s:%d: %s\n", control, i, tml_strerror(status));
+			else
+				fprintf(stderr, "telatency: %s: %s\n", control, tml_strerror(status));
+			return 1;
+		}
+		cfg.sim.control = &tmlcfg;
+	}
+	if (detect) {
+		td_defaults(&tdcfg);
+		tdcfg.reset = TD_RESET;
+		if ((status = td_load(detect, &tdcfg, &i)) != TD_OK) {
+			if (status == TD_ESYNTAX)
+				fprintf(stderr, "telatency: %s:%d: %s\n", detect, i, td_strerror(status));
+			else
+				fprintf(stderr, "telatency: %s: %s\n", detect, td_strerror(status));
+			return 1;
+		}
+		for (j = 0; j < 3; j++) {
+			tdcfg.detectors = kinds[j];
+			if ((status = td_open(&tdcfg, &bank[j])) != TD_OK) {
+				fprintf(stderr, "telatency: %s: %s\n", detect, td_strerror(status));
+				return 1;
+			}
+			det[ndet].name = names[j];
+			det[ndet].ctx = bank[j];
+			det[ndet].reset = bankreset;
+			det[ndet].update = bankupdate;
+			ndet++;
+		}
+	}
+	if (pca) {
+		if ((status = tp_load(pca, &model)) != TP_OK ||
+				(status = tp_open(model, TELATENCY_PERSIST, &mon)) != TP_OK) {
+			fprintf(stderr, "telatency: %s: %s\n", pca, tp_strerror(status));
+			return 1;
+		}
+		det[ndet].name = "pca";
+		det[ndet].ctx = mon;
+		det[ndet].reset = pcareset;
+		det[ndet].update = pcaupdate;
+		ndet++;
+	}
+
+	if ((status = tsn_simulate(&cfg, lib, &ran)) != TSN_OK) {
+		fprintf(stderr, "telatency: %s: %s\n", cfg.cache, tsn_strerror(status));
+		return 1;
+	}
+	fprintf(stderr, "telatency: %d runs simulated, %d from the cache\n", ran,
+			lib->n * cfg.nseeds - ran);
+	if (!(res = (TSNResult *) malloc((size_t) lib->n * cfg.nseeds * ndet * sizeof(TSNResult)))) {
+		fprintf(stderr, "telatency: out of memory\n");
+		return 1;
+	}
+	if ((status = tsn_score(&cfg, lib, det, ndet, res)) != TSN_OK) {
+		fprintf(stderr, "telatency: %s: %s\n", cfg.cache, tsn_strerror(status));
+		return 1;
+	}
+
+	printf("# scenario   detector  runs  det   fa      far      min   median     mean      p90      max\n");
+	for (i = 0; i < lib->n; i++)
+		for (j = 0; j < ndet; j++) {
+			tsn_stats(&res[i * cfg.nseeds * ndet + j], cfg.nseeds, ndet, &st);
+			putstats(lib->s[i].name, det[j].name, &st);
+		}
+	for (j = 0; j < ndet; j++) {
+		tsn_stats(&res[j], lib->n * cfg.nseeds, ndet, &st);
+		putstats("all", det[j].name, &st);
+	}
+	if (out && putruns(out, lib, cfg.nseeds, det, ndet, res) != 0)
+		fprintf(stderr, "telatency: cannot write %s\n", out);
+
+	free(res);
+	for (j = 0; j < 3; j++)
+		td_close(bank[j]);
+	tp_close(mon);
+	tp_model_free(model);
+	tsn_free(lib);
+	return 0;
+}
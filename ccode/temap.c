@@ -0,0 +1,322 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Shutdown and impact maps of attacks on the TE plant.
+ *
+ *   temap -c channels [-y type] [-k mode] [-v values] [-b starts]
+ *         [-l durations] [-t hours] [-d idv[,idv...]] [-s seed] [-C control]
+ *         [-j threads] [-o file.mat]
+ *
+ * Runs every combination of the attacked channel, value, start and duration
+ * (tesweep.h) in parallel and writes the results to a MAT-file (default
+ * temap.mat):
+ *
+ *   cells      one row per cell: [art block value start duration isd t
+ *              cost impact], art 0 for xmeas and 1 for xmv
+ *   channels   [art block] per channel
+ *   values, starts, durations   the swept axes
+ *   base       [isd t cost] of the unattacked run
+ *
+ * so that reshape(cells(:,k), numel(durations), numel(starts),
+ * numel(values), size(channels,1)) gives the map of column k.
+ *
+ * Channels are listed as in "xmv,xmeas7,xmeas9-11": a bare xmv or xmeas
+ * means all its channels. Axes are lists of numbers and ranges
+ * first:last or first:step:last, e.g. "0:0.5:2,4". The type is integrity
+ * (default) or dos, the mode step (default), interval or periodic; times
+ * are in hours, the horizon defaults to 72 h.
+ *
+ * -C closes the loop with the multiloop controller of a configuration file
+ * (temloop.h), e.g. data/Mode1Control.txt; the open-loop plant shuts down
+ * after a few hours by itself. Maps whose unattacked run shuts down within
+ * the horizon are refused, as every later cell would only show that trip.
+ *
+ * Build: cc -O2 -o temap temap.c tesweep.c tesim.c teplant.c temloop.c
+ *        teattack.c matwriter.c terealtime.c tetelem.c tetrace.c -lm -lpthread
+ *        -lrt
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matwriter.h"
+#include "tesweep.h"
+
+static void usage(void)
+{
+	fprintf(stderr, "Usage: temap -c channels [-y type] [-k mode] [-v values] [-b starts]\n"
+			"             [-l durations] [-t hours] [-d idv[,idv...]] [-s seed] [-C control]\n"
+			"             [-j threads] [-o file.mat]\n");
+	exit(2);
+}
+
+static void *xrealloc(void *p, size_t size)
+{
+	if (!(p = realloc(p, size))) {
+		fprintf(stderr, "temap: out of memory\n");
+		exit(1);
+	}
+	return p;
+}
+
+/* Appends the numbers and ranges of s to *a. */
+static int parseaxis(const char *s, double **a)
+{
+	double r[3];
+	char *end;
+	int n = 0, k, i, count;
+
+	for (;;) {
+		for (k = 0; k < 3; k++) {
+			r[k] = strtod(s, &end);
+			if (end == s)
+				usage();
+			s = end;
+			if (*s != ':')
+				break;
+			s++;
+		}
+		if (k == 3)
+			usage();
+		if (k == 0) {
+			r[2] = r[0];
+			r[1] = 1.;
+		} else if (k == 1) {
+			r[2] = r[1];
+			r[1] = 1.;
+		}
+		if (!(r[1] > 0.) || r[2] < r[0])
+			usage();
+		count = (int) floor((r[2] - r[0]) / r[1] + 1e-9) + 1;
+		*a = (double *) xrealloc(*a, (n + count) * sizeof(double));
+		for (i = 0; i < count; i++)
+			(*a)[n++] = r[0] + i * r[1];
+		if (*s == '\0')
+			return n;
+		if (*s != ',')
+			usage();
+		s++;
+	}
+}
+
+/* Parses a channel list such as "xmv,xmeas7,xmeas9-11". */
+static int parsechannels(const char *s, TSChannel **c)
+{
+	TSChannel ch;
+	char *end;
+	long first, last;
+	int n = 0, max;
+
+	for (;;) {
+		if (strncmp(s, "xmv", 3) == 0) {
+			ch.art = TA_XMV;
+			max = TE_NU;
+			s += 3;
+		} else if (strncmp(s, "xmeas", 5) == 0) {
+			ch.art = TA_XMEAS;
+			max = TE_NY;
+			s += 5;
+		} else
+			usage();
+		first = 1;
+		last = max;
+		if (*s != ',' && *s != '\0') {
+			first = last = strtol(s, &end, 10);
+			if (end == s)
+				usage();
+			s = end;
+			if (*s == '-') {
+				last = strtol(++s, &end, 10);
+				if (end == s)
+					usage();
+				s = end;
+			}
+		}
+		if (first < 1 || last > max || last < first)
+			usage();
+		*c = (TSChannel *) xrealloc(*c, (n + last - first + 1) * sizeof(TSChannel));
+		for (ch.block = (int) first; ch.block <= last; ch.block++)
+			(*c)[n++] = ch;
+		if (*s == '\0')
+			return n;
+		if (*s != ',')
+			usage();
+		s++;
+	}
+}
+
+/* Switches on the disturbances listed in s, e.g. "1,6". */
+static void parseidv(const char *s, double *idv)
+{
+	char *end;
+	long i;
+
+	for (;;) {
+		i = strtol(s, &end, 10);
+		if (end == s || i < 1 || i > TE_NIDV)
+			usage();
+		idv[i - 1] = 1.;
+		if (*end == '\0')
+			return;
+		if (*end != ',')
+			usage();
+		s = end + 1;
+	}
+}
+
+static int keyword(const char *s, const char *const *words, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		if (strcmp(s, words[i]) == 0)
+			return i + 1;
+	usage();
+	return 0;
+}
+
+/* Writes the n-vector a, as an empty matrix if n is 0. */
+static int putvector(MatFile *f, const char *name, const double *a, int n)
+{
+	return mat_put(f, name, a, (size_t) n, n > 0 ? 1 : 0);
+}
+
+static int putmap(const char *name, const TSConfig *cfg, const TSCell *cells,
+		const TSCell *base)
+{
+	MatFile *f;
+	double *out, *c, b[3];
+	size_t n = tsw_cells(cfg), nch = (size_t) cfg->nchannels, i;
+	size_t nd = cfg->ndurations > 0 ? cfg->ndurations : 1;
+	size_t ns = cfg->nstarts > 0 ? cfg->nstarts : 1;
+	size_t nv = cfg->nvalues > 0 ? cfg->nvalues : 1;
+	int status, st;
+
+	out = (double *) xrealloc(NULL, 9 * n * sizeof(double));
+	for (i = 0; i < n; i++) {
+		const TSChannel *ch = &cfg->channels[i / nd / ns / nv];
+
+		out[i] = ch->art;
+		out[n + i] = ch->block;
+		out[2*n + i] = cfg->nvalues > 0 ? cfg->values[i / nd / ns % nv] : cfg->attack.value;
+		out[3*n + i] = cfg->nstarts > 0 ? cfg->starts[i / nd % ns] : cfg->attack.start;
+		out[4*n + i] = cfg->ndurations > 0 ? cfg->durations[i % nd] : cfg->attack.duration;
+		out[5*n + i] = (double) cells[i].isd;
+		out[6*n + i] = cells[i].t;
+		out[7*n + i] = cells[i].cost;
+		out[8*n + i] = cells[i].impact;
+	}
+	c = (double *) xrealloc(NULL, 2 * nch * sizeof(double));
+	for (i = 0; i < nch; i++) {
+		c[i] = cfg->channels[i].art;
+		c[nch + i] = cfg->channels[i].block;
+	}
+	b[0] = (double) base->isd;
+	b[1] = base->t;
+	b[2] = base->cost;
+
+	if ((status = mat_create(name, &f)) == MAT_OK) {
+		if ((status = mat_put(f, "cells", out, n, 9)) == MAT_OK &&
+				(status = mat_put(f, "channels", c, nch, 2)) == MAT_OK &&
+				(status = putvector(f, "values", cfg->values, cfg->nvalues)) == MAT_OK &&
+				(status = putvector(f, "starts", cfg->starts, cfg->nstarts)) == MAT_OK &&
+				(status = putvector(f, "durations", cfg->durations, cfg->ndurations)) == MAT_OK)
+			status = mat_put(f, "base", b, 1, 3);
+		if ((st = mat_close(f)) != MAT_OK && status == MAT_OK)
+			status = st;
+	}
+	free(c);
+	free(out);
+	return status;
+}
+
+int main(int argc, char *argv[])
+{
+	static const char *const types[] = {"integrity", "dos"};
+	static const char *const modes[] = {"none", "step", "interval", "periodic"};
+	TSConfig cfg;
+	TMLConfig tmlcfg;
+	TESimResult res;
+	TSChannel *channels = NULL;
+	TSCell *cells, base;
+	double idv[TE_NIDV], *values = NULL, *starts = NULL, *durations = NULL;
+	const char *name = "temap.mat", *control = NULL;
+	int i, status;
+
+	memset(&cfg, 0, sizeof(cfg));
+	memset(idv, 0, sizeof(idv));
+	cfg.sim.tstop = 72.;
+	cfg.sim.idv = idv;
+	cfg.attack.type = TA_INTEGRITY;
+	cfg.attack.mode = TA_STEP;
+	for (i = 1; i < argc; i++) {
+		if (argv[i][0] != '-' || argv[i][2] != '\0' || i + 1 == argc)
+			usage();
+		switch (argv[i][1]) {
+		case 'c': cfg.nchannels = parsechannels(argv[++i], &channels); break;
+		case 'y': cfg.attack.type = keyword(argv[++i], types, 2); break;
+		case 'k': cfg.attack.mode = keyword(argv[++i], modes, 4); break;
+		case 'v': cfg.nvalues = parseaxis(argv[++i], &values); break;
+		case 'b': cfg.nstarts = parseaxis(argv[++i], &starts); break;
+		case 'l': cfg.ndurations = parseaxis(argv[++i], &durations); break;
+		case 't': cfg.sim.tstop = atof(argv[++i]); break;
+		case 'd': parseidv(argv[++i], idv); break;
+		case 's': cfg.sim.seed = atof(argv[++i]); break;
+		case 'C': control = argv[++i]; break;
+		case 'j': cfg.nthreads = atoi(argv[++i]); break;
+		case 'o': name = argv[++i]; break;
+		default:  usage();
+		}
+	}
+	if (cfg.nchannels == 0)
+		usage();
+	cfg.channels = channels;
+	cfg.values = values;
+	cfg.starts = starts;
+	cfg.durations = durations;
+	if (control) {
+		tml_defaults(&tmlcfg);
+		if ((status = tml_load(control, &tmlcfg, &i)) != TML_OK) {
+			if (status == TML_ESYNTAX)
+				fprintf(stderr, "temap: %s:%d: %s\n", control, i, tml_strerror(status));
+			else
+				fprintf(stderr, "temap: %s: %s\n", control, tml_strerror(status));
+			return 1;
+		}
+		cfg.sim.control = &tmlcfg;
+	}
+
+	/* The unattacked run first, not to sweep against a plant that trips */
+	if ((status = tesim_run(&cfg.sim, NULL, &res)) != TESIM_OK) {
+		fprintf(stderr, "temap: invalid plant or controller configuration\n");
+		return 1;
+	}
+	if (res.isd != 0) {
+		fprintf(stderr, "temap: the unattacked plant shuts down at t = %g h, %s\n",
+				res.t, control ? "shorten the horizon" : "use -C or shorten the horizon");
+		return 1;
+	}
+
+	cells = (TSCell *) xrealloc(NULL, tsw_cells(&cfg) * sizeof(TSCell));
+	if ((status = tsw_run(&cfg, cells, &base)) != TSW_OK) {
+		fprintf(stderr, "temap: %s\n", tsw_strerror(status));
+		return 1;
+	}
+	if ((status = putmap(name, &cfg, cells, &base)) != MAT_OK) {
+		fprintf(stderr, "temap: %s: %s\n", name, mat_strerror(status));
+		return 1;
+	}
+	free(cells);
+	free(channels);
+	free(values);
+	free(starts);
+	free(durations);
+	return 0;
+}
@@ -0,0 +1,397 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Decentralized multiloop control, see temloop.h. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "temloop.h"
+
+#define TML_LINE 1024
+
+static const char *const names[TML_NLOOP] = {
+	"afeed", "dfeed", "efeed", "cfeed", "purge", "sepflow", "stripflow",
+	"production", "striplevel", "seplevel", "reactorlevel", "pressure", "pctg",
+	"reactortemp", "septemp", "ya", "yac", "pctc", "recycle"
+};
+
+/* Measured xmeas of each loop, 1-based; 0 for yA and yAC, computed from
+ * xmeas(23) and xmeas(25). */
+static const int meas[TML_NLOOP] = {
+	1, 2, 3, 4, 10, 14, 17, 17, 15, 12, 8, 7, 40, 9, 11, 0, 0, 31, 5
+};
+
+/* Loops with a setpoint of their own (Inports of the TE Plant subsystem). */
+static const int outer[TML_NLOOP] = {
+	0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1
+};
+
+/* Feedforward from the %G setpoint to r2 and r3 and Fp per production */
+static const double p2[3] = {1.5192e-3, 0.59446, 0.2769};
+static const double p3[3] = {-1.1377e-3, -0.80893, 91.06};
+#define TML_FPGAIN (100. / 22.89)
+
+const char *tml_strerror(int status)
+{
+	switch (status) {
+	case TML_OK:      return "no error";
+	case TML_EIO:     return "input/output error";
+	case TML_ESYNTAX: return "syntax error";
+	case TML_EARG:    return "invalid argument";
+	default:          return "unknown error";
+	}
+}
+
+static void setloop(TMLConfig *cfg, int i, double kc, double ti, double lo,
+		double hi, double x)
+{
+	TMLLoop *l = &cfg->loop[i];
+
+	l->kc = kc;
+	l->ti = ti;
+	l->lo = lo;
+	l->hi = hi;
+	l->x = x;
+}
+
+void tml_defaults(TMLConfig *cfg)
+{
+	static const double u0[TE_NU] = {63.053, 53.98, 24.644, 61.302, 22.21,
+			40.064, 38.10, 46.534, 47.446, 41.106, 18.114, 50.};
+	const double fp0 = 100.;
+
+	memset(cfg, 0, sizeof(*cfg));
+	cfg->structure = TML_RICKER;
+	cfg->ts = TE_TS_BASE;
+	setloop(cfg, TML_AFEED, 0.01, 0.001 / 60., 0., 100., u0[2]);
+	setloop(cfg, TML_DFEED, 1.6e-6, 0.001 / 60., 0., 100., u0[0]);
+	setloop(cfg, TML_EFEED, 1.8e-6, 0.001 / 60., 0., 100., u0[1]);
+	setloop(cfg, TML_CFEED, 0.003, 0.001 / 60., 0., 100., u0[3]);
+	setloop(cfg, TML_PURGE, 0.01, 0.001 / 60., 0., 100., u0[5]);
+	setloop(cfg, TML_SEPFLOW, 4e-4, 0.001 / 60., 0., 100., u0[6]);
+	setloop(cfg, TML_STRIPFLOW, 4e-4, 0.001 / 60., 0., 100., u0[7]);
+	setloop(cfg, TML_PRODUCTION, 3.2, 120. / 60., -30., 30., 0.);
+	setloop(cfg, TML_STRIPLEVEL, -2e-4, 200. / 60., 0., 100., 22.95 / fp0);
+	setloop(cfg, TML_SEPLEVEL, -1e-3, 200. / 60., 0., 100., 25.16 / fp0);
+	setloop(cfg, TML_REACTORLEVEL, 0.8, 60. / 60., 0., 120., 80.1);
+	setloop(cfg, TML_PRESSURE, -1e-4, 20. / 60., 0., 100., 0.337 / fp0);
+	setloop(cfg, TML_PCTG, -0.4, 100. / 60., -HUGE_VAL, HUGE_VAL, 0.);
+	setloop(cfg, TML_REACTORTEMP, -8., 7.5 / 60., 0., 100., u0[9]);
+	setloop(cfg, TML_SEPTEMP, -4., 15. / 60., 0., 100., u0[10]);
+	setloop(cfg, TML_YA, 2e-4, 1., -HUGE_VAL, HUGE_VAL, 0.);
+	setloop(cfg, TML_YAC, 3e-4, 2., -HUGE_VAL, HUGE_VAL, 0.);
+	setloop(cfg, TML_PCTC, 0.0009, 562. / 60., 0., 200., 9.35 / fp0);
+	setloop(cfg, TML_RECYCLE, 0.00125, 120. / 60., 0., 200., 0.251 / fp0);
+	cfg->loop[TML_YA].ts = cfg->loop[TML_YAC].ts = 0.1;
+
+	cfg->sp[TML_PRODUCTION] = 22.89;
+	cfg->sp[TML_STRIPLEVEL] = 50.;
+	cfg->sp[TML_SEPLEVEL] = 50.;
+	cfg->sp[TML_REACTORLEVEL] = 65.;
+	cfg->sp[TML_PRESSURE] = 2800.;
+	cfg->sp[TML_PCTG] = 53.8;
+	cfg->sp[TML_YA] = 100. * 32.2 / 51.;
+	cfg->sp[TML_YAC] = 51.;
+	cfg->sp[TML_REACTORTEMP] = 122.9;
+	cfg->sp[TML_PCTC] = 13.1;
+	cfg->sp[TML_RECYCLE] = 32.2;
+	cfg->rate[TML_PRODUCTION] = 0.3 * 22.95 / 24.;
+	cfg->rate[TML_PCTG] = 50. / 24.;
+	cfg->xmv[4] = 0.;
+	cfg->xmv[8] = 0.;
+	cfg->xmv[11] = 100.;
+	cfg->ovmax = 90.;
+	cfg->trim[0] = 0.251 / fp0;
+	cfg->trim[1] = 9.35 / fp0;
+}
+
+int tml_loop(const char *name)
+{
+	int i;
+
+	for (i = 0; i < TML_NLOOP; i++)
+		if (strcmp(name, names[i]) == 0)
+			return i;
+	return -1;
+}
+
+static int number(const char *s, double *v)
+{
+	char *end;
+
+	if (!s)
+		return 0;
+	*v = strtod(s, &end);
+	return end != s && *end == '\0';
+}
+
+/* Up to max numbers from the rest of the line; -1 if one is malformed. */
+static int numbers(double *v, int max)
+{
+	static const char *const sep = " \t\r\n";
+	char *tok;
+	int n = 0;
+
+	while ((tok = strtok(NULL, sep))) {
+		if (n == max || !number(tok, &v[n]))
+			return -1;
+		n++;
+	}
+	return n;
+}
+
+int tml_parse(char *s, TMLConfig *cfg)
+{
+	static const char *const sep = " \t\r\n";
+	char *key, *name, *c;
+	double v[TE_NX];
+	int i = -1, valve = 0, n;
+
+	if ((c = strchr(s, '#')))
+		*c = '\0';
+	if (!(key = strtok(s, sep)))
+		return TML_OK;   /* blank line */
+	if (strcmp(key, "structure") == 0) {
+		if (!(name = strtok(NULL, sep)) || strtok(NULL, sep))
+			return TML_ESYNTAX;
+		if (strcmp(name, "ricker") == 0)
+			cfg->structure = TML_RICKER;
+		else if (strcmp(name, "skoge") == 0)
+			cfg->structure = TML_SKOGE;
+		else
+			return TML_ESYNTAX;
+		return TML_OK;
+	}
+	if (strcmp(key, "pi") == 0 || strcmp(key, "state") == 0 ||
+			strcmp(key, "setpoint") == 0 || strcmp(key, "ratelimit") == 0) {
+		if (!(name = strtok(NULL, sep)))
+			return TML_ESYNTAX;
+		if (strcmp(key, "setpoint") == 0 && sscanf(name, "xmv%d%n", &valve, &n) == 1) {
+			if (name[n] != '\0' || (valve != 5 && valve != 9 && valve != 12))
+				return TML_ESYNTAX;
+		} else if ((i = tml_loop(name)) < 0 || (strcmp(key, "setpoint") == 0 &&
+				!outer[i]))
+			return TML_ESYNTAX;
+	}
+	n = numbers(v, strcmp(key, "x0") == 0 ? TE_NX - cfg->nx0 : 6);
+	if (strcmp(key, "ts") == 0 && n == 1 && v[0] > 0.)
+		cfg->ts = v[0];
+	else if (strcmp(key, "pi") == 0 && (n == 2 || n == 4 || n == 5) &&
+			v[1] > 0. && (n == 2 || v[2] <= v[3]) && (n < 5 || v[4] >= 0.)) {
+		cfg->loop[i].kc = v[0];
+		cfg->loop[i].ti = v[1];
+		if (n > 2) {
+			cfg->loop[i].lo = v[2];
+			cfg->loop[i].hi = v[3];
+		}
+		if (n > 4)
+			cfg->loop[i].ts = v[4];
+	} else if (strcmp(key, "state") == 0 && (n == 1 || n == 2)) {
+		cfg->loop[i].x = v[0];
+		if (n > 1)
+			cfg->loop[i].e = v[1];
+	} else if (strcmp(key, "setpoint") == 0 && n == 1) {
+		if (valve)
+			cfg->xmv[valve - 1] = v[0];
+		else
+			cfg->sp[i] = v[0];
+	} else if (strcmp(key, "ratelimit") == 0 && n == 1 && outer[i] && v[0] >= 0.)
+		cfg->rate[i] = v[0];
+	else if (strcmp(key, "override") == 0 && n == 2) {
+		cfg->ovmax = v[0];
+		cfg->ovgain = v[1];
+	} else if (strcmp(key, "trim") == 0 && n == 2) {
+		cfg->trim[0] = v[0];
+		cfg->trim[1] = v[1];
+	} else if (strcmp(key, "x0") == 0 && n > 0) {
+		memcpy(&cfg->x0[cfg->nx0], v, n * sizeof(double));
+		cfg->nx0 += n;
+	} else
+		return TML_ESYNTAX;
+	return TML_OK;
+}
+
+int tml_load(const char *path, TMLConfig *cfg, int *line)
+{
+	FILE *fp;
+	char s[TML_LINE];
+	int status = TML_OK;
+
+	*line = 0;
+	if (!(fp = fopen(path, "r")))
+		return TML_EIO;
+	while (status == TML_OK && fgets(s, TML_LINE, fp)) {
+		++*line;
+		status = tml_parse(s, cfg);
+	}
+	if (status == TML_OK && ferror(fp))
+		status = TML_EIO;
+	fclose(fp);
+	if (status == TML_OK && cfg->nx0 != 0 && cfg->nx0 != TE_NX)
+		status = TML_ESYNTAX;
+	if (status == TML_OK)
+		*line = 0;
+	return status;
+}
+
+/* ============================================================================= */
+
+/* Loops run by each structure */
+static int active(int structure, int i)
+{
+	if (i == TML_YA || i == TML_YAC)
+		return structure == TML_RICKER;
+	if (i == TML_PCTC || i == TML_RECYCLE)
+		return structure == TML_SKOGE;
+	return 1;
+}
+
+static long gcd(long a, long b)
+{
+	long r;
+
+	while (b != 0) {
+		r = a % b;
+		a = b;
+		b = r;
+	}
+	return a;
+}
+
+int tml_init(TMLController *ctl, const TMLConfig *cfg, double h)
+{
+	double ts, n;
+	int i;
+
+	if (!(h > 0.) || (cfg->structure != TML_RICKER && cfg->structure != TML_SKOGE))
+		return TML_EARG;
+	memset(ctl, 0, sizeof(*ctl));
+	ctl->cfg = *cfg;
+	ctl->h = h;
+	for (i = 0; i < TML_NLOOP; i++) {
+		ts = cfg->loop[i].ts > 0. ? cfg->loop[i].ts : cfg->ts;
+		n = floor(ts / h + .5);
+		if (active(cfg->structure, i) && (n < 1. || fabs(n * h - ts) > 1e-9 * ts ||
+				!(cfg->loop[i].ti > 0.)))
+			return TML_EARG;
+		ctl->every[i] = (long) n;
+		if (active(cfg->structure, i))
+			ctl->period = gcd(ctl->every[i], ctl->period);
+		ctl->x[i] = cfg->loop[i].x;
+		ctl->e[i] = cfg->loop[i].e;
+	}
+	memcpy(ctl->sp, cfg->sp, sizeof(ctl->sp));
+	memcpy(ctl->trim, cfg->trim, sizeof(ctl->trim));
+	ctl->r[0] = cfg->structure == TML_RICKER ? cfg->trim[0] : ctl->x[TML_RECYCLE];
+	ctl->r[3] = cfg->structure == TML_RICKER ? cfg->trim[1] : ctl->x[TML_PCTC];
+	return TML_OK;
+}
+
+int tml_setpoint(TMLController *ctl, int loop, double value)
+{
+	if (loop < 0 || loop >= TML_NLOOP || !outer[loop])
+		return TML_EARG;
+	ctl->cfg.sp[loop] = value;
+	return TML_OK;
+}
+
+void tml_xmv(const TMLController *ctl, double *xmv)
+{
+	const double *x = ctl->x;
+	double d;
+
+	xmv[0] = x[TML_DFEED];
+	xmv[1] = x[TML_EFEED];
+	xmv[2] = x[TML_AFEED];
+	xmv[3] = x[TML_CFEED];
+	xmv[4] = ctl->cfg.xmv[4];
+	xmv[5] = x[TML_PURGE];
+	xmv[6] = x[TML_SEPFLOW];
+	xmv[7] = x[TML_STRIPFLOW];
+	xmv[8] = ctl->cfg.xmv[8];
+	xmv[9] = x[TML_REACTORTEMP];
+	xmv[10] = x[TML_SEPTEMP];
+	xmv[11] = ctl->cfg.xmv[11];
+	if (ctl->cfg.ovgain != 0.) {
+		d = ctl->cfg.ovgain * (xmv[10] - ctl->cfg.ovmax);
+		xmv[4] += d < 0. ? d : 0.;
+		xmv[4] = xmv[4] < 0. ? 0. : xmv[4] > 100. ? 100. : xmv[4];
+	}
+}
+
+/* Vel PI: the change of output for the error e, which becomes the last. */
+static double velpi(TMLController *ctl, int i, double e)
+{
+	const TMLLoop *l = &ctl->cfg.loop[i];
+	double ts = (double) ctl->every[i] * ctl->h;
+	double delta = l->kc * (e * (1. + ts / l->ti) - ctl->e[i]);
+
+	ctl->e[i] = e;
+	return delta;
+}
+
+void tml_update(TMLController *ctl, const double *xmeas)
+{
+	const TMLConfig *cfg = &ctl->cfg;
+	double sp[TML_NLOOP], e, d, dmax, fp, eadj, g, y;
+	int i;
+
+	/* Rate Limiter, Rate Limiter1, over the steps since the last sample;
+	 * their outputs are only read at samples. */
+	for (i = 0; i < TML_NLOOP; i++) {
+		if (cfg->rate[i] > 0.) {
+			d = cfg->sp[i] - ctl->sp[i];
+			dmax = cfg->rate[i] * ctl->h * (double) ctl->period;
+			ctl->sp[i] += d > dmax ? dmax : d < -dmax ? -dmax : d;
+		} else
+			ctl->sp[i] = cfg->sp[i];
+	}
+	memcpy(sp, ctl->sp, sizeof(sp));
+
+	/* Fp, Feedforward and the cascade setpoints, from the outputs of the
+	 * step */
+	fp = ctl->x[TML_PRODUCTION] + TML_FPGAIN * sp[TML_PRODUCTION];
+	eadj = ctl->x[TML_PCTG];
+	g = sp[TML_PCTG];
+	ctl->r[1] = (p2[0] * g + p2[1]) * g + p2[2] - 32. * eadj / fp;
+	ctl->r[2] = 46. * eadj / fp + (p3[0] * g + p3[1]) * g + p3[2];
+	ctl->r[4] = ctl->x[TML_PRESSURE];
+	ctl->r[5] = ctl->x[TML_SEPLEVEL];
+	ctl->r[6] = ctl->x[TML_STRIPLEVEL];
+	sp[TML_SEPTEMP] = ctl->x[TML_REACTORLEVEL];
+	if (cfg->structure == TML_RICKER) {
+		/* yA, yAC control and Ratio trimming */
+		if (ctl->k % ctl->every[TML_YA] == 0) {
+			y = xmeas[22] + xmeas[24];
+			d = velpi(ctl, TML_YA, sp[TML_YA] - 100. * xmeas[22] / y);
+			e = velpi(ctl, TML_YAC, sp[TML_YAC] - y);
+			ctl->r[0] = ctl->trim[0] + d;
+			ctl->r[3] = ctl->trim[1] + e - d;
+			ctl->trim[0] = ctl->r[0];
+			ctl->trim[1] = ctl->r[3];
+		}
+	} else {
+		ctl->r[0] = ctl->x[TML_RECYCLE];
+		ctl->r[3] = ctl->x[TML_PCTC];
+	}
+	for (i = TML_AFEED; i <= TML_STRIPFLOW; i++)
+		sp[i] = ctl->r[i] * fp;
+
+	/* Discrete PI */
+	for (i = 0; i < TML_NLOOP; i++) {
+		if (i == TML_YA || i == TML_YAC || !active(cfg->structure, i) ||
+				ctl->k % ctl->every[i] != 0)
+			continue;
+		d = velpi(ctl, i, sp[i] - xmeas[meas[i] - 1]) + ctl->x[i];
+		ctl->x[i] = d < cfg->loop[i].lo ? cfg->loop[i].lo :
+				d > cfg->loop[i].hi ? cfg->loop[i].hi : d;
+	}
+	ctl->k += ctl->period;
+}
@@ -0,0 +1,166 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Decentralized multiloop control of the TE plant for native runs.
+ *
+ * The PI/cascade structures of MultiLoop_mode1.mdl, MultiLoop_mode3.mdl
+ * (Ricker's decentralized control) and MultiLoop_Skoge_mode1.mdl, so that
+ * closed-loop runs go without Simulink. Every loop is the Discrete PI block
+ * of TElib.mdl in velocity form:
+ *
+ *   e_k     = sp_k - meas_k                   sampled every ts hours
+ *   delta_k = kc * (e_k * (1 + ts/ti) - e_k-1)
+ *   y_k     = x_k,  x_k+1 = min(max(x_k + delta_k, lo), hi)
+ *
+ * with the output held between samples and no direct feedthrough. yA and
+ * yAC control are the bare Vel PI (delta_k only), whose outputs trim the
+ * A and C feed ratios r1 and r4 every 0.1 h (Ratio trimming); in the Skoge
+ * structure r1 and r4 are set by the recycle rate and %C in purge loops
+ * instead. The seven flow loops get the ratio r_i times the production
+ * index Fp as setpoint; the production and %G setpoints go through rate
+ * limiters as in the models. With an override, xmv(5) is lowered when the
+ * separator coolant valve xmv(11) opens past a maximum (Recycle Valve
+ * Override of mode 3).
+ *
+ * tml_defaults() gives the mode 1 tunings from the new-condition values of
+ * initMode1.m; a configuration file then sets what differs. One setting per
+ * line, '#' starts a comment, times in hours:
+ *
+ *   structure ricker|skoge
+ *   ts        hours                     sample time of all loops
+ *   pi        loop kc ti [lo hi [ts]]   tuning; ts 0 for the common one
+ *   state     loop x [e]                output and last error
+ *   setpoint  loop|xmvN value           xmvN: open-loop valves 5, 9, 12
+ *   ratelimit loop rate                 setpoint rate limit per hour, 0 none
+ *   override  max gain                  recycle valve override, gain 0 off
+ *   trim      r1 r4                     Ratio trimming Unit Delay states
+ *   x0        v ...                     plant states, continued by further
+ *                                       x0 lines up to TE_NX values
+ *
+ * Loops: afeed dfeed efeed cfeed purge sepflow stripflow production
+ * striplevel seplevel reactorlevel pressure pctg reactortemp septemp ya yac
+ * pctc recycle. data/Mode1Control.txt, Mode3Control.txt and
+ * SkogeMode1Control.txt hold the three models with the states of their
+ * xInitial files.
+ *
+ * A controller is a plain struct without allocations, so that runs can be
+ * copied (snapshots) and run in parallel.
+ */
+
+#ifndef __TEMLOOP_H__
+#define __TEMLOOP_H__
+
+#include "teplant.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Structures */
+#define TML_RICKER   1  /* MultiLoop_mode1, MultiLoop_mode3 */
+#define TML_SKOGE    2  /* MultiLoop_Skoge_mode1 */
+
+/* Loops */
+#define TML_AFEED         0   /* xmv(3) on xmeas(1) */
+#define TML_DFEED         1   /* xmv(1) on xmeas(2) */
+#define TML_EFEED         2   /* xmv(2) on xmeas(3) */
+#define TML_CFEED         3   /* xmv(4) on xmeas(4) */
+#define TML_PURGE         4   /* xmv(6) on xmeas(10) */
+#define TML_SEPFLOW       5   /* xmv(7) on xmeas(14) */
+#define TML_STRIPFLOW     6   /* xmv(8) on xmeas(17) */
+#define TML_PRODUCTION    7   /* Fp on xmeas(17) */
+#define TML_STRIPLEVEL    8   /* r7 on xmeas(15) */
+#define TML_SEPLEVEL      9   /* r6 on xmeas(12) */
+#define TML_REACTORLEVEL  10  /* separator temperature setpoint on xmeas(8) */
+#define TML_PRESSURE      11  /* r5 on xmeas(7) */
+#define TML_PCTG          12  /* Eadj on xmeas(40) */
+#define TML_REACTORTEMP   13  /* xmv(10) on xmeas(9) */
+#define TML_SEPTEMP       14  /* xmv(11) on xmeas(11) */
+#define TML_YA            15  /* r1 trim on yA (ricker) */
+#define TML_YAC           16  /* r1, r4 trim on yAC (ricker) */
+#define TML_PCTC          17  /* r4 on xmeas(31) (skoge) */
+#define TML_RECYCLE       18  /* r1 on xmeas(5) (skoge) */
+#define TML_NLOOP         19
+
+/* Status codes */
+#define TML_OK        0
+#define TML_EIO      -1
+#define TML_ESYNTAX  -2
+#define TML_EARG     -3
+
+typedef struct {
+	double kc, ti;   /* gain, reset time in hours */
+	double ts;       /* sample time in hours, 0 for TMLConfig.ts */
+	double lo, hi;   /* output limits */
+	double x, e;     /* initial output and last error */
+} TMLLoop;
+
+typedef struct {
+	int structure;              /* TML_RICKER or TML_SKOGE */
+	double ts;                  /* sample time of the loops, hours */
+	TMLLoop loop[TML_NLOOP];
+	double sp[TML_NLOOP];       /* setpoints of the outer loops */
+	double rate[TML_NLOOP];     /* setpoint rate limits per hour, 0 for none */
+	double xmv[TE_NU];          /* xmv(5), xmv(9), xmv(12); others unused */
+	double ovmax, ovgain;       /* recycle valve override, ovgain 0 for none */
+	double trim[2];             /* Ratio trimming states of r1 and r4 */
+	double x0[TE_NX];           /* plant states, if nx0 == TE_NX */
+	int nx0;
+} TMLConfig;
+
+typedef struct {
+	TMLConfig cfg;
+	double h;                   /* step, hours */
+	long k;                     /* steps taken */
+	long period;                /* steps between samples of the controller */
+	long every[TML_NLOOP];      /* steps per sample of each loop */
+	double x[TML_NLOOP], e[TML_NLOOP];
+	double sp[TML_NLOOP];       /* rate limited setpoints */
+	double r[7];                /* ratios r1..r7 */
+	double trim[2];
+} TMLController;
+
+const char *tml_strerror(int status);
+
+/* MultiLoop_mode1 with the initial values of initMode1.m. */
+void tml_defaults(TMLConfig *cfg);
+
+/* Applies one configuration line, which the call modifies; a blank or
+ * comment-only line changes nothing. */
+int tml_parse(char *s, TMLConfig *cfg);
+
+/* Reads a configuration file over cfg; on TML_ESYNTAX *line is the
+ * offending line. */
+int tml_load(const char *path, TMLConfig *cfg, int *line);
+
+/* Starts ctl from the states of cfg for steps of h hours; every sample
+ * time must be a whole number of steps. */
+int tml_init(TMLController *ctl, const TMLConfig *cfg, double h);
+
+/* The xmv to apply during the current step. Depends on the controller
+ * states only, so it can be taken before the plant outputs. */
+void tml_xmv(const TMLController *ctl, double *xmv);
+
+/* Takes the xmeas of a sample and advances the controller to the next,
+ * ctl->period steps on (the greatest common divisor of the loops' sample
+ * times). Called at steps 0, period, 2 period, ...; the xmv stay constant
+ * in between. */
+void tml_update(TMLController *ctl, const double *xmeas);
+
+/* Changes the setpoint of an outer loop; a rate limited setpoint moves to
+ * it at its rate. The open-loop valves are ctl->cfg.xmv. */
+int tml_setpoint(TMLController *ctl, int loop, double value);
+
+/* Loop number of a name, or -1. */
+int tml_loop(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TEMLOOP_H__ */
@@ -0,0 +1,164 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Level-2 C MEX S-function running the PCA monitor (tepca.h) in the loop.
+ *
+ * Number of inputs = 41 xmeas, 12 xmv (two ports)
+ * Number of outputs = 3: T^2, SPE and the alarm flags (1 T^2, 2 SPE)
+ * Number of parameters = 2
+ *
+ * Parameters are:
+ * 1  Name of the model file, as written by savePCA.m.
+ * 2  Samples in a row above a limit before an alarm is raised.
+ *
+ * The block takes the sample time of its inputs. The monitor advances on
+ * major time steps only, so that minor steps and zero-crossing iterations
+ * of a variable-step solver neither count toward persist nor time an
+ * alarm; they see the outputs of the last major step. The first alarm of
+ * each statistic is reported at the end of the simulation.
+ *
+ * Build: mex temon.c tepca.c
+ */
+
+#define S_FUNCTION_NAME  temon
+#define S_FUNCTION_LEVEL 2
+
+#include <stdio.h>
+#include "simstruc.h"
+#include "tepca.h"
+
+static char msg[256];  /* For error messages */
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *    Two input ports, xmeas and xmv, one output port [T2 SPE flags].
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+	ssSetNumSFcnParams(S, 2);  /* Number of expected parameters */
+	if (ssGetNumSFcnParams(S) != ssGetSFcnParamsCount(S))
+		return;     /* Simulink will report a parameter mismatch error */
+
+	ssSetNumContStates(S, 0);
+	ssSetNumDiscStates(S, 0);
+
+	if (!ssSetNumInputPorts(S, 2)) return;
+	ssSetInputPortWidth(S, 0, TE_NY);
+	ssSetInputPortWidth(S, 1, TE_NU);
+	ssSetInputPortDirectFeedThrough(S, 0, 1);
+	ssSetInputPortDirectFeedThrough(S, 1, 1);
+	ssSetInputPortRequiredContiguous(S, 0, 1);
+	ssSetInputPortRequiredContiguous(S, 1, 1);
+
+	if (!ssSetNumOutputPorts(S, 1)) return;
+	ssSetOutputPortWidth(S, 0, 3);
+
+	ssSetNumSampleTimes(S, 1);
+	ssSetNumRWork(S, 3);    /* outputs of the last major step */
+	ssSetNumIWork(S, 0);
+	ssSetNumPWork(S, 2);    /* model, monitor */
+	ssSetNumModes(S, 0);
+	ssSetNumNonsampledZCs(S, 0);
+	ssSetOptions(S, 0);
+	ssSetSFcnParamNotTunable(S, 0);
+	ssSetSFcnParamNotTunable(S, 1);
+}
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    Inherited from the inputs.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+	ssSetSampleTime(S, 0, INHERITED_SAMPLE_TIME);
+	ssSetOffsetTime(S, 0, 0.0);
+}
+
+#define MDL_START  /* Loads the model */
+#if defined(MDL_START)
+static void mdlStart(SimStruct *S)
+{
+	TPModel *model;
+	TPMonitor *mon;
+	char *name;
+	int status;
+
+	ssSetPWorkValue(S, 0, NULL);
+	ssSetPWorkValue(S, 1, NULL);
+	ssGetRWork(S)[0] = ssGetRWork(S)[1] = ssGetRWork(S)[2] = 0.;
+	if (!mxIsChar(ssGetSFcnParam(S, 0)) ||
+			!(name = mxArrayToString(ssGetSFcnParam(S, 0)))) {
+		ssSetErrorStatus(S, "Parameter 1 must be the name of a model file.");
+		return;
+	}
+	status = tp_load(name, &model);
+	if (status != TP_OK) {
+		sprintf(msg, "%.200s: %s.", name, tp_strerror(status));
+		mxFree(name);
+		ssSetErrorStatus(S, msg);
+		return;
+	}
+	mxFree(name);
+	if (tp_open(model, (int) mxGetScalar(ssGetSFcnParam(S, 1)), &mon) != TP_OK) {
+		tp_model_free(model);
+		ssSetErrorStatus(S, "Out of memory.");
+		return;
+	}
+	ssSetPWorkValue(S, 0, model);
+	ssSetPWorkValue(S, 1, mon);
+}
+#endif /* MDL_START */
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:
+ *    Updates the monitor with this step's xmeas and xmv on a major time
+ *    step, and emits the statistics of the last one.
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+	TPMonitor *mon = (TPMonitor *) ssGetPWorkValue(S, 1);
+	real_T *w = ssGetRWork(S);
+	real_T *y = ssGetOutputPortRealSignal(S, 0);
+	TPStat st;
+
+	if (ssIsMajorTimeStep(S)) {
+		tp_update(mon, ssGetT(S), ssGetInputPortRealSignal(S, 0),
+				ssGetInputPortRealSignal(S, 1), &st);
+		w[0] = st.t2;
+		w[1] = st.spe;
+		w[2] = st.flags;
+	}
+	y[0] = w[0];
+	y[1] = w[1];
+	y[2] = w[2];
+}
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    Reports the first alarms and frees the monitor.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+	TPMonitor *mon = (TPMonitor *) ssGetPWorkValue(S, 1);
+
+	if (mon) {
+		if (tp_alarm(mon, TP_T2) >= 0.)
+			mexPrintf("temon: first T^2 alarm at t = %g h\n", tp_alarm(mon, TP_T2));
+		if (tp_alarm(mon, TP_SPE) >= 0.)
+			mexPrintf("temon: first SPE alarm at t = %g h\n", tp_alarm(mon, TP_SPE));
+	}
+	tp_close(mon);
+	tp_model_free((TPModel *) ssGetPWorkValue(S, 0));
+}
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
@@ -0,0 +1,271 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Streaming PCA monitor, see tepca.h. */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tepca.h"
+#include "runstore.h"
+
+struct TPMonitor {
+	const TPModel *model;
+	int persist;
+	int run[2];             /* samples in a row above each limit */
+	double talarm[2];
+	double *z, *t;          /* m and k */
+};
+
+const char *tp_strerror(int status)
+{
+	switch (status) {
+	case TP_OK:      return "no error";
+	case TP_EIO:     return "input/output error";
+	case TP_EFORMAT: return "not a PCA model";
+	case TP_ENOMEM:  return "out of memory";
+	case TP_EARG:    return "invalid argument";
+	default:         return "unknown error";
+	}
+}
+
+int tp_model(int m, int k, TPModel **out)
+{
+	TPModel *p;
+
+	*out = NULL;
+	if (m < 1 || m > TP_MAX_VARS || k < 1 || k > m)
+		return TP_EARG;
+	if (!(p = (TPModel *) calloc(1, sizeof(TPModel))))
+		return TP_ENOMEM;
+	p->m = m;
+	p->k = k;
+	p->mean = (double *) calloc(2 * m + k + k * m, sizeof(double));
+	if (!p->mean) {
+		free(p);
+		return TP_ENOMEM;
+	}
+	p->scale = p->mean + m;
+	p->lambda = p->scale + m;
+	p->pt = p->lambda + k;
+	*out = p;
+	return TP_OK;
+}
+
+void tp_model_free(TPModel *model)
+{
+	if (model) {
+		free(model->mean);
+		free(model);
+	}
+}
+
+/* ============================================================================= */
+
+/* Model file */
+
+static int number(FILE *fp, double *v)
+{
+	int c;
+
+	for (;;) {
+		while ((c = getc(fp)) != EOF && isspace(c))
+			;
+		if (c != '#')
+			break;
+		while ((c = getc(fp)) != EOF && c != '\n')
+			;
+	}
+	if (c == EOF)
+		return 0;
+	ungetc(c, fp);
+	return fscanf(fp, "%lf", v) == 1;
+}
+
+static int numbers(FILE *fp, double *v, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		if (!number(fp, &v[i]))
+			return 0;
+	return 1;
+}
+
+int tp_load(const char *path, TPModel **out)
+{
+	TPModel *p = NULL;
+	FILE *fp;
+	double d[2], v;
+	int i, j, status = TP_EFORMAT;
+
+	*out = NULL;
+	if (!(fp = fopen(path, "r")))
+		return TP_EIO;
+	if (!numbers(fp, d, 2) || (status = tp_model((int) d[0], (int) d[1], &p)) != TP_OK) {
+		fclose(fp);
+		return status == TP_ENOMEM ? status : TP_EFORMAT;
+	}
+	status = TP_EFORMAT;
+	for (i = 0; i < p->m; i++) {
+		if (!number(fp, &v) || v < 1 || v > RS_TE_COLUMNS)
+			goto done;
+		p->vars[i] = (int) v;
+	}
+	if (!numbers(fp, p->mean, p->m) || !numbers(fp, p->scale, p->m) ||
+			!numbers(fp, p->lambda, p->k))
+		goto done;
+	for (i = 0; i < p->m; i++) {
+		if (!(p->scale[i] > 0.))
+			goto done;
+		for (j = 0; j < p->k; j++)
+			if (!number(fp, &p->pt[j * p->m + i]))
+				goto done;
+	}
+	for (j = 0; j < p->k; j++)
+		if (!(p->lambda[j] > 0.))
+			goto done;
+	if (!number(fp, &p->t2lim) || !number(fp, &p->spelim))
+		goto done;
+	status = ferror(fp) ? TP_EIO : TP_OK;
+done:
+	fclose(fp);
+	if (status != TP_OK)
+		tp_model_free(p);
+	else
+		*out = p;
+	return status;
+}
+
+int tp_save(const char *path, const TPModel *p)
+{
+	FILE *fp;
+	int i, j, ok;
+
+	if (!(fp = fopen(path, "w")))
+		return TP_EIO;
+	fprintf(fp, "# PCA model: m k, variables, mean, scale, lambda, P, T2 and SPE limits\n");
+	fprintf(fp, "%d %d\n", p->m, p->k);
+	for (i = 0; i < p->m; i++)
+		fprintf(fp, "%d%c", p->vars[i], i + 1 < p->m ? ' ' : '\n');
+	for (i = 0; i < p->m; i++)
+		fprintf(fp, "%.17g%c", p->mean[i], i + 1 < p->m ? ' ' : '\n');
+	for (i = 0; i < p->m; i++)
+		fprintf(fp, "%.17g%c", p->scale[i], i + 1 < p->m ? ' ' : '\n');
+	for (j = 0; j < p->k; j++)
+		fprintf(fp, "%.17g%c", p->lambda[j], j + 1 < p->k ? ' ' : '\n');
+	for (i = 0; i < p->m; i++)
+		for (j = 0; j < p->k; j++)
+			fprintf(fp, "%.17g%c", p->pt[j * p->m + i], j + 1 < p->k ? ' ' : '\n');
+	fprintf(fp, "%.17g %.17g\n", p->t2lim, p->spelim);
+	ok = !ferror(fp);
+	return fclose(fp) == 0 && ok ? TP_OK : TP_EIO;
+}
+
+/* ============================================================================= */
+
+/* Monitor */
+
+int tp_open(const TPModel *model, int persist, TPMonitor **out)
+{
+	TPMonitor *mon;
+
+	*out = NULL;
+	if (!(mon = (TPMonitor *) calloc(1, sizeof(TPMonitor))))
+		return TP_ENOMEM;
+	if (!(mon->z = (double *) malloc((model->m + model->k) * sizeof(double)))) {
+		free(mon);
+		return TP_ENOMEM;
+	}
+	mon->t = mon->z + model->m;
+	mon->model = model;
+	mon->persist = persist > 0 ? persist : 1;
+	tp_reset(mon);
+	*out = mon;
+	return TP_OK;
+}
+
+void tp_reset(TPMonitor *mon)
+{
+	mon->run[0] = mon->run[1] = 0;
+	mon->talarm[0] = mon->talarm[1] = -1.;
+}
+
+static double dot(const double *restrict a, const double *restrict b, int n)
+{
+	double s = 0.;
+	int i;
+
+	for (i = 0; i < n; i++)
+		s += a[i] * b[i];
+	return s;
+}
+
+int tp_update(TPMonitor *mon, double t, const double *xmeas, const double *xmv,
+		TPStat *st)
+{
+	const TPModel *p = mon->model;
+	double *restrict z = mon->z;
+	double zz, tt = 0., t2 = 0., tj;
+	int i, j, c, flags = 0;
+
+	for (i = 0; i < p->m; i++) {
+		c = p->vars[i] - 1;
+		z[i] = ((c < TE_NY ? xmeas[c] : xmv[c - TE_NY]) - p->mean[i]) / p->scale[i];
+	}
+	zz = dot(z, z, p->m);
+	for (j = 0; j < p->k; j++) {
+		tj = dot(&p->pt[j * p->m], z, p->m);
+		mon->t[j] = tj;
+		tt += tj * tj;
+		t2 += tj * tj / p->lambda[j];
+	}
+	st->t2 = t2;
+	st->spe = zz > tt ? zz - tt : 0.;
+
+	mon->run[0] = st->t2 > p->t2lim ? mon->run[0] + 1 : 0;
+	mon->run[1] = st->spe > p->spelim ? mon->run[1] + 1 : 0;
+	for (j = 0; j < 2; j++) {
+		if (mon->run[j] >= mon->persist) {
+			flags |= 1 << j;
+			if (mon->talarm[j] < 0.)
+				mon->talarm[j] = t;
+		}
+	}
+	st->flags = flags;
+	return flags;
+}
+
+double tp_alarm(const TPMonitor *mon, int which)
+{
+	return mon->talarm[which == TP_SPE ? 1 : 0];
+}
+
+static int tpsample(void *ctx, double t, const double *xmeas, const double *xmv)
+{
+	TPStat st;
+
+	tp_update((TPMonitor *) ctx, t, xmeas, xmv, &st);
+	return 0;
+}
+
+void tp_sink(TPMonitor *mon, TESink *sink)
+{
+	sink->sample = tpsample;
+	sink->ctx = mon;
+}
+
+void tp_close(TPMonitor *mon)
+{
+	if (mon) {
+		free(mon->z);
+		free(mon);
+	}
+}
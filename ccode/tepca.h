@@ -0,0 +1,110 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Streaming PCA monitor: Hotelling's T^2 and SPE (Q) per sample.
+ *
+ * A model holds, for m monitored variables, their mean and scale and the
+ * first k principal directions P (m x k) of the scaled data with their
+ * variances lambda. For a sample x with z = (x - mean) ./ scale
+ *
+ *   t   = P' z
+ *   T^2 = sum t_j^2 / lambda_j
+ *   SPE = |z - P t|^2 = |z|^2 - |t|^2
+ *
+ * and an alarm is raised when a statistic stays above its control limit
+ * for persist samples in a row. The first alarm of each statistic is
+ * timed, so that the detection latency of an attack or fault started at
+ * t0 is talarm - t0.
+ *
+ * Variables are numbered as the columns of a TE run store (runstore.h):
+ * 1..41 xmeas, 42..53 xmv. The loadings are kept transposed (k x m) so that
+ * every t_j is one contiguous dot product; the loops are written to be
+ * vectorized by the compiler.
+ *
+ * Model file: text, numbers separated by white space, '#' starts a comment:
+ *   m k
+ *   variables (m)
+ *   mean (m)
+ *   scale (m)
+ *   lambda (k)
+ *   P (m rows of k)
+ *   T2 and SPE limits
+ * as written by model/helpers/savePCA.m and tp_save().
+ */
+
+#ifndef __TEPCA_H__
+#define __TEPCA_H__
+
+#include "tesim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TP_MAX_VARS  53
+
+/* Alarm flags */
+#define TP_T2    1
+#define TP_SPE   2
+
+/* Status codes */
+#define TP_OK        0
+#define TP_EIO      -1
+#define TP_EFORMAT  -2
+#define TP_ENOMEM   -3
+#define TP_EARG     -4
+
+typedef struct {
+	int m, k;
+	int vars[TP_MAX_VARS];  /* 1-based run store columns */
+	double *mean, *scale;   /* m */
+	double *lambda;         /* k */
+	double *pt;             /* k x m, row j is direction j */
+	double t2lim, spelim;
+} TPModel;
+
+typedef struct TPMonitor TPMonitor;
+
+typedef struct {
+	double t2, spe;
+	int flags;              /* TP_T2, TP_SPE: statistics in alarm */
+} TPStat;
+
+const char *tp_strerror(int status);
+
+/* Allocates a model of m variables and k components, all zero. */
+int tp_model(int m, int k, TPModel **out);
+int tp_load(const char *path, TPModel **out);
+int tp_save(const char *path, const TPModel *model);
+void tp_model_free(TPModel *model);
+
+/* The monitor keeps a pointer to the model, which must outlive it. */
+int tp_open(const TPModel *model, int persist, TPMonitor **out);
+
+/* Updates the statistics with the sample at time t; returns the alarm
+ * flags. */
+int tp_update(TPMonitor *mon, double t, const double *xmeas, const double *xmv,
+		TPStat *st);
+
+/* Time of the first alarm of TP_T2 or TP_SPE, negative if none yet. */
+double tp_alarm(const TPMonitor *mon, int which);
+
+/* Clears the alarms for a new run. */
+void tp_reset(TPMonitor *mon);
+
+/* A sink that feeds the monitor, for TESimConfig.monitor. */
+void tp_sink(TPMonitor *mon, TESink *sink);
+
+void tp_close(TPMonitor *mon);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TEPCA_H__ */
@@ -0,0 +1,109 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Tennessee Eastman plant without Simulink, see teplant.h.
+ *
+ * The plant code is in tecore.c, which the S-functions share; this file
+ * adds the driver interface of teplant.h.
+ */
+
+#include <string.h>
+#include "tecore.c"
+
+/* ============================================================================= */
+
+/* Driver interface */
+
+void te_init(TEPlant *te, const double *x0)
+{
+	doublereal dxdt[50];
+	doublereal rt = 0.;
+
+	memset(te, 0, sizeof(*te));
+	teinit(te, &c__50, &rt, te->x, dxdt);
+	if (x0)
+		memcpy(te->x, x0, sizeof(te->x));
+	te->dvec.idv[20] = 0;
+	te->t = 0.;
+}
+
+void te_seed(TEPlant *te, double seed)
+{
+	te->randsd.g = seed;
+}
+
+void te_setidv(TEPlant *te, const double *idv)
+{
+	int i;
+
+	for (i = 0; i < TE_NIDV; i++)
+		te->dvec.idv[i] = idv ? (integer) idv[i] : 0;
+	teidv(te);
+}
+
+void te_setxmv(TEPlant *te, const double *xmv)
+{
+	memcpy(te->pv.xmv, xmv, sizeof(te->pv.xmv));
+}
+
+long te_outputs(TEPlant *te)
+{
+	tefunc(te, &c__50, &te->t, te->x, NULL);
+	if (te->dvec.idv[20] != 0 && te->t > .1)
+		return te->dvec.idv[20];
+	return 0;
+}
+
+void te_step(TEPlant *te, double h)
+{
+	doublereal dx[50];
+	int i;
+
+	tefunc(te, &c__50, &te->t, te->x, dx);
+	teopcost(te, te->t, te->pv.xmv);
+	for (i = 0; i < TE_NX; i++)
+		te->x[i] += h * dx[i];
+	te->t += h;
+}
+
+long te_advance(TEPlant *te, double h)
+{
+	doublereal dx[50];
+	double t = te->t;
+	int i;
+
+	tefunc(te, &c__50, &te->t, te->x, dx);
+	teopcost(te, te->t, te->pv.xmv);
+	for (i = 0; i < TE_NX; i++)
+		te->x[i] += h * dx[i];
+	te->t += h;
+	if (te->dvec.idv[20] != 0 && t > .1)
+		return te->dvec.idv[20];
+	return 0;
+}
+
+int te_stats(const TEPlant *te, TEStats *st)
+{
+	*st = te->stats;
+#ifdef TE_STATS
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+double te_events(const TEPlant *te, double *zc)
+{
+	return tezc(te, zc);
+}
+
+double te_hourlycost(const double *xmeas, const double *xmv)
+{
+	return tecost(xmeas, xmv);
+}
+
@@ -0,0 +1,153 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Tennessee Eastman plant without Simulink.
+ *
+ * The plant code of tecore.c (tefunc, teinit, tesub1..8), which the
+ * S-functions share, with its common blocks gathered in one context,
+ * TEPlant, so that any number of plants can run side by side in one
+ * process. A plant is copied or restored with a plain memcpy of the context.
+ *
+ * The plant is integrated as in TEModel.mdl: fixed step Euler (ode1) with
+ * step Ts_base; te_outputs() then te_step() per step reproduce the
+ * mdlOutputs/mdlDerivatives calls of the S-function. te_advance() does
+ * both with one evaluation of the plant.
+ */
+
+#ifndef __TEPLANT_H__
+#define __TEPLANT_H__
+
+#include "testats.h"
+#include "tetrace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TE_NX    50     /* continuous states */
+#define TE_NU    12     /* xmv */
+#define TE_NY    41     /* xmeas */
+#define TE_NIDV  20     /* disturbance codes */
+#define TE_NZC   4      /* zero-crossing functions, see te_events() */
+
+#define TE_TS_BASE  0.0005  /* integration step, hours */
+#define TE_TS_SAVE  0.01    /* sampling period of saved results, hours */
+#define TE_SEED     1431655765.  /* default seed of the noise generator */
+
+/* Common blocks of the Fortran code, one set per plant. */
+typedef struct TEPlant {
+	struct {
+		double xmeas[41], xmv[12];
+	} pv;
+	struct {
+		long idv[21];   /* idv[20] is isd, non-zero on shutdown */
+	} dvec;
+	struct {
+		double g;
+	} randsd;
+	struct {
+		double avp[8], bvp[8], cvp[8], ah[8], bh[8], ch[8], ag[8], bg[8],
+			cg[8], av[8], ad[8], bd[8], cd[8], xmw[8];
+	} const_;
+	struct {
+		double uclr[8], ucvr[8], utlr, utvr, xlr[8], xvr[8], etr, esr,
+			tcr, tkr, dlr, vlr, vvr, vtr, ptr, ppr[8], crxr[8], rr[4], rh,
+			fwr, twr, qur, hwr, uar, ucls[8], ucvs[8], utls, utvs, xls[8],
+			xvs[8], ets, ess, tcs, tks, dls, vls, vvs, vts, pts, pps[8],
+			fws, tws, qus, hws, uclc[8], utlc, xlc[8], etc, esc, tcc,
+			dlc, vlc, vtc, quc, ucvv[8], utvv, xvv[8], etv, esv, tcv, tkv,
+			vtv, ptv, vcv[12], vrng[12], vtau[12], ftm[13], fcm[104],
+			xst[104], xmws[13], hst[13], tst[13], sfr[8], cpflmx, cpprmx,
+			cpdh, tcwr, tcws, htr[3], agsp, xdel[41], xns[41], tgas, tprod,
+			vst[12];
+		long ivst[12];
+	} teproc;
+	struct {
+		double adist[12], bdist[12], cdist[12], ddist[12], tlast[12],
+			tnext[12], hspan[12], hzero[12], sspan[12], szero[12],
+			spspan[12];
+		long idvwlk[12];
+		double rdumm;
+	} wlk;
+	struct {
+		double xmeas[10];       /* XMEAS(42..51), see teinit */
+		double total, product;  /* $ and kmol of product from t = 0 to tlast */
+		double rate, prate;     /* $/h (te_hourlycost) and kmol/h at tlast */
+		double tlast;           /* last step, see te_step */
+	} opcost;
+	double t;               /* time, hours, of the last evaluation */
+	double x[TE_NX];        /* states */
+	char msg[256];          /* shutdown message */
+	TEStats stats;          /* with -DTE_STATS, see testats.h */
+	int kernel;             /* kernel of tefunc for dvec.idv, see tecore.c */
+	TTRBuffer *trace;       /* trace buffer (tetrace.h), or NULL */
+} TEPlant;
+
+/* Initializes the plant at t = 0 with the states x0 (TE_NX values, NULL for
+ * the defaults of temex.c), all disturbances off and the default seed. */
+void te_init(TEPlant *te, const double *x0);
+
+/* Sets the seed of the noise generator, as parameter 2 of temexr. */
+void te_seed(TEPlant *te, double seed);
+
+/* Sets the disturbance codes (TE_NIDV values, NULL for all off). */
+void te_setidv(TEPlant *te, const double *idv);
+
+/* Sets the manipulated variables (TE_NU values). */
+void te_setxmv(TEPlant *te, const double *xmv);
+
+/* Evaluates the plant at (t, x) and leaves the measurements in
+ * te->pv.xmeas, without the derivatives; xmv is not read, as in the
+ * mdlOutputs of the S-functions. Returns the shutdown code, 0
+ * while the plant runs; as in temex.c a shutdown is only reported after
+ * t = 0.1 h. */
+long te_outputs(TEPlant *te);
+
+/* Advances the states by one Euler step of h hours. The step is taken,
+ * so the cost and product totals of te->opcost are carried up to the old
+ * t and their rates taken there. */
+void te_step(TEPlant *te, double h);
+
+/* te_outputs() and te_step() with the derivatives of the output
+ * evaluation, so that a step costs one evaluation of the plant instead of
+ * two. te->pv.xmeas are the measurements at the old t. The noise generator
+ * is drawn once per step instead of twice, so a run is statistically the
+ * same as with te_outputs() and te_step() but not the model's sequence. */
+long te_advance(TEPlant *te, double h);
+
+/* Copies the counters and timers since te_init() to st. Returns 1 if
+ * teplant.c was compiled with TE_STATS, else 0 with st all zero. */
+int te_stats(const TEPlant *te, TEStats *st);
+
+/* Discontinuities of the plant for drivers that control their step. Fills
+ * zc (TE_NZC values, may be NULL) with functions of the states that change
+ * sign where the plant switches branch, as of the last evaluation:
+ *
+ *   0..3    pressure differences of the flows cut off below 0: compressor
+ *           header to reactor (stream 6), reactor to separator (7),
+ *           separator to purge (9) and header to separator (recycle valve)
+ *
+ * The branches on xmv (valve commands clamped to [0, 100], sticky valves)
+ * have none: xmv only changes at the samples of its source, where the
+ * solver steps anyway.
+ *
+ * Returns the next time event, the earliest analyzer sample or knot of a
+ * random walk, at which the plant updates its discrete state: a step that
+ * ends there lets the plant see the event when it happens. */
+double te_events(const TEPlant *te, double *zc);
+
+/* Operating cost in $/h of xmeas (TE_NY) and xmv (TE_NU), as the
+ * HourlyCost block of TEModel.mdl computes OpCost. */
+double te_hourlycost(const double *xmeas, const double *xmv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TEPLANT_H__ */
@@ -0,0 +1,267 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Wall-clock pacing of a native run, see terealtime.h. */
+
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE     /* sched_setaffinity */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "terealtime.h"
+#include "tethread.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+typedef __int64 tert_ns;
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+typedef long long tert_ns;
+#endif
+
+struct TERealtime {
+	tert_ns period, start, wake;    /* ns */
+	int flags;
+	te_mutex lock;
+	TERTMetrics m;
+};
+
+/* ============================================================================= */
+
+/* Clock */
+
+#if defined(_WIN32)
+
+static tert_ns tert_now(void)
+{
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER c;
+
+	if (freq.QuadPart == 0)
+		QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&c);
+	return (tert_ns) ((double) c.QuadPart * 1e9 / (double) freq.QuadPart);
+}
+
+/* Sleep() for all but the last 2 ms, then spin. */
+static void tert_sleep_until(tert_ns t)
+{
+	tert_ns left;
+
+	while ((left = t - tert_now()) > 0) {
+		if (left > 2000000)
+			Sleep((DWORD) ((left - 2000000) / 1000000));
+	}
+}
+
+static int tert_pin(int cpu)
+{
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) 1 << cpu) != 0;
+}
+
+static int tert_fifo(int priority)
+{
+	(void) priority;
+	return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+}
+
+#else
+
+static tert_ns tert_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (tert_ns) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void tert_sleep_until(tert_ns t)
+{
+	struct timespec ts;
+
+	ts.tv_sec = (time_t) (t / 1000000000);
+	ts.tv_nsec = (long) (t % 1000000000);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+		;
+}
+
+static int tert_pin(int cpu)
+{
+#if defined(__linux__)
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+	(void) cpu;
+	return 0;
+#endif
+}
+
+static int tert_fifo(int priority)
+{
+	struct sched_param p;
+
+	memset(&p, 0, sizeof(p));
+	p.sched_priority = priority > 0 ? priority : sched_get_priority_min(SCHED_FIFO);
+	return pthread_setschedparam(pthread_self(), SCHED_FIFO, &p) == 0;
+}
+
+#endif
+
+double tert_clock(void)
+{
+	return (double) tert_now() * 1e-9;
+}
+
+/* ============================================================================= */
+
+static int bucket(tert_ns ns)
+{
+	long long us = ns / 1000;
+	int i = 0;
+
+	while (us > 0 && i < TERT_BUCKETS - 1) {
+		us >>= 1;
+		i++;
+	}
+	return i;
+}
+
+int tert_open(const TERTConfig *cfg, double h, TERealtime **out)
+{
+	TERealtime *rt;
+
+	*out = NULL;
+	if (!(cfg->speed > 0.) || !(h > 0.))
+		return TERT_EARG;
+	if (!(rt = (TERealtime *) calloc(1, sizeof(*rt))))
+		return TERT_ENOMEM;
+	rt->period = (tert_ns) (h * 3600e9 / cfg->speed + .5);
+	if (cfg->cpu >= 0 && tert_pin(cfg->cpu))
+		rt->flags |= TERT_PINNED;
+	if (cfg->fifo && tert_fifo(cfg->priority))
+		rt->flags |= TERT_FIFO;
+	te_mutex_init(&rt->lock);
+	*out = rt;
+	return TERT_OK;
+}
+
+int tert_flags(const TERealtime *rt)
+{
+	return rt->flags;
+}
+
+void tert_step(TERealtime *rt, long k)
+{
+	tert_ns now = tert_now(), release, compute = 0, latency;
+	int miss = 0;
+
+	if (k == 0) {
+		rt->start = now;
+		rt->wake = now;
+	} else
+		compute = now - rt->wake;
+	release = rt->start + k * rt->period;
+	if (k > 0 && now > release)
+		miss = 1;
+	else
+		tert_sleep_until(release);
+	rt->wake = tert_now();
+	latency = rt->wake - release;
+
+	te_mutex_lock(&rt->lock);
+	rt->m.steps++;
+	if (miss) {
+		rt->m.misses++;
+		rt->m.lag = (double) latency * 1e-9;
+	}
+	rt->m.latency[bucket(latency)]++;
+	rt->m.sum_latency += (double) latency * 1e-9;
+	if ((double) latency * 1e-9 > rt->m.max_latency)
+		rt->m.max_latency = (double) latency * 1e-9;
+	if (k > 0) {
+		rt->m.compute[bucket(compute)]++;
+		rt->m.sum_compute += (double) compute * 1e-9;
+		if ((double) compute * 1e-9 > rt->m.max_compute)
+			rt->m.max_compute = (double) compute * 1e-9;
+	}
+	te_mutex_unlock(&rt->lock);
+}
+
+void tert_metrics(TERealtime *rt, TERTMetrics *m)
+{
+	te_mutex_lock(&rt->lock);
+	*m = rt->m;
+	te_mutex_unlock(&rt->lock);
+}
+
+/* Appends to buf as snprintf, counting the length needed past size. */
+#define PUT(...) \
+	if ((r = snprintf((size_t) len < size ? buf + len : NULL, \
+			(size_t) len < size ? size - len : 0, __VA_ARGS__)) < 0) \
+		return r; \
+	len += r;
+
+/* One histogram in Prometheus form: cumulative buckets by upper bound in
+ * seconds, then sum and count. */
+static int put_histogram(char *buf, size_t size, const char *name,
+		const char *help, const unsigned long *b, double sum)
+{
+	unsigned long n = 0;
+	int i, len = 0, r;
+
+	PUT("# HELP %s %s\n# TYPE %s histogram\n", name, help, name);
+	for (i = 0; i < TERT_BUCKETS - 1; i++) {
+		n += b[i];
+		PUT("%s_bucket{le=\"%g\"} %lu\n", name, (double) (1L << i) * 1e-6, n);
+	}
+	n += b[TERT_BUCKETS - 1];
+	PUT("%s_bucket{le=\"+Inf\"} %lu\n%s_sum %.9g\n%s_count %lu\n",
+			name, n, name, sum, name, n);
+	return len;
+}
+
+int tert_format(const TERTMetrics *m, char *buf, size_t size)
+{
+	int len = 0, r;
+
+	PUT("# HELP te_steps_total Integration steps released.\n"
+			"# TYPE te_steps_total counter\nte_steps_total %lu\n", m->steps);
+	PUT("# HELP te_deadline_misses_total Steps reached after their release time.\n"
+			"# TYPE te_deadline_misses_total counter\nte_deadline_misses_total %lu\n",
+			m->misses);
+	PUT("# HELP te_lag_seconds Delay behind schedule at the last miss.\n"
+			"# TYPE te_lag_seconds gauge\nte_lag_seconds %.9g\n", m->lag);
+	if ((r = put_histogram((size_t) len < size ? buf + len : NULL,
+			(size_t) len < size ? size - len : 0, "te_step_latency_seconds",
+			"Step start minus release time.", m->latency, m->sum_latency)) < 0)
+		return r;
+	len += r;
+	if ((r = put_histogram((size_t) len < size ? buf + len : NULL,
+			(size_t) len < size ? size - len : 0, "te_step_compute_seconds",
+			"Compute time of a step.", m->compute, m->sum_compute)) < 0)
+		return r;
+	len += r;
+	return len;
+}
+
+void tert_close(TERealtime *rt)
+{
+	if (!rt)
+		return;
+	te_mutex_destroy(&rt->lock);
+	free(rt);
+}
@@ -0,0 +1,87 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Wall-clock pacing of a native run.
+ *
+ * Releases integration step k at start + k * Ts_base / speed on a monotonic
+ * clock, so that the plant runs in real time (speed 1) or a multiple of it.
+ * Optionally pins the simulation thread to one CPU and runs it under
+ * SCHED_FIFO (Win32: time-critical priority) when the system allows it.
+ *
+ * A step whose release time has already passed when it is reached is a
+ * deadline miss; it runs at once and the plant catches up with the wall
+ * clock. Per step the wake-up latency (actual start - release time) and the
+ * compute time of the previous step go into log2 histograms, readable from
+ * any thread with tert_metrics() and printable in the Prometheus text
+ * format with tert_format().
+ */
+
+#ifndef __TEREALTIME_H__
+#define __TEREALTIME_H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TERT_BUCKETS 24         /* bucket i: [2^(i-1), 2^i) us, 0: < 1 us */
+
+/* Status codes and tert_flags() */
+#define TERT_OK       0
+#define TERT_ENOMEM  -1
+#define TERT_EARG    -2
+#define TERT_PINNED   1         /* thread pinned to cfg.cpu */
+#define TERT_FIFO     2         /* thread runs with real-time priority */
+
+typedef struct {
+	double speed;           /* simulated time per wall time, > 0 */
+	int cpu;                /* CPU to pin the thread to, -1 for none */
+	int fifo;               /* request SCHED_FIFO */
+	int priority;           /* SCHED_FIFO priority, 0 for the minimum */
+} TERTConfig;
+
+typedef struct {
+	unsigned long steps, misses;
+	double lag;             /* seconds behind schedule at the last miss */
+	double max_latency, sum_latency;    /* seconds */
+	double max_compute, sum_compute;    /* seconds */
+	unsigned long latency[TERT_BUCKETS], compute[TERT_BUCKETS];
+} TERTMetrics;
+
+typedef struct TERealtime TERealtime;
+
+/* Prepares pacing of steps of h hours. Must be called on the thread that
+ * runs the simulation; pinning and priority apply to it. */
+int tert_open(const TERTConfig *cfg, double h, TERealtime **out);
+
+/* TERT_PINNED and TERT_FIFO as far as they could be applied. */
+int tert_flags(const TERealtime *rt);
+
+/* Waits for the release time of step k; step 0 starts the clock. */
+void tert_step(TERealtime *rt, long k);
+
+/* Consistent copy of the counters, from any thread. */
+void tert_metrics(TERealtime *rt, TERTMetrics *m);
+
+/* Writes m in the Prometheus text format. Returns the length written, or
+ * the length needed if size is too small, as snprintf. */
+int tert_format(const TERTMetrics *m, char *buf, size_t size);
+
+void tert_close(TERealtime *rt);
+
+/* The monotonic clock of the pacing, in seconds, for timing parts of a
+ * run. */
+double tert_clock(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TEREALTIME_H__ */
@@ -0,0 +1,475 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Detection-latency benchmark, see tescen.h. */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "runstore.h"
+#include "tescen.h"
+#include "tethread.h"
+
+#if defined(_WIN32)
+#include <direct.h>
+#define mkdir(d, mode) _mkdir(d)
+#else
+#include <sys/stat.h>
+#endif
+
+#define TSN_MAX_THREADS 256
+
+static const char *const builtin[] = {
+	"int-xmeas7   1 xmeas 7 integrity step 2800 1 0",
+	"int-xmeas9   1 xmeas 9 integrity step 130 1 0",
+	"int-xmv3     1 xmv 3 integrity step 0 1 0",
+	"int-xmv10    1 xmv 10 integrity step 0 1 0",
+	"dos-xmeas7   1 xmeas 7 dos step 0 1 0",
+	"dos-xmeas9   1 xmeas 9 dos step 0 1 0",
+	"per-xmeas7   1 xmeas 7 integrity periodic 2800 1 0.1",
+	"per-xmeas9   1 xmeas 9 integrity periodic 130 1 0.1",
+	"per-xmv3     1 xmv 3 integrity periodic 0 1 0.1",
+	"per-xmv10    1 xmv 10 integrity periodic 0 1 0.1",
+};
+
+const char *tsn_strerror(int status)
+{
+	switch (status) {
+	case TSN_OK:      return "no error";
+	case TSN_EIO:     return "input/output error";
+	case TSN_ESYNTAX: return "syntax error";
+	case TSN_ENOMEM:  return "out of memory";
+	case TSN_EARG:    return "invalid argument";
+	case TSN_ETHREAD: return "cannot start a thread";
+	default:          return "unknown error";
+	}
+}
+
+/* ============================================================================= */
+
+/* Library */
+
+void tsn_free(TSNLibrary *lib)
+{
+	int i;
+
+	if (lib) {
+		for (i = 0; i < lib->n; i++)
+			ta_free(lib->s[i].attack);
+		free(lib->s);
+		free(lib);
+	}
+}
+
+/* Appends the scenario of one line to lib. */
+static int parse(const char *line, TSNLibrary *lib, int *cap)
+{
+	static const char *const sep = " \t\r\n";
+	TSNScenario *s;
+	char buf[TSN_LINE], *name, *onset, *rest, *end;
+	long k;
+	int status;
+
+	if (strlen(line) >= TSN_LINE)
+		return TSN_ESYNTAX;
+	strcpy(buf, line);
+	if ((end = strchr(buf, '#')))
+		*end = '\0';
+	if (!(name = strtok(buf, sep)))
+		return TSN_OK;   /* blank line */
+	if (!(onset = strtok(NULL, sep)) || !(rest = strtok(NULL, "")) ||
+			strlen(name) >= TSN_NAME)
+		return TSN_ESYNTAX;
+	if (lib->n == *cap) {
+		*cap = *cap ? 2 * *cap : 32;
+		if (!(s = (TSNScenario *) realloc(lib->s, *cap * sizeof(TSNScenario))))
+			return TSN_ENOMEM;
+		lib->s = s;
+	}
+	s = &lib->s[lib->n];
+	memset(s, 0, sizeof(*s));
+	strcpy(s->name, name);
+	s->onset = strtod(onset, &end);
+	if (end == onset || *end != '\0' || s->onset < 0.)
+		return TSN_ESYNTAX;
+	rest += strspn(rest, sep);
+	for (end = rest + strlen(rest); end > rest && strchr(sep, end[-1]); end--)
+		;
+	*end = '\0';
+	strcpy(s->spec, rest);
+	if (strncmp(rest, "idv", 3) == 0 && rest[3] && strchr(sep, rest[3])) {
+		k = strtol(rest + 4, &end, 10);
+		if (end == rest + 4 || strspn(end, sep) != strlen(end) || k < 1 || k > TE_NIDV)
+			return TSN_ESYNTAX;
+		s->idv = (int) k;
+	} else {
+		if (!(s->attack = ta_new()))
+			return TSN_ENOMEM;
+		status = ta_parse(rest, s->attack);
+		if (status != TA_OK) {
+			ta_free(s->attack);
+			return status == TA_ENOMEM ? TSN_ENOMEM : TSN_ESYNTAX;
+		}
+	}
+	lib->n++;
+	return TSN_OK;
+}
+
+int tsn_load(const char *path, TSNLibrary **out, int *line)
+{
+	TSNLibrary *lib;
+	FILE *fp;
+	char s[TSN_LINE];
+	int cap = 0, status = TSN_OK;
+
+	*out = NULL;
+	*line = 0;
+	if (!(fp = fopen(path, "r")))
+		return TSN_EIO;
+	if (!(lib = (TSNLibrary *) calloc(1, sizeof(TSNLibrary)))) {
+		fclose(fp);
+		return TSN_ENOMEM;
+	}
+	while (status == TSN_OK && fgets(s, TSN_LINE, fp)) {
+		++*line;
+		status = parse(s, lib, &cap);
+	}
+	if (status == TSN_OK && ferror(fp))
+		status = TSN_EIO;
+	fclose(fp);
+	if (status != TSN_OK) {
+		tsn_free(lib);
+		return status;
+	}
+	*line = 0;
+	*out = lib;
+	return TSN_OK;
+}
+
+int tsn_builtin(TSNLibrary **out)
+{
+	TSNLibrary *lib;
+	char s[TSN_LINE];
+	int i, cap = 0, status = TSN_OK;
+
+	*out = NULL;
+	if (!(lib = (TSNLibrary *) calloc(1, sizeof(TSNLibrary))))
+		return TSN_ENOMEM;
+	for (i = 1; i <= TE_NIDV && status == TSN_OK; i++) {
+		sprintf(s, "idv%-9d1 idv %d", i, i);
+		status = parse(s, lib, &cap);
+	}
+	for (i = 0; i < (int) (sizeof(builtin) / sizeof(builtin[0])) && status == TSN_OK; i++)
+		status = parse(builtin[i], lib, &cap);
+	if (status != TSN_OK) {
+		tsn_free(lib);
+		return status;
+	}
+	*out = lib;
+	return TSN_OK;
+}
+
+/* ============================================================================= */
+
+/* Run cache */
+
+/* FNV-1a */
+static unsigned long long hash(unsigned long long h, const void *p, size_t n)
+{
+	const unsigned char *b = (const unsigned char *) p;
+
+	while (n-- > 0)
+		h = (h ^ *b++) * 0x100000001b3ULL;
+	return h;
+}
+
+static double seedof(const TSNConfig *cfg, int seed)
+{
+	return (cfg->sim.seed != 0. ? cfg->sim.seed : TE_SEED) + seed;
+}
+
+void tsn_path(const TSNConfig *cfg, const TSNScenario *s, int seed, char *buf,
+		size_t n)
+{
+	const TESimConfig *sim = &cfg->sim;
+	unsigned long long h = 0xcbf29ce484222325ULL;
+	double v[5];
+
+	v[0] = s->onset;
+	v[1] = sim->tstop;
+	v[2] = sim->ts_base > 0. ? sim->ts_base : TE_TS_BASE;
+	v[3] = sim->ts_save > 0. ? sim->ts_save : TE_TS_SAVE;
+	v[4] = seedof(cfg, seed);
+	h = hash(h, s->spec, strlen(s->spec));
+	h = hash(h, v, sizeof(v));
+	if (sim->x0)
+		h = hash(h, sim->x0, TE_NX * sizeof(double));
+	if (sim->xmv)
+		h = hash(h, sim->xmv, TE_NU * sizeof(double));
+	if (sim->control)
+		h = hash(h, sim->control, sizeof(TMLConfig));
+	if (sim->fused)
+		h = hash(h, &sim->fused, sizeof(sim->fused));
+	sprintf(buf, "%.*s", (int) (n > 24 ? n - 24 : 0), cfg->cache);
+	sprintf(buf + strlen(buf), "/%016llx.rs", h);
+}
+
+typedef struct {
+	const TSNConfig *cfg;
+	const TSNLibrary *lib;
+	te_mutex lock;
+	int next, nruns, ran, status;
+} TSNBatch;
+
+static int storesample(void *ctx, double t, const double *xmeas, const double *xmv)
+{
+	RunStoreWriter *w = (RunStoreWriter *) ctx;
+	double row[RS_TE_COLUMNS];
+
+	memcpy(&row[RS_XMEAS_COLUMN - 1], xmeas, TE_NY * sizeof(double));
+	memcpy(&row[RS_XMV_COLUMN - 1], xmv, TE_NU * sizeof(double));
+	return rs_append(w, t, row) != RS_OK;
+}
+
+/* Simulates run r into the cache unless it is there. The store is written
+ * under a temporary name and renamed when complete, so that an interrupted
+ * benchmark leaves no partial runs behind. */
+static int simulate(TSNBatch *b, int r, int *ran)
+{
+	const TSNScenario *s = &b->lib->s[r / b->cfg->nseeds];
+	TESimConfig sim = b->cfg->sim;
+	TESimResult res;
+	TESink sink;
+	RunStoreWriter *w;
+	RunStore *st;
+	double idv[TE_NIDV];
+	char path[FILENAME_MAX], tmp[FILENAME_MAX + 8];
+	int status;
+
+	*ran = 0;
+	tsn_path(b->cfg, s, r % b->cfg->nseeds, path, sizeof(path));
+	if (rs_open(path, &st) == RS_OK) {
+		rs_free(st);
+		return TSN_OK;
+	}
+	sprintf(tmp, "%s.tmp", path);
+	if (rs_create(tmp, RS_TE_COLUMNS, 0, &w) != RS_OK)
+		return TSN_EIO;
+	memset(idv, 0, sizeof(idv));
+	if (s->idv > 0)
+		idv[s->idv - 1] = 1.;
+	sim.idv = idv;
+	sim.tidv = s->onset;
+	sim.seed = seedof(b->cfg, r % b->cfg->nseeds);
+	sim.attack = s->attack;
+	sim.telemetry = NULL;
+	sim.realtime = NULL;
+	sim.opcost = NULL;
+	sim.resume = NULL;
+	sim.monitor = NULL;
+	sink.sample = storesample;
+	sink.ctx = w;
+	status = tesim_run(&sim, &sink, &res);
+	if (rs_close(w) != RS_OK || status != TESIM_OK || rename(tmp, path) != 0) {
+		remove(tmp);
+		return status == TESIM_EARG ? TSN_EARG : TSN_EIO;
+	}
+	*ran = 1;
+	return TSN_OK;
+}
+
+static TE_THREAD_FN(worker, arg)
+{
+	TSNBatch *b = (TSNBatch *) arg;
+	int r, ran = 0, status = TSN_OK;
+
+	for (;;) {
+		te_mutex_lock(&b->lock);
+		if (status != TSN_OK && b->status == TSN_OK)
+			b->status = status;
+		b->ran += ran;
+		r = b->status == TSN_OK ? b->next++ : b->nruns;
+		te_mutex_unlock(&b->lock);
+		if (r >= b->nruns)
+			break;
+		status = simulate(b, r, &ran);
+	}
+	return TE_THREAD_RETURN;
+}
+
+int tsn_simulate(const TSNConfig *cfg, const TSNLibrary *lib, int *ran)
+{
+	te_thread threads[TSN_MAX_THREADS];
+	TSNBatch b;
+	int i, n = cfg->nthreads > 0 ? cfg->nthreads : te_ncpu();
+
+	if (ran)
+		*ran = 0;
+	if (cfg->nseeds < 1 || !cfg->cache || tesim_samples(&cfg->sim) == 0)
+		return TSN_EARG;
+	mkdir(cfg->cache, 0777);   /* fails harmlessly if it exists */
+	if (n < 1)
+		n = 1;
+	if (n > TSN_MAX_THREADS)
+		n = TSN_MAX_THREADS;
+	memset(&b, 0, sizeof(b));
+	b.cfg = cfg;
+	b.lib = lib;
+	b.nruns = lib->n * cfg->nseeds;
+	te_mutex_init(&b.lock);
+	for (i = 0; i < n; i++)
+		if (te_thread_create(&threads[i], worker, &b) != 0)
+			break;
+	if (i == 0)
+		b.status = TSN_ETHREAD;
+	while (i-- > 0)
+		te_thread_join(threads[i]);
+	te_mutex_destroy(&b.lock);
+	if (ran)
+		*ran = b.ran;
+	return b.status;
+}
+
+/* ============================================================================= */
+
+/* Scoring */
+
+/* Replays one stored run through all detectors into res (ndet entries). */
+static int replay(const char *path, double onset, const TSNDetector *det, int ndet,
+		TSNResult *res, double *t, double *y, size_t maxrows)
+{
+	int cols[RS_TE_COLUMNS];
+	RunStore *s;
+	RunStoreInfo info;
+	double xmeas[TE_NY], xmv[TE_NU];
+	long n, pos = 0, i, before = 0;
+	int j, c, on, *nalarm, *was;
+
+	for (c = 0; c < RS_TE_COLUMNS; c++)
+		cols[c] = c + 1;
+	if (rs_open(path, &s) != RS_OK)
+		return TSN_EIO;
+	rs_info(s, &info);
+	if ((size_t) info.blockrows > maxrows) {
+		rs_free(s);
+		return TSN_EIO;
+	}
+	if (!(nalarm = (int *) calloc(2 * ndet, sizeof(int)))) {
+		rs_free(s);
+		return TSN_ENOMEM;
+	}
+	was = nalarm + ndet;
+	for (j = 0; j < ndet; j++) {
+		det[j].reset(det[j].ctx);
+		res[j].onset = onset;
+		res[j].tend = 0.;
+		res[j].tfalse = res[j].tdetect = -1.;
+		res[j].far = 0.;
+	}
+	while ((n = rs_next(s, &pos, cols, RS_TE_COLUMNS, t, y, maxrows)) > 0) {
+		for (i = 0; i < n; i++) {
+			for (c = 0; c < TE_NY; c++)
+				xmeas[c] = y[(RS_XMEAS_COLUMN - 1 + c) * maxrows + i];
+			for (c = 0; c < TE_NU; c++)
+				xmv[c] = y[(RS_XMV_COLUMN - 1 + c) * maxrows + i];
+			if (t[i] < onset)
+				before++;
+			for (j = 0; j < ndet; j++) {
+				res[j].tend = t[i];
+				on = det[j].update(det[j].ctx, t[i], xmeas, xmv) != 0;
+				if (on && t[i] < onset) {
+					nalarm[j]++;
+					if (res[j].tfalse < 0.)
+						res[j].tfalse = t[i];
+				} else if (on && !was[j] && res[j].tdetect < 0.)
+					res[j].tdetect = t[i];
+				was[j] = on;
+			}
+		}
+	}
+	for (j = 0; j < ndet; j++)
+		res[j].far = before > 0 ? (double) nalarm[j] / before : 0.;
+	free(nalarm);
+	rs_free(s);
+	return n < 0 ? TSN_EIO : TSN_OK;
+}
+
+int tsn_score(const TSNConfig *cfg, const TSNLibrary *lib,
+		const TSNDetector *det, int ndet, TSNResult *res)
+{
+	char path[FILENAME_MAX];
+	double *buf;
+	size_t maxrows = RS_DEFAULT_BLOCK_ROWS;
+	int i, seed, status = TSN_OK;
+
+	if (cfg->nseeds < 1 || ndet < 1 || !cfg->cache)
+		return TSN_EARG;
+	if (!(buf = (double *) malloc((RS_TE_COLUMNS + 1) * maxrows * sizeof(double))))
+		return TSN_ENOMEM;
+	for (i = 0; i < lib->n && status == TSN_OK; i++) {
+		for (seed = 0; seed < cfg->nseeds && status == TSN_OK; seed++) {
+			tsn_path(cfg, &lib->s[i], seed, path, sizeof(path));
+			status = replay(path, lib->s[i].onset, det, ndet,
+					&res[(i * cfg->nseeds + seed) * ndet], buf,
+					buf + maxrows, maxrows);
+		}
+	}
+	free(buf);
+	return status;
+}
+
+static int cmp(const void *a, const void *b)
+{
+	double x = *(const double *) a, y = *(const double *) b;
+
+	return x < y ? -1 : x > y;
+}
+
+/* Quantile q of the n sorted values v, linearly interpolated. */
+static double quantile(const double *v, int n, double q)
+{
+	double x = q * (n - 1);
+	int i = (int) x;
+
+	return i + 1 < n ? v[i] + (x - i) * (v[i + 1] - v[i]) : v[n - 1];
+}
+
+void tsn_stats(const TSNResult *res, int n, int stride, TSNStats *st)
+{
+	double *lat;
+	int i;
+
+	memset(st, 0, sizeof(*st));
+	st->min = st->median = st->mean = st->p90 = st->max = -1.;
+	if (n < 1 || !(lat = (double *) malloc(n * sizeof(double))))
+		return;
+	for (i = 0; i < n; i++, res += stride) {
+		st->runs++;
+		st->far += res->far;
+		if (res->tfalse >= 0.)
+			st->falsealarms++;
+		if (res->tdetect >= 0.)
+			lat[st->detected++] = res->tdetect - res->onset;
+	}
+	st->far /= st->runs;
+	if (st->detected > 0) {
+		qsort(lat, st->detected, sizeof(double), cmp);
+		st->min = lat[0];
+		st->max = lat[st->detected - 1];
+		st->median = quantile(lat, st->detected, .5);
+		st->p90 = quantile(lat, st->detected, .9);
+		for (st->mean = 0., i = 0; i < st->detected; i++)
+			st->mean += lat[i];
+		st->mean /= st->detected;
+	}
+	free(lat);
+}
@@ -0,0 +1,127 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Detection-latency benchmark over a library of scenarios.
+ *
+ * A scenario is a disturbance (IDV 1..20) or an attack (teattack.h) that
+ * starts at its onset time. Every scenario is simulated with nseeds fixed
+ * noise seeds, seed + i for i = 0..nseeds-1, by a pool of threads, and
+ * every run is kept as a run store (runstore.h) in a cache directory under
+ * a name derived from the scenario line, the seed and the horizon. Runs
+ * found in the cache are not simulated again, so that scoring another
+ * detector only replays the stored samples.
+ *
+ * Detectors are plugged in through TSNDetector. Per run and detector the
+ * score is the first alarm before the onset (a false alarm), the first
+ * alarm raised from the onset on (the detection, latency = talarm - onset;
+ * an alarm that is still on from before the onset does not count) and the
+ * share of samples before the onset in alarm. tsn_stats() reduces
+ * the runs of a scenario to the latency distribution.
+ *
+ * Library file: text, '#' starts a comment, one scenario per line
+ *   name onset idv k
+ *   name onset xmv|xmeas block type mode value start duration [...]
+ * the second form being a line of an attack table. tsn_builtin() is the
+ * default library: the 20 IDVs and integrity, DOS and periodic attacks on
+ * the reactor pressure and temperature and on the A feed and reactor
+ * cooling valves, all from t = 1 h.
+ */
+
+#ifndef __TESCEN_H__
+#define __TESCEN_H__
+
+#include <stddef.h>
+#include "tesim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TSN_NAME    32
+#define TSN_LINE    256
+
+/* Status codes */
+#define TSN_OK       0
+#define TSN_EIO     -1
+#define TSN_ESYNTAX -2
+#define TSN_ENOMEM  -3
+#define TSN_EARG    -4
+#define TSN_ETHREAD -5
+
+typedef struct {
+	char name[TSN_NAME];
+	double onset;           /* hours */
+	int idv;                /* 1..20, 0 for an attack */
+	TEAttackTable *attack;  /* or NULL */
+	char spec[TSN_LINE];    /* the line after the name, keys the cache */
+} TSNScenario;
+
+typedef struct {
+	TSNScenario *s;
+	int n;
+} TSNLibrary;
+
+typedef struct {
+	TESimConfig sim;        /* plant, horizon and first seed; idv, tidv,
+	                           attack, telemetry, realtime, opcost, resume
+	                           and monitor are not used */
+	const char *cache;      /* directory of the stored runs */
+	int nseeds;
+	int nthreads;           /* 0 for one per CPU */
+} TSNConfig;
+
+/* A detector; update returns nonzero while it is in alarm. */
+typedef struct {
+	const char *name;
+	void *ctx;
+	void (*reset)(void *ctx);
+	int (*update)(void *ctx, double t, const double *xmeas, const double *xmv);
+} TSNDetector;
+
+typedef struct {
+	double onset, tend;     /* tend: last sample, earlier on a shutdown */
+	double tfalse;          /* first alarm before onset, negative if none */
+	double tdetect;         /* first alarm raised from onset on, negative
+	                           if none */
+	double far;             /* share of the samples before onset in alarm */
+} TSNResult;
+
+typedef struct {
+	int runs, detected, falsealarms;
+	double far;             /* mean over the runs */
+	double min, median, mean, p90, max;  /* latency of the detected runs */
+} TSNStats;
+
+const char *tsn_strerror(int status);
+
+/* Reads a library file; on TSN_ESYNTAX *line is the offending line. */
+int tsn_load(const char *path, TSNLibrary **out, int *line);
+int tsn_builtin(TSNLibrary **out);
+void tsn_free(TSNLibrary *lib);
+
+/* Cache file of run seed (0..nseeds-1) of scenario s. */
+void tsn_path(const TSNConfig *cfg, const TSNScenario *s, int seed, char *buf,
+		size_t n);
+
+/* Simulates the runs missing from the cache; *ran (may be NULL) receives
+ * their number. */
+int tsn_simulate(const TSNConfig *cfg, const TSNLibrary *lib, int *ran);
+
+/* Scores the cached runs: res has lib->n * nseeds * ndet entries, run
+ * seed of scenario i and detector j at (i * nseeds + seed) * ndet + j. */
+int tsn_score(const TSNConfig *cfg, const TSNLibrary *lib,
+		const TSNDetector *det, int ndet, TSNResult *res);
+
+/* Statistics of n results taken every stride entries. */
+void tsn_stats(const TSNResult *res, int n, int stride, TSNStats *st);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TESCEN_H__ */
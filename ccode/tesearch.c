@@ -0,0 +1,166 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Parallel threshold search over one attack parameter, see tesearch.h. */
+
+#include <stdlib.h>
+#include <string.h>
+#include "tesearch.h"
+#include "tethread.h"
+
+#define TSR_MAX_THREADS 256
+
+typedef struct {
+	const TSRConfig *cfg;
+	const TESimSnapshot *snap;
+	double p;               /* parameter of this probe */
+	long isd;               /* result */
+	double t;
+	int status;
+} TSRProbe;
+
+const char *tsr_strerror(int status)
+{
+	switch (status) {
+	case TSR_OK:       return "no error";
+	case TSR_EARG:     return "invalid search";
+	case TSR_ENOMEM:   return "out of memory";
+	case TSR_ETHREAD:  return "cannot start a thread";
+	case TSR_EBRACKET: return "the threshold is not inside the bracket";
+	case TSR_EEARLY:   return "the plant shuts down before the attack";
+	default:           return "unknown error";
+	}
+}
+
+static TE_THREAD_FN(probe, arg)
+{
+	TSRProbe *p = (TSRProbe *) arg;
+	TESimConfig sim = p->cfg->sim;
+	TESimResult res;
+	TEAttackTable *t;
+	TEAttack a = p->cfg->attack;
+
+	if (p->cfg->param == TSR_VALUE)
+		a.value = p->p;
+	else
+		a.duration = p->p;
+	sim.telemetry = NULL;
+	sim.realtime = NULL;
+	sim.opcost = NULL;
+	sim.resume = p->snap;
+	memset(&res, 0, sizeof(res));
+	p->status = TSR_ENOMEM;
+	if ((t = ta_new())) {
+		p->status = ta_add(t, &a) == TA_OK ? TSR_OK : TSR_EARG;
+		sim.attack = t;
+		if (p->status == TSR_OK && tesim_run(&sim, NULL, &res) != TESIM_OK)
+			p->status = TSR_EARG;
+		ta_free(t);
+	}
+	p->isd = res.isd;
+	p->t = res.t;
+	return TE_THREAD_RETURN;
+}
+
+static int tripped(const TSRConfig *cfg, const TSRProbe *p)
+{
+	return p->isd != 0 && (cfg->isd == 0 || p->isd == cfg->isd);
+}
+
+/* Runs the n probes, all but the last on threads of their own. */
+static int runprobes(TSRProbe *p, int n)
+{
+	te_thread threads[TSR_MAX_THREADS];
+	int i, started, status = TSR_OK;
+
+	for (started = 0; started < n - 1; started++)
+		if (te_thread_create(&threads[started], probe, &p[started]) != 0)
+			break;
+	for (i = started; i < n; i++)
+		probe(&p[i]);
+	while (started-- > 0)
+		te_thread_join(threads[started]);
+	for (i = 0; i < n; i++)
+		if (p[i].status != TSR_OK)
+			status = p[i].status;
+	return status;
+}
+
+int tsr_run(const TSRConfig *cfg, TSRResult *res)
+{
+	TSRProbe p[TSR_MAX_THREADS];
+	TESimSnapshot *snap;
+	TESimConfig sim = cfg->sim;
+	TESimResult r;
+	double lo = cfg->lo, hi = cfg->hi;
+	int i, n = cfg->nthreads > 0 ? cfg->nthreads : te_ncpu(), status;
+
+	memset(res, 0, sizeof(*res));
+	if ((cfg->param != TSR_VALUE && cfg->param != TSR_DURATION) ||
+			!(lo < hi) || !(cfg->tol > 0.))
+		return TSR_EARG;
+	if (n < 1)
+		n = 1;
+	if (n > TSR_MAX_THREADS)
+		n = TSR_MAX_THREADS;
+
+	/* The unattacked run up to the start of the attack */
+	if (!(snap = (TESimSnapshot *) malloc(sizeof(TESimSnapshot))))
+		return TSR_ENOMEM;
+	sim.attack = NULL;
+	sim.telemetry = NULL;
+	sim.realtime = NULL;
+	sim.opcost = NULL;
+	sim.resume = NULL;
+	status = tesim_snapshot(&sim, cfg->attack.start > 0. ? cfg->attack.start : 0.,
+			snap, &r);
+	res->runs = 1;
+	if (status != TESIM_OK || r.isd != 0) {
+		free(snap);
+		return status != TESIM_OK ? TSR_EARG : TSR_EEARLY;
+	}
+
+	for (i = 0; i < n || i < 2; i++) {
+		p[i].cfg = cfg;
+		p[i].snap = snap;
+	}
+	/* The bracket ends, together if there are two threads */
+	p[0].p = lo;
+	p[1].p = hi;
+	if (n >= 2)
+		status = runprobes(p, 2);
+	else if ((status = runprobes(p, 1)) == TSR_OK)
+		status = runprobes(p + 1, 1);
+	res->runs += 2;
+	if (status == TSR_OK && (tripped(cfg, &p[0]) || !tripped(cfg, &p[1])))
+		status = TSR_EBRACKET;
+	res->isd = p[1].isd;
+	res->t = p[1].t;
+
+	while (status == TSR_OK && hi - lo > cfg->tol) {
+		for (i = 0; i < n; i++)
+			p[i].p = lo + (hi - lo) * (i + 1) / (n + 1);
+		if ((status = runprobes(p, n)) != TSR_OK)
+			break;
+		res->runs += n;
+		for (i = 0; i < n && !tripped(cfg, &p[i]); i++)
+			;
+		if (i > 0)
+			lo = p[i - 1].p;
+		if (i < n) {
+			hi = p[i].p;
+			res->isd = p[i].isd;
+			res->t = p[i].t;
+		}
+	}
+	free(snap);
+	res->lo = lo;
+	res->hi = hi;
+	return status;
+}
@@ -0,0 +1,73 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Parallel threshold search over one attack parameter.
+ *
+ * Finds the smallest value or duration of an attack (teattack.h) that
+ * shuts the plant down, e.g. the shortest DOS on xmv(k) from t that trips
+ * the reactor pressure limit. The plant is assumed to trip for every
+ * parameter above the threshold and for none below.
+ *
+ * Each round runs n probes, one per thread, evenly spaced inside the
+ * current bracket [lo, hi], and keeps the gap between the last probe that
+ * did not trip and the first one that did: the bracket shrinks by n + 1
+ * per round, plain bisection for one thread. The part of the run before
+ * the attack starts is the same for every probe and is simulated once
+ * (tesim_snapshot), so a probe only runs from the start of the attack.
+ */
+
+#ifndef __TESEARCH_H__
+#define __TESEARCH_H__
+
+#include "teattack.h"
+#include "tesim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Parameter searched */
+#define TSR_VALUE     1
+#define TSR_DURATION  2
+
+/* Status codes */
+#define TSR_OK         0
+#define TSR_EARG      -1
+#define TSR_ENOMEM    -2
+#define TSR_ETHREAD   -3
+#define TSR_EBRACKET  -4   /* lo trips or hi does not */
+#define TSR_EEARLY    -5   /* the plant shuts down before the attack */
+
+typedef struct {
+	TESimConfig sim;        /* plant and horizon; attack, telemetry,
+	                           realtime and opcost are not used */
+	TEAttack attack;        /* the attack; the parameter is replaced */
+	int param;              /* TSR_VALUE or TSR_DURATION */
+	double lo, hi;          /* initial bracket */
+	double tol;             /* stop when hi - lo <= tol */
+	long isd;               /* shutdown code to reach, 0 for any */
+	int nthreads;           /* 0 for one per CPU */
+} TSRConfig;
+
+typedef struct {
+	double lo, hi;          /* final bracket: lo does not trip, hi does */
+	long isd;               /* shutdown code at hi */
+	double t;               /* time of that shutdown, hours */
+	int runs;               /* simulations run, snapshot included */
+} TSRResult;
+
+int tsr_run(const TSRConfig *cfg, TSRResult *res);
+
+const char *tsr_strerror(int status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TESEARCH_H__ */
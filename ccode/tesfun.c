@@ -0,0 +1,812 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Common body of the TE S-functions temex, temexd and temexr.
+ *
+ * Each S-function sets S_FUNCTION_NAME and its configuration and includes
+ * this file, which includes the plant code (tecore.c). The configuration
+ * is compiled in, so the plant never tests it at run time:
+ *
+ *   TE_IDV_SOURCE   TE_IDV_PARAM: the disturbance codes are parameter 2
+ *                   TE_IDV_INPUT: they are inputs 13..32 after the xmv
+ *   TE_SEED_SOURCE  TE_SEED_FIXED: the noise starts from the seed of teinit
+ *                   TE_SEED_PARAM: the seed is the last parameter, drawn
+ *                   from the clock if empty
+ *   TE_NOISE        1 (default) or 0 for noise-free measurements
+ *
+ * The parameters are the initial states, then the disturbance codes and
+ * the seed if so configured, then with -DTE_TELEMETRY the name of the
+ * block's telemetry ring (tetelem.h), TE_TELEMETRY_NAME if empty; each
+ * block of a model needs a ring of its own. The output ports are
+ * XMEAS(1..41), then XMEAS(42..51) and the totals with -DTE_OPCOST and the
+ * counters and timers with -DTE_STATS. -DTE_TRACE adds a trace buffer
+ * (tetrace.h) per block, saved at the end to a file named after the block
+ * path, see tracefile. -DTE_EVENTS registers the discontinuities of the
+ * plant for variable-step solvers, see te_events() in teplant.h: its
+ * zero-crossing functions, and its time events as the hits of a variable
+ * sample time, so that the solver lands on them.
+ *
+ * Each block keeps all of its plant state, the common blocks included, in
+ * its DWork (TEBlock, as raw bytes), so blocks do not share a plant, and
+ * the block declares the default SimState: Simulink saves and restores the
+ * state of the plant with the continuous states, for operating points and
+ * Fast Restart. The telemetry ring and the trace buffer are in PWork, not
+ * saved.
+ */
+
+/* Configurations */
+#define TE_IDV_PARAM   1
+#define TE_IDV_INPUT   2
+#define TE_SEED_FIXED  1
+#define TE_SEED_PARAM  2
+
+#ifndef TE_IDV_SOURCE
+#define TE_IDV_SOURCE  TE_IDV_PARAM
+#endif
+#ifndef TE_SEED_SOURCE
+#define TE_SEED_SOURCE TE_SEED_FIXED
+#endif
+
+#if TE_IDV_SOURCE == TE_IDV_PARAM
+#define TE_PAR_SEED  2    /* parameter 2 is IDV */
+#define TE_NU_IN     12
+#elif TE_IDV_SOURCE == TE_IDV_INPUT
+#define TE_PAR_SEED  1
+#define TE_NU_IN     (12 + TE_NIDV)
+#else
+#error "TE_IDV_SOURCE must be TE_IDV_PARAM or TE_IDV_INPUT"
+#endif
+#if TE_SEED_SOURCE == TE_SEED_PARAM
+#define TE_PAR_RING  (TE_PAR_SEED + 1)
+#elif TE_SEED_SOURCE == TE_SEED_FIXED
+#define TE_PAR_RING  TE_PAR_SEED
+#else
+#error "TE_SEED_SOURCE must be TE_SEED_FIXED or TE_SEED_PARAM"
+#endif
+#ifdef TE_TELEMETRY
+#define TE_NPAR  (TE_PAR_RING + 1)
+#else
+#define TE_NPAR  TE_PAR_RING
+#endif
+
+/* PWork of the block, resources outside the plant state */
+#define TE_PW_TELEM   0   /* TLWriter */
+#define TE_PW_TRACE   1   /* TTRBuffer */
+#define TE_NPWORK     2
+
+/* Headers that need the C library before tecore.c defines abs. */
+#include <ctype.h>
+#include <stdlib.h>
+#include <time.h>
+#include "simstruc.h"
+#ifdef TE_TELEMETRY
+#include "tetelem.h"
+#endif
+#ifndef TE_TRACE
+#undef TE_TRACE_LEVEL
+#define TE_TRACE_LEVEL 0  /* no trace points, no tetrace.c */
+#endif
+
+#include "tecore.c"
+
+const int NX = 50;
+const int NU = 12;
+const int NY = 41;
+const int NY2 = 12;  /* second output port, with -DTE_OPCOST */
+const int NPAR = TE_NPAR;
+#if TE_SEED_SOURCE == TE_SEED_PARAM
+const doublereal SEED_MAX = 9999999999.;
+const doublereal SEED_MIN = 1000000000.;
+#endif
+
+/* Block state, DWork 0 of the block (SS_UINT8) */
+typedef struct {
+	TEPlant te;             /* common blocks */
+#if TE_IDV_SOURCE == TE_IDV_INPUT
+	real_T idvin[TE_NIDV];  /* IDV inputs in te.dvec, see getcurr */
+#endif
+	integer code_sd;
+} TEBlock;
+
+#define teblock(S)      ((TEBlock *) ssGetDWork(S, 0))
+
+static char msg[256];  /* For error messages*/
+#define tetrace(S)      ((TTRBuffer *) ssGetPWorkValue(S, TE_PW_TRACE))
+
+static void setidv(TEBlock *b, SimStruct *S);
+static doublereal getcurr(TEBlock *b, SimStruct *S);
+#if TE_IDV_SOURCE == TE_IDV_INPUT
+static void getidv(TEBlock *b, SimStruct *S);
+#endif
+static void teeval(TEBlock *b, SimStruct *S, doublereal *rt, doublereal *yp);
+#ifdef TE_TRACE
+static void tracefile(SimStruct *S, char *name, size_t size);
+#endif
+
+/*====================================================================*
+ * Parameter handling methods. These methods are not supported by RTW *
+ *====================================================================*/
+
+#define MDL_CHECK_PARAMETERS   /* Change to #undef to remove function */
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+
+static void mdlCheckParameters(SimStruct *S)
+  {
+	/* Declarations*/
+	int_T Plen[3];         /* Expected lengths*/
+	int_T i, nEls;
+
+	/* Start*/
+	Plen[0] = NX;
+#if TE_IDV_SOURCE == TE_IDV_PARAM
+	Plen[1] = TE_NIDV;
+#endif
+#if TE_SEED_SOURCE == TE_SEED_PARAM
+	Plen[TE_PAR_SEED] = 1;
+#endif
+	for (i=0; i<NPAR; i++) {
+		if (mxIsEmpty(ssGetSFcnParam(S,i)))
+			continue;
+#ifdef TE_TELEMETRY
+		if (i == TE_PAR_RING) {
+			if (!mxIsChar(ssGetSFcnParam(S,i))) {
+				sprintf(msg,"Error in parameter %i:  %s",i+1,
+					"Parameter must be the name of the telemetry ring.");
+				ssSetErrorStatus(S,msg);
+				return;
+			}
+			continue;
+		}
+#endif
+		if (mxIsSparse(ssGetSFcnParam(S,i)) ||
+			mxIsComplex(ssGetSFcnParam(S,i)) ||
+			!mxIsNumeric(ssGetSFcnParam(S,i))) {
+			sprintf(msg,"Error in parameter %i:  %s",i+1,
+				"Parameter must be a real, non-sparse vector.");
+			ssSetErrorStatus(S,msg);
+			return;
+		}
+		nEls = mxGetNumberOfElements(ssGetSFcnParam(S,i));
+		if (nEls != Plen[i]) {
+			sprintf(msg,"Error in parameter %i:  Length = %i"
+				".  Expecting length = %i", i+1, nEls, Plen[i]);
+			ssSetErrorStatus(S,msg);
+			return;
+		}
+	}
+  }
+#endif /* MDL_CHECK_PARAMETERS */
+
+
+#if TE_IDV_SOURCE == TE_IDV_PARAM
+#define MDL_PROCESS_PARAMETERS  /* Refreshes the cached IDV */
+#else
+#undef MDL_PROCESS_PARAMETERS  /* Change to #undef to remove function */
+#endif
+#if defined(MDL_PROCESS_PARAMETERS) && defined(MATLAB_MEX_FILE)
+  /* Function: mdlProcessParameters ===========================================
+   * Abstract:
+   *    Called after the tunable parameters changed during the simulation.
+   *    The IDV parameter is only read here and in mdlInitializeConditions.
+   */
+static void mdlProcessParameters(SimStruct *S)
+  {
+	setidv(teblock(S), S);
+  }
+#endif /* MDL_PROCESS_PARAMETERS */
+
+
+/*=====================================*
+ * Configuration and execution methods *
+ *=====================================*/
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *    The sizes information is used by Simulink to determine the S-function
+ *    block's characteristics (number of inputs, outputs, states, etc.).
+ *
+ *    The direct feedthrough flag can be either 1=yes or 0=no. It should be
+ *    set to 1 if the input, "u", is used in the mdlOutput function. Setting
+ *    this to 0 is akin to making a promise that "u" will not be used in the
+ *    mdlOutput function. If you break the promise, then unpredictable results
+ *    will occur.
+ *
+ *    The NumContStates, NumDiscStates, NumInputs, NumOutputs, NumRWork,
+ *    NumIWork, NumPWork NumModes, and NumNonsampledZCs widths can be set to:
+ *       DYNAMICALLY_SIZED    - In this case, they will be set to the actual
+ *                              input width, unless you are have a
+ *                              mdlSetWorkWidths to set the widths.
+ *       0 or positive number - This explicitly sets item to the specified
+ *                              value.
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    ssSetNumSFcnParams(S, NPAR);  /* Number of expected parameters */
+    if (ssGetNumSFcnParams(S) == ssGetSFcnParamsCount(S)) {
+		mdlCheckParameters(S);
+		if (ssGetErrorStatus(S) != NULL) return;
+	}
+	else {
+			return;     /*Simulink will report a parameter mismatch error */
+	}
+
+    ssSetNumContStates(    S, NX);   /* number of continuous states           */
+    ssSetNumDiscStates(    S, 0);   /* number of discrete states             */
+
+
+    /*
+     * Configure the input ports. First set the number of input ports,
+     * then set for each input port index starting at 0, the width
+     * and whether or not the port has direct feedthrough (1=yes, 0=no).
+     * The width of a port can be DYNAMICALLY_SIZED or greater than zero.
+     * A port has direct feedthrough if the input is used in either
+     * the mdlOutputs or mdlGetTimeOfNextVarHit functions.
+     */
+    if (!ssSetNumInputPorts(S, 1)) return;
+    ssSetInputPortWidth(S, 0, TE_NU_IN);
+    ssSetInputPortRequiredContiguous(S, 0, 1);  /* read in place, see getcurr */
+    /* mdlOutputs does not read xmv, which only enters the valve
+     * derivatives, but the IDV inputs of temexd and temexr change the
+     * outputs of the same step, see getidv. temex has no direct
+     * feedthrough.*/
+#if TE_IDV_SOURCE == TE_IDV_INPUT
+    ssSetInputPortDirectFeedThrough(S, 0, 1);
+#else
+    ssSetInputPortDirectFeedThrough(S, 0, 0);
+#endif
+
+    /*
+     * Configure the output ports. First set the number of output ports,
+     * then set for each output port index starting at 0, the width
+     * of the output port which can be DYNAMICALLY_SIZE or greater than zero.
+     */
+#ifdef TE_OPCOST
+    if (!ssSetNumOutputPorts(S, 2 + TE_STATS_PORTS)) return;
+    ssSetOutputPortWidth(S, 1, NY2);
+#else
+    if (!ssSetNumOutputPorts(S, 1 + TE_STATS_PORTS)) return;
+#endif
+    ssSetOutputPortWidth(S, 0, NY);
+#ifdef TE_STATS
+    ssSetOutputPortWidth(S, ssGetNumOutputPorts(S) - 1, TE_STATS_WIDTH);
+#endif
+
+    /*
+     * Set the number of sample times. This must be a positive, nonzero
+     * integer indicating the number of sample times or it can be
+     * PORT_BASED_SAMPLE_TIMES.*/
+#ifdef TE_EVENTS
+    ssSetNumSampleTimes(   S, 2);   /* continuous, time events               */
+#else
+    ssSetNumSampleTimes(   S, 1);   /* number of sample times                */
+#endif
+
+    /*
+     * Set size of the work vectors.
+     */
+    ssSetNumRWork(         S, 0);   /* number of real work vector elements   */
+    ssSetNumIWork(         S, 0);   /* number of integer work vector elements*/
+    ssSetNumPWork(         S, TE_NPWORK);  /* telemetry ring, trace buffer  */
+    ssSetNumModes(         S, 0);   /* number of mode work vector elements   */
+    ssSetNumDWork(         S, 1);   /* the block state, TEBlock              */
+    ssSetDWorkWidth(       S, 0, (int_T) sizeof(TEBlock));
+    ssSetDWorkDataType(    S, 0, SS_UINT8);  /* raw bytes, not doubles       */
+    ssSetDWorkName(        S, 0, "plant");
+#ifdef TE_EVENTS
+    ssSetNumNonsampledZCs( S, TE_NZC);  /* see te_events in teplant.h       */
+#else
+    ssSetNumNonsampledZCs( S, 0);   /* number of nonsampled zero crossings   */
+#endif
+
+	/* Set any S-function options which must be OR'd together.*/
+    ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE);   /* general options (SS_OPTION_xx)        */
+
+	/* All state is in the continuous states and DWork.*/
+	ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
+
+	/* Declare parameter 1 to be unchanging during a simulation.*/
+	ssSetSFcnParamNotTunable(S, 0);
+#ifdef TE_TELEMETRY
+	ssSetSFcnParamNotTunable(S, TE_PAR_RING);
+#endif
+
+} /* end mdlInitializeSizes */
+
+
+
+
+
+#undef MDL_SET_WORK_WIDTHS   /* Change to #undef to remove function */
+#if defined(MDL_SET_WORK_WIDTHS) && defined(MATLAB_MEX_FILE)
+  static void mdlSetWorkWidths(SimStruct *S)
+  {
+  }
+#endif /* MDL_SET_WORK_WIDTHS */
+
+
+
+#define MDL_INITIALIZE_CONDITIONS   /* Change to #undef to remove function */
+#if defined(MDL_INITIALIZE_CONDITIONS)
+  /* Function: mdlInitializeConditions ========================================
+   * Abstract:
+   *    In this function, you should initialize the continuous and discrete
+   *    states for your S-function block.  The initial states are placed
+   *    in the state vector, ssGetContStates(S) or ssGetDiscStates(S).
+   *    You can also perform any other initialization activities that your
+   *    S-function may require. Note, this routine will be called at the
+   *    start of simulation and if it is present in an enabled subsystem
+   *    configured to reset states, it will be call when the enabled subsystem
+   *    restarts execution to reset the states.
+   *
+   *    You can use the ssIsFirstInitCond(S) macro to determine if this is
+   *    is the first time mdlInitializeConditions is being called.
+   */
+static void mdlInitializeConditions(SimStruct *S)
+  {
+	  TEBlock *b = teblock(S);
+	  real_T *x0;      /* pointer to states*/
+      real_T *pr;
+	  int_T i, nx;
+	  real_T dxdt[50];
+	  real_T rt;
+
+	  x0 = ssGetContStates(S);
+	  nx = NX;
+	  rt = 0;
+	  if (ssIsFirstInitCond(S)) {
+		  memset(b, 0, sizeof(*b));  /* the counters included */
+#ifdef TE_TRACE
+		  b->te.trace = tetrace(S);
+#endif
+		  teinit(&b->te, &c__50, &rt, x0, dxdt);
+		  b->te.trace = NULL;  /* in PWork, see teeval */
+	  }
+	  /* If first parameter is non-empty, use it to initialize the state vector.
+	  // If empty, use default values.*/
+	  if (mxIsEmpty(ssGetSFcnParam(S,0))) {
+		x0[0] = (float)10.40491389;
+		x0[1] = (float)4.363996017;
+		x0[2] = (float)7.570059737;
+		x0[3] = (float).4230042431;
+		x0[4] = (float)24.15513437;
+		x0[5] = (float)2.942597645;
+		x0[6] = (float)154.3770655;
+		x0[7] = (float)159.186596;
+		x0[8] = (float)2.808522723;
+		x0[9] = (float)63.75581199;
+		x0[10] = (float)26.74026066;
+		x0[11] = (float)46.38532432;
+		x0[12] = (float).2464521543;
+		x0[13] = (float)15.20484404;
+		x0[14] = (float)1.852266172;
+		x0[15] = (float)52.44639459;
+		x0[16] = (float)41.20394008;
+		x0[17] = (float).569931776;
+		x0[18] = (float).4306056376;
+		x0[19] = .0079906200783;
+		x0[20] = (float).9056036089;
+		x0[21] = .016054258216;
+		x0[22] = (float).7509759687;
+		x0[23] = .088582855955;
+		x0[24] = (float)48.27726193;
+		x0[25] = (float)39.38459028;
+		x0[26] = (float).3755297257;
+		x0[27] = (float)107.7562698;
+		x0[28] = (float)29.77250546;
+		x0[29] = (float)88.32481135;
+		x0[30] = (float)23.03929507;
+		x0[31] = (float)62.85848794;
+		x0[32] = (float)5.546318688;
+		x0[33] = (float)11.92244772;
+		x0[34] = (float)5.555448243;
+		x0[35] = (float).9218489762;
+		x0[36] = (float)94.59927549;
+		x0[37] = (float)77.29698353;
+		x0[38] = (float)63.05263039;
+		x0[39] = (float)53.97970677;
+		x0[40] = (float)24.64355755;
+		x0[41] = (float)61.30192144;
+		x0[42] = (float)22.21;
+		x0[43] = (float)40.06374673;
+		x0[44] = (float)38.1003437;
+		x0[45] = (float)46.53415582;
+		x0[46] = (float)47.44573456;
+		x0[47] = (float)41.10581288;
+		x0[48] = (float)18.11349055;
+		x0[49] = (float)50.;
+	  } else {
+	    pr = mxGetPr(ssGetSFcnParam(S,0));		/* pointer to first parameter*/
+	    for (i=0; i<nx; i++) {
+			x0[i] = pr[i];
+		}
+	  }
+#if TE_SEED_SOURCE == TE_SEED_PARAM
+	  /* If empty, use default values.*/
+      if (mxIsEmpty(ssGetSFcnParam(S,TE_PAR_SEED))) {
+        srand ( time(NULL) );
+        b->te.randsd.g = ceil((double)rand() * (SEED_MAX - SEED_MIN) / (double)RAND_MAX + SEED_MIN);
+      } else {
+        b->te.randsd.g = *mxGetPr(ssGetSFcnParam(S,TE_PAR_SEED));
+      }
+#endif
+	  setidv(b, S);
+	  TTR(tetrace(S), TTR_INFO, TTR_INIT, ssGetT(S), (double) ssIsFirstInitCond(S), 0., 0.);
+	  b->te.dvec.idv[20] = (integer) 0;
+	  b->code_sd = (integer) 0;
+  }
+#endif /* MDL_INITIALIZE_CONDITIONS */
+
+
+
+#if defined(TE_TELEMETRY) || defined(TE_TRACE)
+#define MDL_START  /* Creates the telemetry ring and the trace buffer */
+#else
+#undef MDL_START  /* Change to #undef to remove function */
+#endif
+#if defined(MDL_START)
+static void mdlStart(SimStruct *S)
+  {
+#ifdef TE_TELEMETRY
+	{
+		const mxArray *p = ssGetSFcnParam(S, TE_PAR_RING);
+		char *name = mxIsEmpty(p) ? NULL : mxArrayToString(p);
+		TLWriter *telem;
+
+		ssSetPWorkValue(S, TE_PW_TELEM, NULL);
+		if (tl_create(name ? name : TE_TELEMETRY_NAME, 0, &telem) == TL_OK) {
+			ssSetPWorkValue(S, TE_PW_TELEM, telem);
+		} else {
+			sprintf(msg, "Cannot create the telemetry ring %.200s.",
+				name ? name : TE_TELEMETRY_NAME);
+			ssWarning(S, msg);
+		}
+		mxFree(name);
+	}
+#endif
+#ifdef TE_TRACE
+	{
+		const char *level = getenv("TE_TRACE_LEVEL");
+		int l = level ? ttr_level(level) : TTR_INFO;
+		TTRBuffer *trace;
+
+		ssSetPWorkValue(S, TE_PW_TRACE, NULL);
+		if (ttr_open(0, l >= 0 ? l : TTR_INFO, &trace) == TTR_OK)
+			ssSetPWorkValue(S, TE_PW_TRACE, trace);
+		else
+			ssWarning(S, "Cannot create the trace buffer.");
+		TTR(tetrace(S), TTR_INFO, TTR_START, ssGetT(S), 0., 0., 0.);
+	}
+#endif
+  }
+#endif /*  MDL_START */
+
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    This function is used to specify the sample time(s) for your
+ *    S-function. You must register the same number of sample times as
+ *    specified in ssSetNumSampleTimes.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
+    ssSetOffsetTime(S, 0, 0.0);
+#ifdef TE_EVENTS
+    ssSetSampleTime(S, 1, VARIABLE_SAMPLE_TIME);
+    ssSetOffsetTime(S, 1, 0.0);
+#endif
+
+}
+
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:
+ *    In this function, you compute the outputs of your S-function
+ *    block. Generally outputs are placed in the output vector(s),
+ *    ssGetOutputPortSignal.
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+	TEBlock *b = teblock(S);
+	real_T *y;
+	int i;
+	doublereal rt;
+
+#ifdef TE_EVENTS
+	/* The time events only set the hits, see mdlGetTimeOfNextVarHit*/
+	if (!ssIsContinuousTask(S, tid)) return;
+#endif
+	/* Get current time and IDV inputs; xmv is left to mdlDerivatives*/
+	rt = ssGetT(S);
+#if TE_IDV_SOURCE == TE_IDV_INPUT
+	getidv(b, S);
+#endif
+	/* Call TEFUNC on the states for the outputs only*/
+	teeval(b, S, &rt, NULL);
+	/* Transfer the outputs to Simulink*/
+	y = ssGetOutputPortRealSignal(S,0);
+	for (i=0; i<NY; i++) {
+		y[i] = b->te.pv.xmeas[i];
+	}
+#ifdef TE_OPCOST
+	y = ssGetOutputPortRealSignal(S,1);
+	for (i=0; i<10; i++) {
+		y[i] = b->te.opcost.xmeas[i];
+	}
+	/* The totals of the last major step, carried on to rt at its rates*/
+	y[10] = b->te.opcost.total;
+	y[11] = b->te.opcost.product;
+	if (rt > b->te.opcost.tlast) {
+		y[10] += (rt - b->te.opcost.tlast) * b->te.opcost.rate;
+		y[11] += (rt - b->te.opcost.tlast) * b->te.opcost.prate;
+	}
+#endif
+#ifdef TE_STATS
+	y = ssGetOutputPortRealSignal(S, ssGetNumOutputPorts(S) - 1);
+	y[0] = (real_T) b->te.stats.tefunc;
+	y[1] = (real_T) b->te.stats.newton;
+	y[2] = (real_T) b->te.stats.fallback;
+	y[3] = (real_T) b->te.stats.draws;
+	for (i=0; i<TE_NPHASE; i++) {
+		y[4 + i] = (real_T) b->te.stats.ticks[i];
+	}
+#endif
+	/* Shut down the simulation if ISD is non-zero.*/
+	if (b->te.dvec.idv[20] != (integer) 0 && rt > (doublereal) 0.1 ) {
+		b->code_sd = b->te.dvec.idv[20];
+		TTR(tetrace(S), TTR_ERROR, TTR_SHUTDOWN, rt, (double) b->code_sd, 0., 0.);
+		ssSetStopRequested(S,1);
+	}
+} /* end mdlOutputs */
+
+
+#if defined(TE_OPCOST) || defined(TE_TELEMETRY)
+#define MDL_UPDATE  /* Cost totals and telemetry, once per major step */
+#else
+#undef MDL_UPDATE  /* Change to #undef to remove function */
+#endif
+#if defined(MDL_UPDATE)
+  /* Function: mdlUpdate ======================================================
+   * Abstract:
+   *    This function is called once for every major integration time step.
+   *    Discrete states are typically updated here, but this function is useful
+   *    for performing any tasks that should only take place once per
+   *    integration step.
+   */
+static void mdlUpdate(SimStruct *S, int_T tid)
+  {
+	/* The plant still holds the outputs of this step's mdlOutputs.*/
+	TEPlant *te = &teblock(S)->te;
+#ifdef TE_TELEMETRY
+	TLWriter *telem = (TLWriter *) ssGetPWorkValue(S, TE_PW_TELEM);
+#endif
+
+#ifdef TE_EVENTS
+	if (!ssIsContinuousTask(S, tid)) return;
+#endif
+
+#ifdef TE_OPCOST
+	teopcost(te, ssGetT(S), ssGetInputPortRealSignal(S,0));
+#endif
+#ifdef TE_TELEMETRY
+	if (telem)
+		tl_publish(telem, ssGetT(S), te->pv.xmeas,
+			ssGetInputPortRealSignal(S,0), te->dvec.idv[20]);
+#endif
+  }
+#endif /* MDL_UPDATE */
+
+
+
+#define MDL_DERIVATIVES  /* Change to #undef to remove function */
+#if defined(MDL_DERIVATIVES)
+  /* Function: mdlDerivatives =================================================
+   * Abstract:
+   *    In this function, you compute the S-function block's derivatives.
+   *    The derivatives are placed in the derivative vector, ssGetdX(S).
+   */
+static void mdlDerivatives(SimStruct *S)
+  {
+	TEBlock *b = teblock(S);
+	doublereal rt;
+
+	rt = getcurr(b, S);
+	/* Call TEFUNC to update dx*/
+	teeval(b, S, &rt, ssGetdX(S));
+  }
+#endif /* MDL_DERIVATIVES */
+
+
+
+#ifdef TE_EVENTS
+#define MDL_ZERO_CROSSINGS  /* Flow cutoffs */
+#else
+#undef MDL_ZERO_CROSSINGS  /* Change to #undef to remove function */
+#endif
+#if defined(MDL_ZERO_CROSSINGS)
+  /* Function: mdlZeroCrossings ===============================================
+   * Abstract:
+   *    Updates the zero-crossing functions, ssGetNonsampledZCs(S), from the
+   *    evaluation of the plant that mdlOutputs made at the same time. They
+   *    are functions of the states only; the plant is not changed.
+   */
+static void mdlZeroCrossings(SimStruct *S)
+  {
+	tezc(&teblock(S)->te, ssGetNonsampledZCs(S));
+  }
+#endif /* MDL_ZERO_CROSSINGS */
+
+
+
+#ifdef TE_EVENTS
+#define MDL_GET_TIME_OF_NEXT_VAR_HIT  /* Analyzer samples and walk knots */
+#else
+#undef MDL_GET_TIME_OF_NEXT_VAR_HIT  /* Change to #undef to remove function */
+#endif
+#if defined(MDL_GET_TIME_OF_NEXT_VAR_HIT)
+  /* Function: mdlGetTimeOfNextVarHit =========================================
+   * Abstract:
+   *    Sets the next hit of the variable sample time to the next time event
+   *    of the plant. The continuous task evaluates the outputs at every
+   *    major step, hits included, which advances the event, so the next hit
+   *    lies ahead; in case it does not, the hit is skipped. The task of the
+   *    hits computes nothing else.
+   */
+static void mdlGetTimeOfNextVarHit(SimStruct *S)
+  {
+	time_T t = ssGetT(S);
+	time_T tnext = tezc(&teblock(S)->te, NULL);
+
+	ssSetTNext(S, tnext > t ? tnext : t + TE_TS_BASE);
+  }
+#endif /* MDL_GET_TIME_OF_NEXT_VAR_HIT */
+
+
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    In this function, you should perform any actions that are necessary
+ *    at the termination of a simulation.  For example, if memory was allocated
+ *    in mdlStart, this is the place to free it.
+ *
+ *    Suppose your S-function allocates a few few chunks of memory in mdlStart
+ *    and saves them in PWork. The following code fragment would free this
+ *    memory.
+ *        {
+ *            int i;
+ *            for (i = 0; i<ssGetNumPWork(S); i++) {
+ *                if (ssGetPWorkValue(S,i) != NULL) {
+ *                    free(ssGetPWorkValue(S,i));
+ *                }
+ *            }
+ *        }
+ */
+static void mdlTerminate(SimStruct *S)
+{
+		TEBlock *b = teblock(S);
+
+		if (b && b->code_sd != (integer) 0 ) {
+			mexWarnMsgTxt(b->te.msg);
+		}
+#ifdef TE_TELEMETRY
+		tl_destroy((TLWriter *) ssGetPWorkValue(S, TE_PW_TELEM));
+		ssSetPWorkValue(S, TE_PW_TELEM, NULL);
+#endif
+#ifdef TE_TRACE
+		if (tetrace(S)) {
+			char name[256];
+
+			tracefile(S, name, sizeof(name));
+			if (ttr_save(tetrace(S), name) != TTR_OK) {
+				sprintf(msg, "Cannot write the trace file %.200s.", name);
+				ssWarning(S, msg);
+			}
+			ttr_close(tetrace(S));
+			ssSetPWorkValue(S, TE_PW_TRACE, NULL);
+		}
+#endif
+}
+
+/* GETCURR moves the current U values from the contiguous input port into */
+/* common and returns the time. tefunc reads the states in place. An IDV */
+/* parameter is cached by setidv. Not called by mdlOutputs, which reads */
+/* no xmv.*/
+
+static doublereal getcurr(TEBlock *b, SimStruct *S)
+{
+	memcpy(b->te.pv.xmv, ssGetInputPortRealSignal(S,0), sizeof(b->te.pv.xmv));
+#if TE_IDV_SOURCE == TE_IDV_INPUT
+	getidv(b, S);
+#endif
+	return ssGetT(S);
+}
+/* end GETCURR*/
+
+#if TE_IDV_SOURCE == TE_IDV_INPUT
+/* GETIDV moves the IDV inputs into the common block when they change. */
+/* Called by mdlOutputs as well, so that the outputs see them at once.*/
+
+static void getidv(TEBlock *b, SimStruct *S)
+{
+	if (memcmp(b->idvin, ssGetInputPortRealSignal(S,0) + NU, sizeof(b->idvin)) != 0)
+		setidv(b, S);
+}
+/* end GETIDV*/
+#endif
+
+/* TEEVAL calls TEFUNC on the states with the trace buffer of the block. */
+/* The buffer is in PWork; its address is cleared again, so that the */
+/* DWork that SimState saves holds no pointer.*/
+
+static void teeval(TEBlock *b, SimStruct *S, doublereal *rt, doublereal *yp)
+{
+#ifdef TE_TRACE
+	b->te.trace = tetrace(S);
+#endif
+	tefunc(&b->te, &c__50, rt, ssGetContStates(S), yp);
+	b->te.trace = NULL;
+}
+/* end TEEVAL*/
+
+/* SETIDV moves current IDV parameters or inputs into the common block.*/
+
+static void setidv(TEBlock *b, SimStruct *S)
+{
+	int i;
+#if TE_IDV_SOURCE == TE_IDV_PARAM
+	real_T *pr;
+
+	if (mxIsEmpty(ssGetSFcnParam(S,1))) {
+		for (i=0; i<TE_NIDV; i++) {
+			b->te.dvec.idv[i] = (integer) 0;
+		}
+		teidv(&b->te);
+		return;
+	}
+	pr = mxGetPr(ssGetSFcnParam(S,1));		/* pointer to IDV in Simulink*/
+	for (i=0; i<TE_NIDV; i++) {
+		b->te.dvec.idv[i] = (integer) pr[i];
+	}
+#else
+	memcpy(b->idvin, ssGetInputPortRealSignal(S,0) + NU, sizeof(b->idvin));
+	for (i=0; i<TE_NIDV; i++) {
+		b->te.dvec.idv[i] = (integer) b->idvin[i];
+	}
+#endif
+	teidv(&b->te);
+}
+/* end SETIDV*/
+
+#ifdef TE_TRACE
+/* TRACEFILE names the trace file of the block: its path in the model, */
+/* e.g. MultiLoop_mode1_TE_Plant.trace for MultiLoop_mode1/TE Plant, */
+/* with '_' for the characters other than letters and digits.*/
+
+static void tracefile(SimStruct *S, char *name, size_t size)
+{
+	const char *path = ssGetPath(S);
+	size_t i;
+
+	for (i = 0; path[i] != '\0' && i + sizeof(".trace") < size; i++) {
+		name[i] = isalnum((unsigned char) path[i]) ? path[i] : '_';
+	}
+	strcpy(name + i, ".trace");
+}
+/* end TRACEFILE*/
+#endif
+
+
+/*=============================*
+ * Required S-function trailer *
+ *=============================*/
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
@@ -0,0 +1,195 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Headless fixed-step run of the TE plant, see tesim.h. */
+
+#include <math.h>
+#include <string.h>
+#include "tesim.h"
+
+/* Adds the time since the last lap to the part of tm. */
+#define LAP(part) do { \
+		if (tm) { \
+			now = tert_clock(); \
+			tm->part += now - last; \
+			last = now; \
+		} \
+	} while (0)
+
+/* Integration steps per sample and in the run, rounded as Simulink does
+ * for fixed-step solvers. */
+static int tesim_steps(const TESimConfig *cfg, long *every, long *nsteps)
+{
+	double h = cfg->ts_base > 0. ? cfg->ts_base : TE_TS_BASE;
+	double ts = cfg->ts_save > 0. ? cfg->ts_save : TE_TS_SAVE;
+
+	if (!(cfg->tstop >= 0.))
+		return TESIM_EARG;
+	*every = (long) floor(ts / h + .5);
+	*nsteps = (long) floor(cfg->tstop / h + 1e-9);
+	return *every >= 1 ? TESIM_OK : TESIM_EARG;
+}
+
+size_t tesim_samples(const TESimConfig *cfg)
+{
+	long every, nsteps;
+
+	if (tesim_steps(cfg, &every, &nsteps) != TESIM_OK)
+		return 0;
+	return (size_t) (nsteps / every) + 1;
+}
+
+/* Runs cfg; if snap is not NULL, stops at the start of step ksnap and
+ * saves the plant there. */
+static int run(const TESimConfig *cfg, const TESink *sink, TESimResult *res,
+		TESimSnapshot *snap, long ksnap)
+{
+	TEPlant te;
+	TMLController ctl;
+	TESimTiming *tm = cfg->timing;
+	double h = cfg->ts_base > 0. ? cfg->ts_base : TE_TS_BASE;
+	double u[TE_NU], y[TE_NY], holdu[TE_NU], holdy[TE_NY];
+	double t, now, last = 0.;
+	const double *xmeas;
+	long k, k0 = 0, kidv, every, nsteps;
+	int hit, status;
+
+	memset(res, 0, sizeof(*res));
+	if (tm)
+		memset(tm, 0, sizeof(*tm));
+	if (tesim_steps(cfg, &every, &nsteps) != TESIM_OK)
+		return TESIM_EARG;
+	if (cfg->control && tml_init(&ctl, cfg->control, h) != TML_OK)
+		return TESIM_EARG;
+	te_init(&te, cfg->x0 ? cfg->x0 : cfg->control && cfg->control->nx0 == TE_NX ?
+			cfg->control->x0 : NULL);
+	te_seed(&te, cfg->seed != 0. ? cfg->seed : TE_SEED);
+	kidv = (long) floor(cfg->tidv / h + .5);
+	te_setidv(&te, kidv > 0 ? NULL : cfg->idv);
+	memcpy(u, cfg->xmv ? cfg->xmv : &te.x[38], sizeof(u));
+	memset(holdu, 0, sizeof(holdu));
+	memset(holdy, 0, sizeof(holdy));
+	if (cfg->resume) {
+		te = cfg->resume->te;
+		ctl = cfg->resume->ctl;
+		memcpy(holdu, cfg->resume->holdu, sizeof(holdu));
+		memcpy(holdy, cfg->resume->holdy, sizeof(holdy));
+		k0 = (long) floor(te.t / h + .5);
+		if (k0 > nsteps)
+			return TESIM_EARG;
+	}
+	te.trace = cfg->trace;
+	TTR(cfg->trace, TTR_INFO, TTR_RUN, k0 * h, te.randsd.g, cfg->tstop,
+			(double) cfg->fused);
+	if (cfg->control)
+		tml_xmv(&ctl, u);
+	te_setxmv(&te, u);
+	xmeas = te.pv.xmeas;
+	if (tm)
+		last = tert_clock();
+
+	for (k = k0; ; k++) {
+		if (k == ksnap && snap) {
+			snap->te = te;
+			if (cfg->control)
+				snap->ctl = ctl;
+			memcpy(snap->holdu, holdu, sizeof(holdu));
+			memcpy(snap->holdy, holdy, sizeof(holdy));
+			return TESIM_OK;
+		}
+		if (k == kidv && k > 0) {
+			te_setidv(&te, cfg->idv);
+			TTR(cfg->trace, TTR_INFO, TTR_IDV, k * h, (double) k, 0., 0.);
+		}
+		if (cfg->realtime)
+			tert_step(cfg->realtime, k);
+		LAP(pacing);
+		/* Time from the step count, so that samples fall on exact
+		 * multiples of the step. */
+		t = te.t = k * h;
+		/* The controller's xmv are held in the plant between its
+		 * samples. */
+		hit = cfg->control && k % ctl.period == 0;
+		if (hit && k > k0) {
+			tml_xmv(&ctl, u);
+			if (!cfg->attack)
+				te_setxmv(&te, u);
+			LAP(control);
+		}
+		if (cfg->attack) {
+			te_setxmv(&te, u);
+			ta_apply(cfg->attack, TA_XMV, t, te.pv.xmv, holdu);
+			LAP(attack);
+		}
+		res->isd = cfg->fused && k < nsteps ? te_advance(&te, h) : te_outputs(&te);
+		LAP(plant);
+		if (cfg->attack) {
+			/* The plant keeps its own xmeas (the analyzers hold
+			 * theirs between samples), so attacked measurements go
+			 * to a copy. */
+			memcpy(y, te.pv.xmeas, sizeof(y));
+			ta_apply(cfg->attack, TA_XMEAS, t, y, holdy);
+			xmeas = y;
+			LAP(attack);
+		}
+		res->t = t;
+		if (hit) {
+			TTR(cfg->trace, TTR_DEBUG, TTR_CONTROL, t, (double) k, 0., 0.);
+			tml_update(&ctl, xmeas);
+			LAP(control);
+		}
+		if (cfg->telemetry)
+			tl_publish(cfg->telemetry, t, xmeas, te.pv.xmv, te.dvec.idv[20]);
+		if (k % every == 0 && cfg->opcost)
+			cfg->opcost[k / every] = te_hourlycost(te.pv.xmeas, te.pv.xmv);
+		if (k % every == 0 && cfg->monitor &&
+				(status = cfg->monitor->sample(cfg->monitor->ctx, t, xmeas,
+					te.pv.xmv)) != 0)
+			return status;
+		if (k % every == 0 && sink && sink->sample) {
+			status = sink->sample(sink->ctx, t, xmeas, te.pv.xmv);
+			res->nsamples++;
+			if (status != 0)
+				return status;
+		}
+		LAP(io);
+		if (tm)
+			tm->steps++;
+		if (res->isd != 0) {
+			strcpy(res->msg, te.msg);
+			TTR(cfg->trace, TTR_ERROR, TTR_SHUTDOWN, t, (double) res->isd, 0., 0.);
+			break;
+		}
+		if (k == nsteps)
+			break;
+		if (!cfg->fused) {
+			te_step(&te, h);
+			LAP(plant);
+		}
+	}
+	TTR(cfg->trace, TTR_INFO, TTR_END, res->t, (double) res->isd,
+			(double) res->nsamples, 0.);
+	return TESIM_OK;
+}
+
+int tesim_run(const TESimConfig *cfg, const TESink *sink, TESimResult *res)
+{
+	return run(cfg, sink, res, NULL, -1);
+}
+
+int tesim_snapshot(const TESimConfig *cfg, double t, TESimSnapshot *snap,
+		TESimResult *res)
+{
+	double h = cfg->ts_base > 0. ? cfg->ts_base : TE_TS_BASE;
+	long every, nsteps, k = (long) floor(t / h + 1e-9);
+
+	if (tesim_steps(cfg, &every, &nsteps) != TESIM_OK || k < 0 || k > nsteps)
+		return TESIM_EARG;
+	return run(cfg, NULL, res, snap, k);
+}
@@ -0,0 +1,136 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Headless fixed-step run of the TE plant (teplant.h).
+ *
+ * Integrates the plant as TEModel.mdl does (Euler, step Ts_base) from t = 0
+ * to tstop and hands every Ts_save hours the time, xmeas and xmv to a sink,
+ * the rows that the model logs as tout, simout and xmv. The run ends early
+ * on a plant shutdown or when the sink asks for it.
+ *
+ * With an attack table (teattack.h) the xmv attacks act on the plant input
+ * and the sink and telemetry get the attacked xmeas, as the xmeas and xmv
+ * attack blocks of the model would pass them on.
+ *
+ * With a controller (temloop.h) the run is closed loop: the controller
+ * sets xmv every step from the xmeas handed on (attacked, if so), as the
+ * MultiLoop models wire it, and the plant starts from the controller's
+ * plant states unless x0 is given.
+ *
+ * The controller samples every ctl.period steps and its xmv are held in
+ * the plant in between (zero-order hold). By default a step evaluates the
+ * plant twice as the model does, once for the outputs and once for the
+ * derivatives; a fused run evaluates it once per step (te_advance), about
+ * twice as fast, with the noise sequence no longer the model's. The time a
+ * run spends in each part of the loop can be measured on the pacing clock.
+ * A trace buffer (tetrace.h) gets the start and end of the run, the
+ * disturbance switch, the controller samples, a shutdown and the plant's
+ * own trace points.
+ *
+ * A run can be resumed from a snapshot of the plant taken by
+ * tesim_snapshot(), so that runs sharing a common start (e.g. the time
+ * before an attack) simulate it only once.
+ */
+
+#ifndef __TESIM_H__
+#define __TESIM_H__
+
+#include <stddef.h>
+#include "teattack.h"
+#include "temloop.h"
+#include "teplant.h"
+#include "terealtime.h"
+#include "tetelem.h"
+#include "tetrace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Status codes */
+#define TESIM_OK     0
+#define TESIM_EARG  -1
+
+/* A run stopped at the start of a step: the plant, the controller and,
+ * per channel, the last output of the attack blocks (the DOS memory). */
+typedef struct {
+	TEPlant te;
+	TMLController ctl;
+	double holdu[TE_NU], holdy[TE_NY];
+} TESimSnapshot;
+
+/* Called once per sample. A non-zero return ends the run and is returned
+ * by tesim_run(). */
+typedef struct {
+	int (*sample)(void *ctx, double t, const double *xmeas, const double *xmv);
+	void *ctx;
+} TESink;
+
+/* Seconds spent in each part of a run, from its start. */
+typedef struct {
+	double plant;          /* plant evaluation and integration */
+	double control;        /* controller samples */
+	double attack;         /* attack injection */
+	double io;             /* telemetry, opcost, monitor and sink */
+	double pacing;         /* waiting for the wall clock, snapshot checks */
+	long steps;
+} TESimTiming;
+
+typedef struct {
+	double tstop;          /* hours */
+	double ts_base;        /* integration step, 0 for TE_TS_BASE */
+	double ts_save;        /* sampling period, 0 for TE_TS_SAVE */
+	const double *x0;      /* TE_NX initial states, NULL for the defaults */
+	const double *xmv;     /* TE_NU constant xmv, NULL for the initial valves */
+	const TMLConfig *control;  /* closed loop: controller setting xmv, or
+	                          NULL for the constant xmv */
+	const double *idv;     /* TE_NIDV disturbance codes, NULL for none */
+	double tidv;           /* hours at which idv switches on, 0 for t = 0 */
+	double seed;           /* noise seed, 0 for TE_SEED */
+	const TEAttackTable *attack;  /* attacks to inject, or NULL */
+	TLWriter *telemetry;   /* ring every step is published to, or NULL */
+	TERealtime *realtime;  /* paces the steps against the wall clock, or NULL */
+	double *opcost;        /* tesim_samples() values: $/h at every sample, as
+	                          OpCost, from the plant's own xmeas, or NULL */
+	const TESimSnapshot *resume;  /* snapshot to start from, or NULL for t = 0 */
+	const TESink *monitor; /* detector fed every sample in the simulation
+	                          thread, before the sink, or NULL */
+	int fused;             /* one plant evaluation per step, see above */
+	TESimTiming *timing;   /* filled with the time per part, or NULL */
+	TTRBuffer *trace;      /* buffer the run and the plant trace to, or NULL */
+} TESimConfig;
+
+typedef struct {
+	double t;              /* time reached, hours */
+	long isd;              /* shutdown code, 0 if the plant kept running */
+	size_t nsamples;       /* rows handed to the sink */
+	char msg[256];         /* shutdown message */
+} TESimResult;
+
+/* Rows a run of cfg produces at most. */
+size_t tesim_samples(const TESimConfig *cfg);
+
+/* Runs cfg. Returns TESIM_OK when the run completed or the plant shut
+ * down (see res->isd), the sink's value if it stopped the run, or
+ * TESIM_EARG, also for a controller tml_init() rejects. */
+int tesim_run(const TESimConfig *cfg, const TESink *sink, TESimResult *res);
+
+/* Runs cfg without sink up to the step at time t and saves the run as it
+ * enters that step to snap. A run with resume = snap then goes on exactly
+ * as the run from t = 0 would, provided the attacks agree before t; samples
+ * before t are neither passed to the sink nor to opcost. If the plant shuts
+ * down before t, res->isd says so and snap is not written. */
+int tesim_snapshot(const TESimConfig *cfg, double t, TESimSnapshot *snap,
+		TESimResult *res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TESIM_H__ */
@@ -0,0 +1,97 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Counters and timers on the hot path of the plant.
+ *
+ * Compiled in with -DTE_STATS, into teplant.c and the S-functions alike.
+ * The plant then counts its tefunc evaluations, the Newton iterations of
+ * tesub2_ (temperature from enthalpy), the calls in which they did not
+ * converge and the temperature fell back to its value on entry, and the
+ * draws of the noise generator tesub7_. Each part of tefunc is timed in
+ * time-stamp counter ticks (x86 only; the ticks stay 0 elsewhere):
+ *
+ *   TE_PH_WALKS    disturbance random walks
+ *   TE_PH_THERMO   compositions, temperatures, densities, pressures and
+ *                  stream enthalpies
+ *   TE_PH_FLOWS    valves, flows, reactions and heat transfer
+ *   TE_PH_MEASURE  xmeas with noise and analyzers, shutdown checks, opcost
+ *   TE_PH_DERIV    derivatives
+ *
+ * Without TE_STATS the macros compile to nothing and the counters stay 0.
+ * Native runs read them with te_stats() (teplant.h). The S-functions get
+ * one more output port after the others, TE_STATS_WIDTH wide: tefunc,
+ * newton, fallback, draws and the ticks of the five parts, since the
+ * start of the simulation.
+ */
+
+#ifndef __TESTATS_H__
+#define __TESTATS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Parts of tefunc */
+#define TE_PH_WALKS    0
+#define TE_PH_THERMO   1
+#define TE_PH_FLOWS    2
+#define TE_PH_MEASURE  3
+#define TE_PH_DERIV    4
+#define TE_NPHASE      5
+
+#define TE_STATS_WIDTH  (4 + TE_NPHASE)
+
+typedef struct {
+	unsigned long long tefunc;    /* evaluations */
+	unsigned long long newton;    /* tesub2_ iterations */
+	unsigned long long fallback;  /* tesub2_ calls without convergence */
+	unsigned long long draws;     /* tesub7_ draws */
+	unsigned long long ticks[TE_NPHASE];
+} TEStats;
+
+#ifdef TE_STATS
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define te_ticks()  ((unsigned long long) __rdtsc())
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#include <x86intrin.h>
+#define te_ticks()  ((unsigned long long) __rdtsc())
+#else
+#define te_ticks()  0ULL
+#endif
+
+#define TE_STATS_PORTS  1     /* output ports an S-function adds */
+
+/* Declares the tick counter of a function; goes with the declarations,
+ * without a semicolon. */
+#define TE_STATS_TIMER(tick)  unsigned long long tick = te_ticks();
+
+#define TE_STATS_COUNT(s, field)  ((s).field++)
+
+/* Adds the ticks since tick to part ph of s and restarts tick. */
+#define TE_STATS_LAP(s, ph, tick) do { \
+		unsigned long long now_ = te_ticks(); \
+		(s).ticks[ph] += now_ - (tick); \
+		(tick) = now_; \
+	} while (0)
+
+#else
+
+#define TE_STATS_PORTS  0
+#define TE_STATS_TIMER(tick)
+#define TE_STATS_COUNT(s, field)   ((void) 0)
+#define TE_STATS_LAP(s, ph, tick)  ((void) 0)
+
+#endif /* TE_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TESTATS_H__ */
@@ -0,0 +1,218 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* MEX gateway to the run store (runstore.c).
+ *
+ *   testore('write', file, tout, Y)         store Y (N x ncols) against tout
+ *   testore('write', file, tout, Y, rows)   same, with rows per block
+ *   [t, Y] = testore('read', file)          read everything
+ *   [t, Y] = testore('read', file, cols)    read value columns cols (1-based)
+ *   [t, Y] = testore('read', file, cols, [t0 t1])
+ *   [t, Ymin, Ymax, Ymean, level] = testore('summary', file, cols, [t0 t1], width)
+ *                                           min/max/mean envelope for a plot
+ *                                           width pixels wide
+ *   info = testore('info', file)
+ *
+ * TE runs are stored as [simout(:,1:41) xmv(:,1:12)], so columns 1..41 are
+ * xmeas and 42..53 are xmv. An empty cols means all columns.
+ *
+ * Build: mex testore.c runstore.c
+ */
+
+#include <string.h>
+#include "mex.h"
+#include "runstore.h"
+
+static char *getstring(const mxArray *a, const char *what)
+{
+	char *s;
+
+	if (!mxIsChar(a) || !(s = mxArrayToString(a)))
+		mexErrMsgIdAndTxt("testore:arg", "%s must be a string.", what);
+	return s;
+}
+
+static void check(int status, const char *file)
+{
+	if (status != RS_OK)
+		mexErrMsgIdAndTxt("testore:store", "%s: %s.", file, rs_strerror(status));
+}
+
+static void dowrite(int nrhs, const mxArray *prhs[], char *file)
+{
+	RunStoreWriter *w;
+	const double *t, *y;
+	double *row;
+	size_t n, i;
+	int c, ncols, rows = 0, status = RS_OK;
+
+	if (nrhs < 4)
+		mexErrMsgIdAndTxt("testore:arg", "Usage: testore('write', file, tout, Y).");
+	if (!mxIsDouble(prhs[2]) || !mxIsDouble(prhs[3]) ||
+			mxIsComplex(prhs[3]) || mxIsSparse(prhs[3]))
+		mexErrMsgIdAndTxt("testore:arg", "tout and Y must be real double arrays.");
+	n = mxGetNumberOfElements(prhs[2]);
+	if (mxGetM(prhs[3]) != n)
+		mexErrMsgIdAndTxt("testore:arg", "Y must have one row per element of tout.");
+	if (nrhs > 4)
+		rows = (int) mxGetScalar(prhs[4]);
+	ncols = (int) mxGetN(prhs[3]);
+	t = mxGetPr(prhs[2]);
+	y = mxGetPr(prhs[3]);
+	check(rs_create(file, ncols, rows, &w), file);
+	row = (double *) mxMalloc(ncols * sizeof(double));
+	for (i = 0; i < n && status == RS_OK; i++) {
+		for (c = 0; c < ncols; c++)
+			row[c] = y[c*n + i];
+		status = rs_append(w, t[i], row);
+	}
+	mxFree(row);
+	if (status != RS_OK) {
+		rs_close(w);
+		check(status, file);
+	}
+	check(rs_close(w), file);
+}
+
+/* Value columns from prhs[2] (all if absent or empty) and the window from
+ * prhs[3]. */
+static int *getcols(int nrhs, const mxArray *prhs[], RunStore *s, int *ncols,
+		double *t0, double *t1)
+{
+	RunStoreInfo info;
+	const double *pr;
+	int *cols;
+	int j;
+
+	rs_info(s, &info);
+	if (nrhs > 3) {
+		if (mxGetNumberOfElements(prhs[3]) != 2) {
+			rs_free(s);
+			mexErrMsgIdAndTxt("testore:arg", "Window must be [t0 t1].");
+		}
+		*t0 = mxGetPr(prhs[3])[0];
+		*t1 = mxGetPr(prhs[3])[1];
+	}
+	if (nrhs > 2 && !mxIsEmpty(prhs[2])) {
+		*ncols = (int) mxGetNumberOfElements(prhs[2]);
+		pr = mxGetPr(prhs[2]);
+		cols = (int *) mxMalloc(*ncols * sizeof(int));
+		for (j = 0; j < *ncols; j++)
+			cols[j] = (int) pr[j];
+	} else {
+		*ncols = info.ncols;
+		cols = (int *) mxMalloc(*ncols * sizeof(int));
+		for (j = 0; j < *ncols; j++)
+			cols[j] = j + 1;
+	}
+	return cols;
+}
+
+static void doread(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[],
+		char *file)
+{
+	RunStore *s;
+	double t0 = -mxGetInf(), t1 = mxGetInf();
+	int *cols;
+	int ncols;
+	size_t n;
+	long got;
+
+	check(rs_open(file, &s), file);
+	cols = getcols(nrhs, prhs, s, &ncols, &t0, &t1);
+	n = rs_count(s, t0, t1);
+	plhs[0] = mxCreateDoubleMatrix(n, 1, mxREAL);
+	plhs[1] = mxCreateDoubleMatrix(n, ncols, mxREAL);
+	got = rs_read(s, cols, ncols, t0, t1, mxGetPr(plhs[0]), mxGetPr(plhs[1]), n);
+	rs_free(s);
+	mxFree(cols);
+	if (got < 0)
+		check((int) got, file);
+	if (nlhs < 2)
+		mxDestroyArray(plhs[1]);
+}
+
+static void dosummary(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[],
+		char *file)
+{
+	RunStore *s;
+	mxArray *out[4];
+	double t0 = -mxGetInf(), t1 = mxGetInf();
+	int *cols;
+	int j, ncols, level, width;
+	size_t n;
+	long got;
+
+	if (nrhs < 5)
+		mexErrMsgIdAndTxt("testore:arg",
+				"Usage: testore('summary', file, cols, [t0 t1], width).");
+	width = (int) mxGetScalar(prhs[4]);
+	check(rs_open(file, &s), file);
+	cols = getcols(nrhs, prhs, s, &ncols, &t0, &t1);
+	level = rs_level(s, t0, t1, width);
+	n = rs_count_level(s, level, t0, t1);
+	out[0] = mxCreateDoubleMatrix(n, 1, mxREAL);
+	for (j = 1; j < 4; j++)
+		out[j] = mxCreateDoubleMatrix(n, ncols, mxREAL);
+	got = rs_read_summary(s, level, cols, ncols, t0, t1, mxGetPr(out[0]),
+			mxGetPr(out[1]), mxGetPr(out[2]), mxGetPr(out[3]), n);
+	rs_free(s);
+	mxFree(cols);
+	for (j = 0; j < 4; j++) {
+		if (j < nlhs || j == 0)
+			plhs[j] = out[j];
+		else
+			mxDestroyArray(out[j]);
+	}
+	if (got < 0)
+		check((int) got, file);
+	if (nlhs > 4)
+		plhs[4] = mxCreateDoubleScalar(level);
+}
+
+static void doinfo(mxArray *plhs[], char *file)
+{
+	static const char *fields[] = {"ncols", "nrows", "nblocks", "blockrows",
+		"levels", "tmin", "tmax"};
+	RunStore *s;
+	RunStoreInfo info;
+
+	check(rs_open(file, &s), file);
+	rs_info(s, &info);
+	rs_free(s);
+	plhs[0] = mxCreateStructMatrix(1, 1, 7, fields);
+	mxSetField(plhs[0], 0, "ncols", mxCreateDoubleScalar(info.ncols));
+	mxSetField(plhs[0], 0, "nrows", mxCreateDoubleScalar(info.nrows));
+	mxSetField(plhs[0], 0, "nblocks", mxCreateDoubleScalar((double) info.nblocks));
+	mxSetField(plhs[0], 0, "blockrows", mxCreateDoubleScalar(info.blockrows));
+	mxSetField(plhs[0], 0, "levels", mxCreateDoubleScalar(info.levels));
+	mxSetField(plhs[0], 0, "tmin", mxCreateDoubleScalar(info.tmin));
+	mxSetField(plhs[0], 0, "tmax", mxCreateDoubleScalar(info.tmax));
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	char *cmd, *file;
+
+	if (nrhs < 2)
+		mexErrMsgIdAndTxt("testore:arg", "Usage: testore(command, file, ...).");
+	cmd = getstring(prhs[0], "Command");
+	file = getstring(prhs[1], "File name");
+	if (strcmp(cmd, "write") == 0)
+		dowrite(nrhs, prhs, file);
+	else if (strcmp(cmd, "read") == 0)
+		doread(nlhs, plhs, nrhs, prhs, file);
+	else if (strcmp(cmd, "summary") == 0)
+		dosummary(nlhs, plhs, nrhs, prhs, file);
+	else if (strcmp(cmd, "info") == 0)
+		doinfo(plhs, file);
+	else
+		mexErrMsgIdAndTxt("testore:arg", "Unknown command '%s'.", cmd);
+	mxFree(cmd);
+	mxFree(file);
+}
@@ -0,0 +1,185 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Parallel sweep of attack parameters, see tesweep.h. */
+
+#include <stdlib.h>
+#include <string.h>
+#include "tesweep.h"
+#include "tethread.h"
+
+#define TSW_MAX_THREADS 256
+
+typedef struct {
+	const TSConfig *cfg;
+	TSCell *cells;
+	const double *base;     /* OpCost of the unattacked run */
+	size_t nbase, nsamples, ncells;
+	double ts;
+	te_mutex lock;
+	size_t next;            /* next cell to run */
+	int status;
+} TSSweep;
+
+const char *tsw_strerror(int status)
+{
+	switch (status) {
+	case TSW_OK:      return "no error";
+	case TSW_EARG:    return "invalid sweep";
+	case TSW_ENOMEM:  return "out of memory";
+	case TSW_ETHREAD: return "cannot start a thread";
+	default:          return "unknown error";
+	}
+}
+
+static int axis(int n)
+{
+	return n > 0 ? n : 1;
+}
+
+size_t tsw_cells(const TSConfig *cfg)
+{
+	return (size_t) cfg->nchannels * axis(cfg->nvalues) * axis(cfg->nstarts) *
+		axis(cfg->ndurations);
+}
+
+/* Runs one simulation with the attack a (NULL for none) and sums its
+ * OpCost, and its excess over base, at the sample period. */
+static int runcell(TSSweep *s, const TEAttack *a, double *opcost, TSCell *c)
+{
+	TESimConfig sim = s->cfg->sim;
+	TESimResult res;
+	TEAttackTable *t = NULL;
+	size_t i, n;
+	int status;
+
+	sim.telemetry = NULL;
+	sim.realtime = NULL;
+	sim.opcost = opcost;
+	sim.attack = NULL;
+	if (a) {
+		if (!(t = ta_new()))
+			return TSW_ENOMEM;
+		if (ta_add(t, a) != TA_OK) {
+			ta_free(t);
+			return TSW_EARG;
+		}
+		sim.attack = t;
+	}
+	status = tesim_run(&sim, NULL, &res);
+	ta_free(t);
+	if (status != TESIM_OK)
+		return TSW_EARG;
+	/* samples reached: the last one at or before res.t */
+	n = (size_t) (res.t / s->ts + 1e-9) + 1;
+	if (n > s->nsamples)
+		n = s->nsamples;
+	c->isd = res.isd;
+	c->t = res.t;
+	c->cost = c->impact = 0.;
+	for (i = 0; i < n; i++) {
+		c->cost += opcost[i];
+		c->impact += opcost[i] - (i < s->nbase ? s->base[i] : 0.);
+	}
+	c->cost *= s->ts;
+	c->impact *= s->ts;
+	return TSW_OK;
+}
+
+static void cellattack(const TSConfig *cfg, size_t cell, TEAttack *a)
+{
+	int nd = axis(cfg->ndurations), ns = axis(cfg->nstarts), nv = axis(cfg->nvalues);
+	int d = (int) (cell % nd), st = (int) (cell / nd % ns),
+		v = (int) (cell / nd / ns % nv), ch = (int) (cell / nd / ns / nv);
+
+	*a = cfg->attack;
+	a->art = cfg->channels[ch].art;
+	a->block = cfg->channels[ch].block;
+	if (cfg->nvalues > 0)
+		a->value = cfg->values[v];
+	if (cfg->nstarts > 0)
+		a->start = cfg->starts[st];
+	if (cfg->ndurations > 0)
+		a->duration = cfg->durations[d];
+}
+
+static TE_THREAD_FN(worker, arg)
+{
+	TSSweep *s = (TSSweep *) arg;
+	TEAttack a;
+	double *opcost;
+	size_t cell;
+	int status = TSW_OK;
+
+	if (!(opcost = (double *) malloc(s->nsamples * sizeof(double))))
+		status = TSW_ENOMEM;
+	for (;;) {
+		te_mutex_lock(&s->lock);
+		if (status != TSW_OK && s->status == TSW_OK)
+			s->status = status;
+		cell = s->status == TSW_OK ? s->next++ : s->ncells;
+		te_mutex_unlock(&s->lock);
+		if (cell >= s->ncells)
+			break;
+		cellattack(s->cfg, cell, &a);
+		status = runcell(s, &a, opcost, &s->cells[cell]);
+	}
+	free(opcost);
+	return TE_THREAD_RETURN;
+}
+
+int tsw_run(const TSConfig *cfg, TSCell *cells, TSCell *base)
+{
+	te_thread threads[TSW_MAX_THREADS];
+	TSSweep s;
+	TSCell b;
+	double *opcost;
+	int i, n = cfg->nthreads > 0 ? cfg->nthreads : te_ncpu();
+
+	if (cfg->nchannels <= 0 || !cfg->channels)
+		return TSW_EARG;
+	if (n < 1)
+		n = 1;
+	if (n > TSW_MAX_THREADS)
+		n = TSW_MAX_THREADS;
+	memset(&s, 0, sizeof(s));
+	s.cfg = cfg;
+	s.cells = cells;
+	s.ncells = tsw_cells(cfg);
+	s.nsamples = tesim_samples(&cfg->sim);
+	s.ts = cfg->sim.ts_save > 0. ? cfg->sim.ts_save : TE_TS_SAVE;
+	if (s.nsamples == 0)
+		return TSW_EARG;
+	if (!(opcost = (double *) malloc(s.nsamples * sizeof(double))))
+		return TSW_ENOMEM;
+
+	/* The unattacked run, against which the impact is taken */
+	s.nbase = s.nsamples;
+	s.base = opcost;
+	if ((s.status = runcell(&s, NULL, opcost, &b)) != TSW_OK) {
+		free(opcost);
+		return s.status;
+	}
+	s.nbase = (size_t) (b.t / s.ts + 1e-9) + 1;
+	b.impact = 0.;
+	if (base)
+		*base = b;
+
+	te_mutex_init(&s.lock);
+	for (i = 0; i < n; i++)
+		if (te_thread_create(&threads[i], worker, &s) != 0)
+			break;
+	if (i == 0)
+		s.status = TSW_ETHREAD;
+	while (i-- > 0)
+		te_thread_join(threads[i]);
+	te_mutex_destroy(&s.lock);
+	free(opcost);
+	return s.status;
+}
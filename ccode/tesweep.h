@@ -0,0 +1,78 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Parallel sweep of attack parameters.
+ *
+ * Runs one headless simulation (tesim.h) per cell of a grid over the
+ * attacked channel, the attack value, its start and its duration, spread
+ * over a pool of threads. A run stops at the plant shutdown, so the cells
+ * that trip the plant are also the cheap ones. Per cell the shutdown code,
+ * the time reached and the economic impact are returned: the operating
+ * cost (OpCost, $) accumulated until then and its excess over the
+ * unattacked run for the same span.
+ *
+ * Cells are numbered with the duration varying fastest:
+ *   cell = ((channel * nvalues + value) * nstarts + start) * ndurations + duration
+ */
+
+#ifndef __TESWEEP_H__
+#define __TESWEEP_H__
+
+#include <stddef.h>
+#include "teattack.h"
+#include "tesim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Status codes */
+#define TSW_OK       0
+#define TSW_EARG    -1
+#define TSW_ENOMEM  -2
+#define TSW_ETHREAD -3
+
+typedef struct {
+	int art;                /* TA_XMEAS or TA_XMV */
+	int block;              /* 1-based */
+} TSChannel;
+
+typedef struct {
+	TESimConfig sim;        /* plant and horizon; attack, telemetry,
+	                           realtime and opcost are not used */
+	TEAttack attack;        /* type, mode and the parameters not swept */
+	const TSChannel *channels;
+	int nchannels;
+	const double *values, *starts, *durations;  /* NULL for attack's */
+	int nvalues, nstarts, ndurations;
+	int nthreads;           /* 0 for one per CPU */
+} TSConfig;
+
+typedef struct {
+	long isd;               /* shutdown code, 0 if the plant kept running */
+	double t;               /* time reached, hours */
+	double cost;            /* operating cost until t, $ */
+	double impact;          /* cost minus that of the unattacked run, $ */
+} TSCell;
+
+/* Number of cells of the sweep. */
+size_t tsw_cells(const TSConfig *cfg);
+
+/* Runs the sweep into cells (tsw_cells() entries). The unattacked run
+ * goes to base if not NULL. If the unattacked run shuts down itself, the
+ * impact of later times is taken against a cost of zero. */
+int tsw_run(const TSConfig *cfg, TSCell *cells, TSCell *base);
+
+const char *tsw_strerror(int status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TESWEEP_H__ */
@@ -0,0 +1,324 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Shared-memory telemetry ring, see tetelem.h.
+ *
+ * Layout: a 64-byte header followed by nslots slots. A slot is an 8-byte
+ * sequence word and a TLRecord. Record n (counting from 0) goes to slot
+ * n % nslots; its sequence word is 2n+1 while it is written and 2n+2 when it
+ * is complete, so a reader knows from the word alone whether the slot holds
+ * the record it wants, an older one (not written yet) or a newer one
+ * (overrun). The header's head word is the number of complete records.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include "tetelem.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+typedef unsigned __int64 tl_u64;
+/* Aligned volatile accesses are acquire loads and release stores on x86
+ * and x64 (/volatile:ms). */
+#define tl_load(p)      (*(volatile tl_u64 *) (p))
+#define tl_store(p, v)  (*(volatile tl_u64 *) (p) = (v))
+#define tl_fence()      MemoryBarrier()
+#else
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+typedef uint64_t tl_u64;
+#define tl_load(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define tl_store(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define tl_fence()      __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+#define TL_MAGIC    "TETELEM"
+#define TL_VERSION  1
+#define TL_NAME     128
+
+typedef struct {
+	char magic[8];
+	unsigned int version, nslots, slotsize, reserved;
+	tl_u64 head;            /* complete records */
+	char pad[64 - 32];
+} TLHeader;
+
+typedef struct {
+	tl_u64 seq;
+	TLRecord rec;
+} TLSlot;
+
+typedef struct {
+	void *base;
+	size_t size;
+#if defined(_WIN32)
+	HANDLE h;
+#endif
+	char name[TL_NAME];
+} TLMap;
+
+struct TLWriter {
+	TLMap map;
+	TLHeader *h;
+	TLSlot *slot;
+	tl_u64 n;
+};
+
+struct TLReader {
+	TLMap map;
+	const TLHeader *h;
+	const TLSlot *slot;
+	tl_u64 n;               /* next record to read */
+};
+
+const char *tl_strerror(int status)
+{
+	switch (status) {
+	case TL_OK:      return "no error";
+	case TL_EMPTY:   return "no new record";
+	case TL_EIO:     return "cannot map the shared memory";
+	case TL_EFORMAT: return "not a telemetry ring";
+	case TL_ENOMEM:  return "out of memory";
+	case TL_EARG:    return "invalid argument";
+	default:         return "unknown error";
+	}
+}
+
+/* ============================================================================= */
+
+/* Mapping */
+
+static int map_name(TLMap *m, const char *name)
+{
+#if defined(_WIN32)
+	const char *prefix = "Local\\";
+#else
+	const char *prefix = "/";
+#endif
+	if (!name || !*name || strlen(prefix) + strlen(name) >= TL_NAME)
+		return TL_EARG;
+	strcpy(m->name, prefix);
+	strcat(m->name, name);
+	return TL_OK;
+}
+
+static int map_create(TLMap *m, size_t size)
+{
+#if defined(_WIN32)
+	m->h = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+			(DWORD) ((unsigned __int64) size >> 32), (DWORD) size, m->name);
+	if (!m->h)
+		return TL_EIO;
+	if (!(m->base = MapViewOfFile(m->h, FILE_MAP_WRITE, 0, 0, size))) {
+		CloseHandle(m->h);
+		return TL_EIO;
+	}
+#else
+	int fd;
+
+	/* A new object, so that readers of an old run keep their data. */
+	shm_unlink(m->name);
+	if ((fd = shm_open(m->name, O_CREAT | O_EXCL | O_RDWR, 0644)) < 0)
+		return TL_EIO;
+	if (ftruncate(fd, (off_t) size) != 0) {
+		close(fd);
+		shm_unlink(m->name);
+		return TL_EIO;
+	}
+	m->base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (m->base == MAP_FAILED) {
+		shm_unlink(m->name);
+		return TL_EIO;
+	}
+#endif
+	m->size = size;
+	return TL_OK;
+}
+
+static int map_open(TLMap *m)
+{
+#if defined(_WIN32)
+	MEMORY_BASIC_INFORMATION info;
+
+	if (!(m->h = OpenFileMappingA(FILE_MAP_READ, FALSE, m->name)))
+		return TL_EIO;
+	if (!(m->base = MapViewOfFile(m->h, FILE_MAP_READ, 0, 0, 0))) {
+		CloseHandle(m->h);
+		return TL_EIO;
+	}
+	VirtualQuery(m->base, &info, sizeof(info));
+	m->size = info.RegionSize;
+#else
+	int fd;
+	off_t size;
+
+	if ((fd = shm_open(m->name, O_RDONLY, 0)) < 0)
+		return TL_EIO;
+	if ((size = lseek(fd, 0, SEEK_END)) <= 0) {
+		close(fd);
+		return TL_EFORMAT;
+	}
+	m->base = mmap(NULL, (size_t) size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (m->base == MAP_FAILED)
+		return TL_EIO;
+	m->size = (size_t) size;
+#endif
+	return TL_OK;
+}
+
+static void map_close(TLMap *m)
+{
+#if defined(_WIN32)
+	UnmapViewOfFile(m->base);
+	CloseHandle(m->h);
+#else
+	munmap(m->base, m->size);
+#endif
+}
+
+/* ============================================================================= */
+
+/* Writer */
+
+int tl_create(const char *name, unsigned nslots, TLWriter **out)
+{
+	TLWriter *w;
+	int status;
+
+	*out = NULL;
+	if (nslots == 0)
+		nslots = TL_DEFAULT_SLOTS;
+	if (!(w = (TLWriter *) calloc(1, sizeof(*w))))
+		return TL_ENOMEM;
+	if ((status = map_name(&w->map, name)) != TL_OK ||
+			(status = map_create(&w->map,
+				sizeof(TLHeader) + (size_t) nslots * sizeof(TLSlot))) != TL_OK) {
+		free(w);
+		return status;
+	}
+	w->h = (TLHeader *) w->map.base;
+	w->slot = (TLSlot *) (w->h + 1);
+	memset(w->map.base, 0, w->map.size);
+	w->h->version = TL_VERSION;
+	w->h->nslots = nslots;
+	w->h->slotsize = sizeof(TLSlot);
+	/* The magic goes last: a reader that sees it sees a valid header. */
+	tl_fence();
+	memcpy(w->h->magic, TL_MAGIC, 8);
+	*out = w;
+	return TL_OK;
+}
+
+void tl_publish(TLWriter *w, double t, const double *xmeas, const double *xmv,
+		long isd)
+{
+	TLSlot *s = &w->slot[w->n % w->h->nslots];
+
+	tl_store(&s->seq, 2*w->n + 1);
+	tl_fence();
+	s->rec.t = t;
+	memcpy(s->rec.xmeas, xmeas, sizeof(s->rec.xmeas));
+	memcpy(s->rec.xmv, xmv, sizeof(s->rec.xmv));
+	s->rec.isd = (int) isd;
+	tl_store(&s->seq, 2*w->n + 2);
+	tl_store(&w->h->head, ++w->n);
+}
+
+void tl_destroy(TLWriter *w)
+{
+	if (!w)
+		return;
+	map_close(&w->map);
+#if !defined(_WIN32)
+	shm_unlink(w->map.name);
+#endif
+	free(w);
+}
+
+/* ============================================================================= */
+
+/* Reader */
+
+int tl_attach(const char *name, TLReader **out)
+{
+	TLReader *r;
+	int status;
+
+	*out = NULL;
+	if (!(r = (TLReader *) calloc(1, sizeof(*r))))
+		return TL_ENOMEM;
+	if ((status = map_name(&r->map, name)) != TL_OK ||
+			(status = map_open(&r->map)) != TL_OK) {
+		free(r);
+		return status;
+	}
+	r->h = (const TLHeader *) r->map.base;
+	r->slot = (const TLSlot *) (r->h + 1);
+	if (r->map.size < sizeof(TLHeader) || memcmp(r->h->magic, TL_MAGIC, 8) != 0 ||
+			r->h->version != TL_VERSION || r->h->slotsize != sizeof(TLSlot) ||
+			r->h->nslots == 0 ||
+			r->map.size < sizeof(TLHeader) + (size_t) r->h->nslots * sizeof(TLSlot)) {
+		tl_detach(r);
+		return TL_EFORMAT;
+	}
+	r->n = tl_load(&r->h->head);
+	*out = r;
+	return TL_OK;
+}
+
+int tl_next(TLReader *r, TLRecord *rec, unsigned long *lost)
+{
+	const TLSlot *s;
+	tl_u64 head, seq, want, skipped = 0;
+	unsigned nslots = r->h->nslots;
+
+	for (;;) {
+		head = tl_load(&r->h->head);
+		if (r->n >= head)
+			break;
+		if (head - r->n > nslots) {
+			skipped += head - nslots - r->n;
+			r->n = head - nslots;
+		}
+		s = &r->slot[r->n % nslots];
+		want = 2*r->n + 2;
+		if ((seq = tl_load(&s->seq)) == want) {
+			memcpy(rec, (const void *) &s->rec, sizeof(*rec));
+			tl_fence();
+			if (tl_load(&s->seq) == want) {
+				r->n++;
+				if (lost)
+					*lost = (unsigned long) skipped;
+				return TL_OK;
+			}
+		}
+		/* The writer overtook us while we copied; skip the slot. */
+		skipped++;
+		r->n++;
+	}
+	if (lost)
+		*lost = (unsigned long) skipped;
+	return TL_EMPTY;
+}
+
+void tl_detach(TLReader *r)
+{
+	if (!r)
+		return;
+	map_close(&r->map);
+	free(r);
+}
@@ -0,0 +1,86 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Shared-memory telemetry ring.
+ *
+ * The plant publishes time, xmeas, xmv and the shutdown state (ISD) of every
+ * major step into a named shared-memory ring of fixed-size slots. There is
+ * one writer and any number of readers in other processes, which attach
+ * and detach at any time. The writer never waits for a reader: each slot
+ * carries the sequence number of the record it holds, and a reader that fell
+ * more than a ring behind sees a newer number, counts the records it lost
+ * and resumes with the oldest record still in the ring.
+ *
+ * Published from temex, temexd and temexr when they are compiled with
+ * -DTE_TELEMETRY, and from native drivers through tesim (TESimConfig).
+ *
+ * Link with -lrt on older glibc (shm_open).
+ */
+
+#ifndef __TETELEM_H__
+#define __TETELEM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef TE_TELEMETRY_NAME
+#define TE_TELEMETRY_NAME "te_telemetry"   /* default ring of the S-functions */
+#endif
+
+#define TL_DEFAULT_SLOTS 8192   /* about 4 h of Ts_base steps */
+
+/* Status codes */
+#define TL_OK        0
+#define TL_EMPTY     1      /* tl_next: no new record yet */
+#define TL_EIO      -1
+#define TL_EFORMAT  -2
+#define TL_ENOMEM   -3
+#define TL_EARG     -4
+
+typedef struct {
+	double t;               /* hours */
+	double xmeas[41];
+	double xmv[12];
+	int isd;                /* shutdown code, 0 while running */
+	int reserved;
+} TLRecord;
+
+typedef struct TLWriter TLWriter;
+typedef struct TLReader TLReader;
+
+/* Creates (or replaces) the ring called name with nslots slots, 0 for
+ * TL_DEFAULT_SLOTS. */
+int tl_create(const char *name, unsigned nslots, TLWriter **out);
+
+/* Publishes one record. Never blocks. */
+void tl_publish(TLWriter *w, double t, const double *xmeas, const double *xmv,
+		long isd);
+
+/* Removes the ring; attached readers keep their mapping. */
+void tl_destroy(TLWriter *w);
+
+/* Attaches to the ring called name; the first tl_next() returns the first
+ * record published after the call. */
+int tl_attach(const char *name, TLReader **out);
+
+/* Copies the next record into rec. Returns TL_OK, or TL_EMPTY when the
+ * reader has caught up with the writer. *lost (may be NULL) receives the
+ * number of records overwritten before they could be read. */
+int tl_next(TLReader *r, TLRecord *rec, unsigned long *lost);
+
+void tl_detach(TLReader *r);
+
+const char *tl_strerror(int status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TETELEM_H__ */
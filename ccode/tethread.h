@@ -0,0 +1,73 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Minimal threads, mutexes and condition variables on Win32 and POSIX. */
+
+#ifndef __TETHREAD_H__
+#define __TETHREAD_H__
+
+#if defined(_WIN32)
+
+#include <windows.h>
+
+typedef HANDLE te_thread;
+typedef CRITICAL_SECTION te_mutex;
+typedef CONDITION_VARIABLE te_cond;
+
+#define TE_THREAD_FN(name, arg) DWORD WINAPI name(LPVOID arg)
+#define TE_THREAD_RETURN 0
+
+#define te_thread_create(t, fn, arg) \
+	((*(t) = CreateThread(NULL, 0, (fn), (arg), 0, NULL)) != NULL ? 0 : -1)
+#define te_thread_join(t) \
+	(WaitForSingleObject((t), INFINITE), CloseHandle(t))
+
+#define te_mutex_init(m)      InitializeCriticalSection(m)
+#define te_mutex_destroy(m)   DeleteCriticalSection(m)
+#define te_mutex_lock(m)      EnterCriticalSection(m)
+#define te_mutex_unlock(m)    LeaveCriticalSection(m)
+
+#define te_cond_init(c)       InitializeConditionVariable(c)
+#define te_cond_destroy(c)    ((void) (c))
+#define te_cond_wait(c, m)    SleepConditionVariableCS((c), (m), INFINITE)
+#define te_cond_broadcast(c)  WakeAllConditionVariable(c)
+
+#define te_ncpu()             ((int) GetActiveProcessorCount(ALL_PROCESSOR_GROUPS))
+
+#else
+
+#include <pthread.h>
+#include <unistd.h>
+
+typedef pthread_t te_thread;
+typedef pthread_mutex_t te_mutex;
+typedef pthread_cond_t te_cond;
+
+#define TE_THREAD_FN(name, arg) void *name(void *arg)
+#define TE_THREAD_RETURN NULL
+
+#define te_thread_create(t, fn, arg) \
+	(pthread_create((t), NULL, (fn), (arg)) == 0 ? 0 : -1)
+#define te_thread_join(t)     pthread_join((t), NULL)
+
+#define te_mutex_init(m)      pthread_mutex_init((m), NULL)
+#define te_mutex_destroy(m)   pthread_mutex_destroy(m)
+#define te_mutex_lock(m)      pthread_mutex_lock(m)
+#define te_mutex_unlock(m)    pthread_mutex_unlock(m)
+
+#define te_cond_init(c)       pthread_cond_init((c), NULL)
+#define te_cond_destroy(c)    pthread_cond_destroy(c)
+#define te_cond_wait(c, m)    pthread_cond_wait((c), (m))
+#define te_cond_broadcast(c)  pthread_cond_broadcast(c)
+
+#define te_ncpu()             ((int) sysconf(_SC_NPROCESSORS_ONLN))
+
+#endif
+
+#endif /* __TETHREAD_H__ */
@@ -0,0 +1,176 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Smallest attack that shuts the TE plant down.
+ *
+ *   tethresh -c channel -p value|duration -r lo:hi [-e tol] [-i isd]
+ *            [-y type] [-k mode] [-v value] [-b start] [-l duration]
+ *            [-t hours] [-d idv[,idv...]] [-s seed] [-C control] [-j threads]
+ *
+ * Searches the attack value or duration on one channel (e.g. xmv3 or
+ * xmeas9) in [lo, hi] down to tol (default 1e-3 of hi - lo) with
+ * tesearch.h, optionally for a given shutdown code only, and prints
+ *
+ *   lo hi isd t runs
+ *
+ * lo the largest parameter found not to trip the plant, hi the smallest
+ * that does, isd and t the shutdown at hi and runs the simulations used.
+ * The type is integrity (default) or dos, the mode step (default),
+ * interval or periodic; times are in hours, the horizon defaults to 72 h.
+ * -C closes the loop with the multiloop controller of a configuration file
+ * (temloop.h), e.g. data/Mode1Control.txt; the open-loop plant shuts down
+ * after a few hours without any attack, so that no bracket holds within
+ * a longer horizon.
+ *
+ * Build: cc -O2 -o tethresh tethresh.c tesearch.c tesim.c teplant.c
+ *        temloop.c teattack.c terealtime.c tetelem.c tetrace.c -lm -lpthread
+ *        -lrt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tesearch.h"
+
+static void usage(void)
+{
+	fprintf(stderr, "Usage: tethresh -c channel -p value|duration -r lo:hi [-e tol] [-i isd]\n"
+			"                [-y type] [-k mode] [-v value] [-b start] [-l duration]\n"
+			"                [-t hours] [-d idv[,idv...]] [-s seed] [-C control] [-j threads]\n");
+	exit(2);
+}
+
+/* Parses a channel such as "xmv3" or "xmeas9". */
+static void parsechannel(const char *s, TEAttack *a)
+{
+	char *end;
+	long max;
+
+	if (strncmp(s, "xmv", 3) == 0) {
+		a->art = TA_XMV;
+		max = TE_NU;
+		s += 3;
+	} else if (strncmp(s, "xmeas", 5) == 0) {
+		a->art = TA_XMEAS;
+		max = TE_NY;
+		s += 5;
+	} else
+		usage();
+	a->block = (int) strtol(s, &end, 10);
+	if (end == s || *end != '\0' || a->block < 1 || a->block > max)
+		usage();
+}
+
+static void parserange(const char *s, double *lo, double *hi)
+{
+	char *end;
+
+	*lo = strtod(s, &end);
+	if (end == s || *end != ':')
+		usage();
+	s = end + 1;
+	*hi = strtod(s, &end);
+	if (end == s || *end != '\0')
+		usage();
+}
+
+/* Switches on the disturbances listed in s, e.g. "1,6". */
+static void parseidv(const char *s, double *idv)
+{
+	char *end;
+	long i;
+
+	for (;;) {
+		i = strtol(s, &end, 10);
+		if (end == s || i < 1 || i > TE_NIDV)
+			usage();
+		idv[i - 1] = 1.;
+		if (*end == '\0')
+			return;
+		if (*end != ',')
+			usage();
+		s = end + 1;
+	}
+}
+
+static int keyword(const char *s, const char *const *words, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		if (strcmp(s, words[i]) == 0)
+			return i + 1;
+	usage();
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	static const char *const types[] = {"integrity", "dos"};
+	static const char *const modes[] = {"none", "step", "interval", "periodic"};
+	static const char *const params[] = {"value", "duration"};
+	TSRConfig cfg;
+	TSRResult res;
+	TMLConfig tmlcfg;
+	double idv[TE_NIDV];
+	const char *control = NULL;
+	int i, status;
+
+	memset(&cfg, 0, sizeof(cfg));
+	memset(idv, 0, sizeof(idv));
+	cfg.sim.tstop = 72.;
+	cfg.sim.idv = idv;
+	cfg.attack.type = TA_INTEGRITY;
+	cfg.attack.mode = TA_STEP;
+	for (i = 1; i < argc; i++) {
+		if (argv[i][0] != '-' || argv[i][2] != '\0' || i + 1 == argc)
+			usage();
+		switch (argv[i][1]) {
+		case 'c': parsechannel(argv[++i], &cfg.attack); break;
+		case 'p': cfg.param = keyword(argv[++i], params, 2); break;
+		case 'r': parserange(argv[++i], &cfg.lo, &cfg.hi); break;
+		case 'e': cfg.tol = atof(argv[++i]); break;
+		case 'i': cfg.isd = atol(argv[++i]); break;
+		case 'y': cfg.attack.type = keyword(argv[++i], types, 2); break;
+		case 'k': cfg.attack.mode = keyword(argv[++i], modes, 4); break;
+		case 'v': cfg.attack.value = atof(argv[++i]); break;
+		case 'b': cfg.attack.start = atof(argv[++i]); break;
+		case 'l': cfg.attack.duration = atof(argv[++i]); break;
+		case 't': cfg.sim.tstop = atof(argv[++i]); break;
+		case 'd': parseidv(argv[++i], idv); break;
+		case 's': cfg.sim.seed = atof(argv[++i]); break;
+		case 'C': control = argv[++i]; break;
+		case 'j': cfg.nthreads = atoi(argv[++i]); break;
+		default:  usage();
+		}
+	}
+	if (cfg.attack.block == 0 || cfg.param == 0 || !(cfg.lo < cfg.hi))
+		usage();
+	if (cfg.tol <= 0.)
+		cfg.tol = 1e-3 * (cfg.hi - cfg.lo);
+	if (control) {
+		tml_defaults(&tmlcfg);
+		if ((status = tml_load(control, &tmlcfg, &i)) != TML_OK) {
+			if (status == TML_ESYNTAX)
+				fprintf(stderr, "tethresh: %s:%d: %s\n", control, i, tml_strerror(status));
+			else
+				fprintf(stderr, "tethresh: %s: %s\n", control, tml_strerror(status));
+			return 1;
+		}
+		cfg.sim.control = &tmlcfg;
+	}
+
+	if ((status = tsr_run(&cfg, &res)) != TSR_OK) {
+		fprintf(stderr, "tethresh: %s%s\n", tsr_strerror(status),
+				status == TSR_EBRACKET && !control ? " (open loop, see -C)" : "");
+		return 1;
+	}
+	printf("%.10g %.10g %ld %.10g %d\n", res.lo, res.hi, res.isd, res.t, res.runs);
+	return 0;
+}
@@ -0,0 +1,277 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Leveled binary tracing, see tetrace.h.
+ *
+ * Record n (counting from 0) goes to slot n % nslots; the slot's sequence
+ * word is 2n+1 while the record is written and 2n+2 when it is complete,
+ * and head is the number of complete records, as in the telemetry ring of
+ * tetelem.c but in process memory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tetrace.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+typedef unsigned __int64 ttr_u64;
+/* Aligned volatile accesses are acquire loads and release stores on x86
+ * and x64 (/volatile:ms). */
+#define ttr_get(p)     (*(volatile ttr_u64 *) (p))
+#define ttr_set(p, v)  (*(volatile ttr_u64 *) (p) = (v))
+#define ttr_fence()    MemoryBarrier()
+#else
+#include <stdint.h>
+typedef uint64_t ttr_u64;
+#define ttr_get(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ttr_set(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define ttr_fence()    __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+#define TTR_MAGIC    "TETRACE"
+#define TTR_VERSION  1
+
+typedef struct {
+	ttr_u64 seq;
+	TTRRecord rec;
+} TTRSlot;
+
+struct TTRBuffer {
+	TTRSlot *slot;
+	unsigned nslots;
+	int level;
+	ttr_u64 head;           /* complete records */
+	ttr_u64 n;              /* records written, the writer's copy of head */
+};
+
+typedef struct {
+	char magic[8];
+	unsigned int version, recsize;
+	ttr_u64 lost;
+} TTRFileHeader;
+
+/* Level and format of each event; the arguments are passed to the format
+ * as doubles. */
+static const struct {
+	const char *name, *format;
+} ttr_events[TTR_NEVENT] = {
+	{"?", "unknown event (%g %g %g)"},
+	{"run", "seed %.0f, %g h, fused %.0f"},
+	{"start", "S-function started"},
+	{"init", "initial conditions (first %.0f)"},
+	{"idv", "disturbances on at step %.0f"},
+	{"control", "controller sample at step %.0f"},
+	{"newton", "tesub2_ from %g degC to h = %g (ity %.0f) did not converge"},
+	{"shutdown", "shutdown, isd %.0f"},
+	{"end", "end of run, isd %.0f, %.0f samples"}
+};
+
+static const char *ttr_levels[] = {"off", "error", "warn", "info", "debug"};
+
+const char *ttr_strerror(int status)
+{
+	switch (status) {
+	case TTR_OK:      return "no error";
+	case TTR_EMPTY:   return "no new record";
+	case TTR_EIO:     return "cannot read or write the file";
+	case TTR_EFORMAT: return "not a trace file";
+	case TTR_ENOMEM:  return "out of memory";
+	case TTR_EARG:    return "invalid argument";
+	default:          return "unknown error";
+	}
+}
+
+/* ============================================================================= */
+
+/* Writer */
+
+int ttr_open(unsigned nslots, int level, TTRBuffer **out)
+{
+	TTRBuffer *b;
+
+	*out = NULL;
+	if (nslots == 0)
+		nslots = TTR_DEFAULT_SLOTS;
+	if (!(b = (TTRBuffer *) calloc(1, sizeof(*b))))
+		return TTR_ENOMEM;
+	if (!(b->slot = (TTRSlot *) calloc(nslots, sizeof(TTRSlot)))) {
+		free(b);
+		return TTR_ENOMEM;
+	}
+	b->nslots = nslots;
+	b->level = level;
+	*out = b;
+	return TTR_OK;
+}
+
+void ttr_setlevel(TTRBuffer *b, int level)
+{
+	b->level = level;
+}
+
+void ttr_put(TTRBuffer *b, int level, int event, double t, double a0,
+		double a1, double a2)
+{
+	TTRSlot *s;
+
+	if (level > b->level)
+		return;
+	s = &b->slot[b->n % b->nslots];
+	ttr_set(&s->seq, 2*b->n + 1);
+	ttr_fence();
+	s->rec.t = t;
+	s->rec.arg[0] = a0;
+	s->rec.arg[1] = a1;
+	s->rec.arg[2] = a2;
+	s->rec.event = (unsigned short) event;
+	s->rec.level = (unsigned char) level;
+	ttr_set(&s->seq, 2*b->n + 2);
+	ttr_set(&b->head, ++b->n);
+}
+
+void ttr_close(TTRBuffer *b)
+{
+	if (!b)
+		return;
+	free(b->slot);
+	free(b);
+}
+
+/* ============================================================================= */
+
+/* Reader */
+
+int ttr_next(const TTRBuffer *b, unsigned long long *pos, TTRRecord *rec,
+		unsigned long *lost)
+{
+	const TTRSlot *s;
+	ttr_u64 head, want, n = *pos, skipped = 0;
+
+	for (;;) {
+		head = ttr_get(&b->head);
+		if (n >= head)
+			break;
+		if (head - n > b->nslots) {
+			skipped += head - b->nslots - n;
+			n = head - b->nslots;
+		}
+		s = &b->slot[n % b->nslots];
+		want = 2*n + 2;
+		if (ttr_get(&s->seq) == want) {
+			memcpy(rec, (const void *) &s->rec, sizeof(*rec));
+			ttr_fence();
+			if (ttr_get(&s->seq) == want) {
+				*pos = n + 1;
+				if (lost)
+					*lost = (unsigned long) skipped;
+				return TTR_OK;
+			}
+		}
+		/* The writer overtook us while we copied; skip the slot. */
+		skipped++;
+		n++;
+	}
+	*pos = n;
+	if (lost)
+		*lost = (unsigned long) skipped;
+	return TTR_EMPTY;
+}
+
+int ttr_save(const TTRBuffer *b, const char *path)
+{
+	TTRFileHeader h;
+	TTRRecord rec;
+	FILE *fp;
+	unsigned long long pos = 0;
+	unsigned long lost;
+	int ok;
+
+	if (!(fp = fopen(path, "wb")))
+		return TTR_EIO;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, TTR_MAGIC, 8);
+	h.version = TTR_VERSION;
+	h.recsize = sizeof(TTRRecord);
+	ok = fwrite(&h, sizeof(h), 1, fp) == 1;
+	while (ok && ttr_next(b, &pos, &rec, &lost) == TTR_OK) {
+		h.lost += lost;
+		ok = fwrite(&rec, sizeof(rec), 1, fp) == 1;
+	}
+	/* The lost records are only known at the end. */
+	if (ok && h.lost > 0)
+		ok = fseek(fp, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, fp) == 1;
+	ok = fclose(fp) == 0 && ok;
+	return ok ? TTR_OK : TTR_EIO;
+}
+
+int ttr_load(const char *path, TTRRecord **recs, size_t *n, unsigned long *lost)
+{
+	TTRFileHeader h;
+	TTRRecord *r = NULL, *p;
+	FILE *fp;
+	size_t cap = 0, k = 0;
+
+	*recs = NULL;
+	*n = 0;
+	if (!(fp = fopen(path, "rb")))
+		return TTR_EIO;
+	if (fread(&h, sizeof(h), 1, fp) != 1 || memcmp(h.magic, TTR_MAGIC, 8) != 0 ||
+			h.version != TTR_VERSION || h.recsize != sizeof(TTRRecord)) {
+		fclose(fp);
+		return TTR_EFORMAT;
+	}
+	for (;;) {
+		if (k == cap) {
+			cap = cap ? 2*cap : 256;
+			if (!(p = (TTRRecord *) realloc(r, cap * sizeof(*r)))) {
+				free(r);
+				fclose(fp);
+				return TTR_ENOMEM;
+			}
+			r = p;
+		}
+		if (fread(&r[k], sizeof(*r), 1, fp) != 1)
+			break;
+		k++;
+	}
+	fclose(fp);
+	*recs = r;
+	*n = k;
+	if (lost)
+		*lost = (unsigned long) h.lost;
+	return TTR_OK;
+}
+
+/* ============================================================================= */
+
+int ttr_format(const TTRRecord *r, char *buf, size_t size)
+{
+	char msg[160];
+	int e = r->event < TTR_NEVENT ? r->event : 0;
+	int level = r->level <= TTR_DEBUG ? r->level : TTR_DEBUG;
+
+	snprintf(msg, sizeof(msg), ttr_events[e].format, r->arg[0], r->arg[1],
+			r->arg[2]);
+	return snprintf(buf, size, "%12.6f %-5s %-8s %s", r->t, ttr_levels[level],
+			ttr_events[e].name, msg);
+}
+
+int ttr_level(const char *name)
+{
+	char *end;
+	long l;
+	int i;
+
+	for (i = 0; i <= TTR_DEBUG; i++)
+		if (strcmp(name, ttr_levels[i]) == 0)
+			return i;
+	l = strtol(name, &end, 10);
+	return end != name && *end == '\0' && l >= TTR_OFF && l <= TTR_DEBUG ? (int) l : -1;
+}
@@ -0,0 +1,132 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Leveled binary tracing.
+ *
+ * A trace point stores a fixed-size record (event, level, time and up to
+ * three numbers) into the trace buffer of its run or S-function block.
+ * Nothing is formatted while the plant runs: records are formatted offline
+ * from the event table by ttr_format(), e.g. by tetrfmt from a file that
+ * ttr_save() wrote at the end of the run.
+ *
+ * Trace points go through TTR(). Levels above TE_TRACE_LEVEL (default
+ * TTR_INFO, 0 removes all trace points) compile to nothing; the others
+ * are filtered at run time against the buffer's level (ttr_setlevel), and
+ * a NULL buffer traces nothing.
+ *
+ * A buffer is a ring of fixed-size slots with one writer, the thread that
+ * runs the plant, which never waits: once the ring is full the oldest
+ * records are overwritten. Other threads may read it while it is written,
+ * without locks, with the sequence words of tetelem.c: ttr_next() counts the
+ * records it lost to the writer and resumes with the oldest one left.
+ *
+ * Trace file: an 8-byte magic "TETRACE", version, record size and the
+ * number of records lost before the first one (native byte order), then
+ * the records.
+ */
+
+#ifndef __TETRACE_H__
+#define __TETRACE_H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Levels */
+#define TTR_OFF     0
+#define TTR_ERROR   1
+#define TTR_WARN    2
+#define TTR_INFO    3
+#define TTR_DEBUG   4
+
+#ifndef TE_TRACE_LEVEL
+#define TE_TRACE_LEVEL TTR_INFO
+#endif
+
+/* Events, arguments in brackets */
+#define TTR_RUN       1     /* native run starts [seed, tstop, fused] */
+#define TTR_START     2     /* S-function starts */
+#define TTR_INIT      3     /* initial conditions [first] */
+#define TTR_IDV       4     /* disturbances switch on [step] */
+#define TTR_CONTROL   5     /* controller sample [step] */
+#define TTR_NEWTON    6     /* tesub2_ did not converge [t, h, ity] */
+#define TTR_SHUTDOWN  7     /* plant shut down [isd] */
+#define TTR_END       8     /* run ends [isd, samples] */
+#define TTR_NEVENT    9
+
+#define TTR_DEFAULT_SLOTS 4096
+
+/* Status codes */
+#define TTR_OK        0
+#define TTR_EMPTY     1     /* ttr_next: no new record yet */
+#define TTR_EIO      -1
+#define TTR_EFORMAT  -2
+#define TTR_ENOMEM   -3
+#define TTR_EARG     -4
+
+typedef struct {
+	double t;               /* hours */
+	double arg[3];
+	unsigned short event;
+	unsigned char level;
+	unsigned char reserved[5];
+} TTRRecord;
+
+typedef struct TTRBuffer TTRBuffer;
+
+#if TE_TRACE_LEVEL > 0
+#define TTR(tr, level, event, t, a0, a1, a2) do { \
+		if ((level) <= TE_TRACE_LEVEL && (tr)) \
+			ttr_put((tr), (level), (event), (t), (a0), (a1), (a2)); \
+	} while (0)
+#else
+#define TTR(tr, level, event, t, a0, a1, a2)  ((void) 0)
+#endif
+
+const char *ttr_strerror(int status);
+
+/* Creates a buffer of nslots records (0 for TTR_DEFAULT_SLOTS) that keeps
+ * the records up to level. */
+int ttr_open(unsigned nslots, int level, TTRBuffer **out);
+
+void ttr_setlevel(TTRBuffer *b, int level);
+
+/* Stores one record if level is within the buffer's level. Never blocks;
+ * one writer per buffer. Called through TTR(). */
+void ttr_put(TTRBuffer *b, int level, int event, double t, double a0,
+		double a1, double a2);
+
+/* Copies record *pos (counting from 0 at ttr_open) to rec and advances
+ * *pos. Returns TTR_OK, or TTR_EMPTY when *pos is the next record to be
+ * written. If the record was overwritten, *lost (may be NULL) receives the
+ * records skipped to the oldest one in the ring. */
+int ttr_next(const TTRBuffer *b, unsigned long long *pos, TTRRecord *rec,
+		unsigned long *lost);
+
+/* Writes the records still in the ring to a trace file. */
+int ttr_save(const TTRBuffer *b, const char *path);
+
+void ttr_close(TTRBuffer *b);
+
+/* Reads a trace file into *recs (free() it), *n records, of which *lost
+ * were lost before the first. */
+int ttr_load(const char *path, TTRRecord **recs, size_t *n, unsigned long *lost);
+
+/* Formats a record as one line without newline, like snprintf. */
+int ttr_format(const TTRRecord *r, char *buf, size_t size);
+
+/* Level of a name (error, warn, info, debug, off) or number, or -1. */
+int ttr_level(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TETRACE_H__ */
@@ -0,0 +1,246 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+
+/* Trains a PCA monitoring model (tepca.h) on stored runs.
+ *
+ *   tetrain [-k components | -f fraction] [-a alpha] [-c columns]
+ *           [-w t0:t1] [-j threads] -o model.txt store...
+ *
+ * Streams the run stores (runstore.h, as written by tebatch) one block at
+ * a time on a pool of threads, each summing its share of the stores into
+ * its own mean/covariance accumulator (tecov.h); the accumulators are then
+ * merged in thread order, so the result does not depend on scheduling.
+ * Memory does not grow with the number or length of the runs.
+ *
+ * columns lists the run store columns to monitor, e.g. "1-22,42-53"
+ * (default all 53); -w keeps the samples with t0 <= t <= t1 only, e.g.
+ * to skip a start-up transient. The model keeps k components, or the
+ * fewest that explain the fraction of the variance (default 0.9), with
+ * control limits for a false alarm rate alpha (default 0.01).
+ *
+ * Build: cc -O2 -o tetrain tetrain.c tecov.c tepca.c runstore.c -lm -lpthread
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "runstore.h"
+#include "tecov.h"
+#include "tethread.h"
+
+#define TETRAIN_MAX_THREADS 256
+
+typedef struct {
+	char **files;
+	int nfiles, nthreads, index;
+	const int *cols;
+	int ncols;
+	double t0, t1;
+	TCAcc acc;
+	int status;             /* RS_* of the first failure */
+	const char *failed;
+} Worker;
+
+static void usage(void)
+{
+	fprintf(stderr, "Usage: tetrain [-k components | -f fraction] [-a alpha] [-c columns]\n"
+			"               [-w t0:t1] [-j threads] -o model.txt store...\n");
+	exit(2);
+}
+
+/* Parses a column list such as "1-22,42-53". */
+static int parsecols(const char *s, int *cols)
+{
+	char *end;
+	long first, last;
+	int n = 0;
+
+	for (;;) {
+		first = last = strtol(s, &end, 10);
+		if (end == s)
+			usage();
+		s = end;
+		if (*s == '-') {
+			last = strtol(++s, &end, 10);
+			if (end == s)
+				usage();
+			s = end;
+		}
+		if (first < 1 || last > RS_TE_COLUMNS || last < first ||
+				n + last - first + 1 > TP_MAX_VARS)
+			usage();
+		while (first <= last)
+			cols[n++] = (int) first++;
+		if (*s == '\0')
+			return n;
+		if (*s != ',')
+			usage();
+		s++;
+	}
+}
+
+static int addstore(Worker *w, const char *name, double *t, double *y,
+		char *use, size_t rows)
+{
+	RunStore *s;
+	RunStoreInfo info;
+	long pos = 0, n, r;
+	int status;
+
+	if ((status = rs_open(name, &s)) != RS_OK)
+		return status;
+	rs_info(s, &info);
+	if ((size_t) info.blockrows > rows) {
+		rs_free(s);
+		return RS_EARG;
+	}
+	while ((n = rs_next(s, &pos, w->cols, w->ncols, t, y, rows)) > 0) {
+		for (r = 0; r < n; r++)
+			use[r] = t[r] >= w->t0 && t[r] <= w->t1;
+		tc_add(&w->acc, y, rows, (size_t) n, use);
+	}
+	rs_free(s);
+	return n < 0 ? (int) n : RS_OK;
+}
+
+static TE_THREAD_FN(train, arg)
+{
+	Worker *w = (Worker *) arg;
+	size_t rows = 0;
+	double *t = NULL, *y = NULL;
+	char *use = NULL;
+	int i, status = RS_OK;
+
+	for (i = w->index; i < w->nfiles && status == RS_OK; i += w->nthreads) {
+		RunStore *s;
+		RunStoreInfo info;
+
+		/* Buffers for the largest block seen so far */
+		if ((status = rs_open(w->files[i], &s)) != RS_OK)
+			break;
+		rs_info(s, &info);
+		rs_free(s);
+		if ((size_t) info.blockrows > rows) {
+			rows = (size_t) info.blockrows;
+			free(t);
+			free(y);
+			free(use);
+			t = (double *) malloc(rows * sizeof(double));
+			y = (double *) malloc(rows * w->ncols * sizeof(double));
+			use = (char *) malloc(rows);
+			if (!t || !y || !use) {
+				status = RS_ENOMEM;
+				break;
+			}
+		}
+		status = addstore(w, w->files[i], t, y, use, rows);
+	}
+	if (status != RS_OK) {
+		w->status = status;
+		w->failed = i < w->nfiles ? w->files[i] : "";
+	}
+	free(t);
+	free(y);
+	free(use);
+	return TE_THREAD_RETURN;
+}
+
+int main(int argc, char *argv[])
+{
+	Worker w[TETRAIN_MAX_THREADS];
+	te_thread threads[TETRAIN_MAX_THREADS];
+	TPModel *model;
+	int cols[TP_MAX_VARS], ncols = RS_TE_COLUMNS, k = 0, nthreads = 0;
+	int i, first, status;
+	double frac = .9, alpha = .01, t0 = -1e300, t1 = 1e300;
+	const char *name = NULL;
+	char *end;
+
+	for (i = 0; i < RS_TE_COLUMNS; i++)
+		cols[i] = i + 1;
+	for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+		if (argv[i][2] != '\0' || i + 1 == argc)
+			usage();
+		switch (argv[i][1]) {
+		case 'k': k = atoi(argv[++i]); break;
+		case 'f': frac = atof(argv[++i]); break;
+		case 'a': alpha = atof(argv[++i]); break;
+		case 'c': ncols = parsecols(argv[++i], cols); break;
+		case 'w':
+			t0 = strtod(argv[++i], &end);
+			if (*end != ':')
+				usage();
+			t1 = atof(end + 1);
+			break;
+		case 'j': nthreads = atoi(argv[++i]); break;
+		case 'o': name = argv[++i]; break;
+		default:  usage();
+		}
+	}
+	first = i;
+	if (!name || first == argc || k < 0 || k > ncols)
+		usage();
+	if (nthreads <= 0)
+		nthreads = te_ncpu();
+	if (nthreads > argc - first)
+		nthreads = argc - first;
+	if (nthreads > TETRAIN_MAX_THREADS)
+		nthreads = TETRAIN_MAX_THREADS;
+	if (nthreads < 1)
+		nthreads = 1;
+
+	for (i = 0; i < nthreads; i++) {
+		w[i].files = &argv[first];
+		w[i].nfiles = argc - first;
+		w[i].nthreads = nthreads;
+		w[i].index = i;
+		w[i].cols = cols;
+		w[i].ncols = ncols;
+		w[i].t0 = t0;
+		w[i].t1 = t1;
+		w[i].status = RS_OK;
+		w[i].failed = NULL;
+		if (tc_init(&w[i].acc, ncols) != TC_OK) {
+			fprintf(stderr, "tetrain: out of memory\n");
+			return 1;
+		}
+	}
+	for (i = 1; i < nthreads; i++)
+		if (te_thread_create(&threads[i], train, &w[i]) != 0) {
+			fprintf(stderr, "tetrain: cannot start a thread\n");
+			return 1;
+		}
+	train(&w[0]);
+	for (i = 1; i < nthreads; i++)
+		te_thread_join(threads[i]);
+
+	for (i = 0; i < nthreads; i++) {
+		if (w[i].status != RS_OK) {
+			fprintf(stderr, "tetrain: %s: %s\n", w[i].failed, rs_strerror(w[i].status));
+			return 1;
+		}
+		if (i > 0)
+			tc_merge(&w[0].acc, &w[i].acc);
+	}
+	if ((status = tc_pca(&w[0].acc, cols, k, frac, alpha, &model)) != TC_OK) {
+		fprintf(stderr, "tetrain: %s\n", status == TC_ENOMEM ? "out of memory" :
+				"too few samples or invalid options");
+		return 1;
+	}
+	if ((status = tp_save(name, model)) != TP_OK) {
+		fprintf(stderr, "tetrain: %s: %s\n", name, tp_strerror(status));
+		return 1;
+	}
+	fprintf(stderr, "tetrain: %.0f samples, %d of %d components, T2 limit %g, SPE limit %g\n",
+			w[0].acc.n, model->k, model->m, model->t2lim, model->spelim);
+	tp_model_free(model);
+	for (i = 0; i < nthreads; i++)
+		tc_free(&w[i].acc);
+	return 0;
+}
@@ -0,0 +1,67 @@
+/*	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+ *	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+ *	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+ * 	All rights reserved.
+ *	License: http://opensource.org/licenses/BSD-3-Clause
+ *	---------------------------------------------------------------------
+ */	
+
+/* Offline formatting of trace files (tetrace.h).
+ *
+ *   tetrfmt [-l level] file.trace ...
+ *
+ * Prints the records of each file, one line each: time in hours, level,
+ * event and its arguments, keeping the records up to level (default all).
+ *
+ * Build: cc -O2 -o tetrfmt tetrfmt.c tetrace.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tetrace.h"
+
+static void usage(void)
+{
+	fprintf(stderr, "Usage: tetrfmt [-l level] file.trace ...\n");
+	exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+	TTRRecord *r;
+	char line[256];
+	size_t n, j;
+	unsigned long lost;
+	int i, level = TTR_DEBUG, status, ret = 0;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+		if (argv[i][2] != '\0' || i + 1 == argc)
+			usage();
+		switch (argv[i][1]) {
+		case 'l':
+			if ((level = ttr_level(argv[++i])) < 0)
+				usage();
+			break;
+		default:  usage();
+		}
+	}
+	if (i == argc)
+		usage();
+	for (; i < argc; i++) {
+		if ((status = ttr_load(argv[i], &r, &n, &lost)) != TTR_OK) {
+			fprintf(stderr, "tetrfmt: %s: %s\n", argv[i], ttr_strerror(status));
+			ret = 1;
+			continue;
+		}
+		if (lost > 0)
+			printf("# %s: %lu records lost\n", argv[i], lost);
+		for (j = 0; j < n; j++)
+			if (r[j].level <= level) {
+				ttr_format(&r[j], line, sizeof(line));
+				puts(line);
+			}
+		free(r);
+	}
+	return ret;
+}
@@ -0,0 +1,42 @@
+%	Copyright  2015 Alexander Isakov. Contact: <alexander.isakov@tuhh.de>
+%	Copyright  2015 Marina Krotofil. Contact: <marina.krotofil@tuhh.de>
+%	Copyright  2015 TUHH-SVA Security in Distributed Applications.
+%	All rights reserved.
+%	License: http://opensource.org/licenses/BSD-3-Clause
+%	----------------------------------------------------------------------
+function savePCA(file, vars, mu, sigma, lambda, P, T2lim, SPElim)
+% savePCA  Writes a PCA model for the native monitor (ccode/tepca.h).
+%
+%   savePCA(file, vars, mu, sigma, lambda, P, T2lim, SPElim)
+%
+%   vars    monitored columns of [simout(:,1:41) xmv(:,1:12)], 1..53
+%   mu      their means
+%   sigma   their scales (standard deviations)
+%   lambda  variances of the k retained components
+%   P       m x k loadings of the scaled data
+%   T2lim   control limit of Hotelling's T^2
+%   SPElim  control limit of the SPE (Q) statistic
+
+    m = numel(vars);
+    k = numel(lambda);
+    if ~isequal(size(P), [m k]) || numel(mu) ~= m || numel(sigma) ~= m
+        error('savePCA:size', 'Sizes of vars, mu, sigma, lambda and P do not agree.');
+    end
+    fid = fopen(file, 'w');
+    if fid < 0
+        error('savePCA:file', 'Cannot open %s.', file);
+    end
+    fprintf(fid, '# PCA model: m k, variables, mean, scale, lambda, P, T2 and SPE limits\n');
+    fprintf(fid, '%d %d\n', m, k);
+    fprintf(fid, '%d ', vars);
+    fprintf(fid, '\n');
+    fprintf(fid, '%.17g ', mu);
+    fprintf(fid, '\n');
+    fprintf(fid, '%.17g ', sigma);
+    fprintf(fid, '\n');
+    fprintf(fid, '%.17g ', lambda);
+    fprintf(fid, '\n');
+    fprintf(fid, [repmat('%.17g ', 1, k) '\n'], P');
+    fprintf(fid, '%.17g %.17g\n', T2lim, SPElim);
+    fclose(fid);
+end
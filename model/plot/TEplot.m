@@ -4,8 +4,43 @@
 % that simulation time is in vector "tout", 
 % plant outputs are in matrix "simout",
 % plant MVs are in matrix "xmv".
+%
+% If "TEstore" names a run store file (see ccode/runstore.h), the data are
+% read from it instead, limited to the window TEwindow = [t0 t1] (hours) when
+% that variable exists, into TEt, TEsim and TExmv; tout, simout and xmv are
+% left alone. If TEwidth (plot width in pixels) also exists, only the
+% min/max envelope of the matching downsample level is read, as alternating
+% min and max rows. TEstore is cleared once read, so the next TEplot plots
+% the simulation again.
 
-TEdata.xy=[tout(:) simout(:,1:41)];
+if exist('TEstore', 'var')
+    TEdefwin = ~exist('TEwindow', 'var');
+    if TEdefwin
+        TEwindow = [-Inf Inf];
+    end
+    if exist('TEwidth', 'var')
+        [TEt, TEmin, TEmax] = testore('summary', TEstore, 1:53, TEwindow, TEwidth);
+        TEt = reshape([TEt(:) TEt(:)]', [], 1);
+        TEy = zeros(2*size(TEmin,1), 53);
+        TEy(1:2:end,:) = TEmin;
+        TEy(2:2:end,:) = TEmax;
+        clear TEmin TEmax
+    else
+        [TEt, TEy] = testore('read', TEstore, 1:53, TEwindow);
+    end
+    TEsim = TEy(:,1:41);
+    TExmv = TEy(:,42:53);
+    if TEdefwin
+        clear TEwindow
+    end
+    clear TEy TEdefwin TEstore
+else
+    TEt = tout;
+    TEsim = simout;
+    TExmv = xmv;
+end
+
+TEdata.xy=[TEt(:) TEsim(:,1:41)];
 TEdata.iy=cell(1,41);
 for i=1:41; TEdata.iy{i}=i; end
 TEdata.title=cell(1,41);
@@ -64,7 +99,7 @@ for i=29:36, TEdata.title{i}=['Component ',comps(i-28),' in Purge']; end
 for i=37:41, TEdata.title{i}=['Component ',comps(i-33),' in Product']; end
 
 
-TEmvs.xy=[tout(:) xmv(:,1:12)];
+TEmvs.xy=[TEt(:) TExmv(:,1:12)];
 TEmvs.iy=cell(1,12);
 for i=1:12; TEmvs.iy{i}=i; end
 TEmvs.title=cell(1,12);
@@ -111,7 +146,7 @@ if ~exist('FIg1')
    Pos=get(gcf,'Position');
 end
    figure(FIg1);
-   plot(tout,simout(:,7));
+   plot(TEt,TEsim(:,7));
    xlabel('Hours'); ylabel(TEdata.ylabel(7)); 
    title(TEdata.title(7));
    
@@ -124,7 +159,7 @@ if ~exist('FIg')
 	'Name','Signal Selection',...
    'NumberTitle','off');			% Figure window
    CALLback=['Sig=get(gcbo,''Value''); figure(FIg1);'...
-         'plot(tout,simout(:,Sig)); title(TEdata.title(Sig));',...
+         'plot(TEt,TEsim(:,Sig)); title(TEdata.title(Sig));',...
          'xlabel(''Hours''); ylabel(TEdata.ylabel(Sig));',...
          'figure(FIg)'];
 	uicontrol('Parent',FIg,'Units','points', ...
@@ -142,7 +177,7 @@ if ~exist('FIg2')
    Pos=get(gcf,'Position');
 end
    figure(FIg2)
-   plot(tout,xmv(:,10));
+   plot(TEt,TExmv(:,10));
    xlabel('Hours'); ylabel(TEmvs.ylabel(10)); 
    title(TEmvs.title(10));
 
@@ -155,7 +190,7 @@ if ~exist('FIgM')
 	'Name','MV Selection',...
    'NumberTitle','off');			% Figure window
    CALLback=['Sig=get(gcbo,''Value''); figure(FIg2);'...
-         'plot(tout,xmv(:,Sig)); title(TEmvs.title(Sig));',...
+         'plot(TEt,TExmv(:,Sig)); title(TEmvs.title(Sig));',...
          'xlabel(''Hours''); ylabel(TEmvs.ylabel(Sig));',...
          'figure(FIgM)'];
 	uicontrol('Parent',FIgM,'Units','points', ...